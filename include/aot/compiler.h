@@ -14,8 +14,13 @@
 #include "common/ast/module.h"
 #include "common/errcode.h"
 #include "common/version.h"
+#include "support/profile.h"
+#include <algorithm>
 #include <cstdint>
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 namespace SSVM {
 namespace AOT {
@@ -23,6 +28,9 @@ namespace AOT {
 /// Compiling Module into loadable executable binary.
 class Compiler {
 public:
+  /// Optimization levels of the compiled code.
+  enum class OptimizationLevel : uint8_t { O0, O1, O2, O3, Os, Oz };
+
   Expect<void> compile(Span<const Byte> Data, const AST::Module &Module,
                        std::string_view OutputPath);
   Expect<void> compile(const AST::ImportSection &ImportSection);
@@ -35,15 +43,113 @@ public:
                        const AST::ElementSection &ElementSection);
   Expect<void> compile(const AST::FunctionSection &FunctionSection,
                        const AST::CodeSection &CodeSection);
+  Expect<void> compile(const AST::StartSection &StartSection);
 
   struct CompileContext;
 
   /// Setter of module name.
   void setDumpIR(bool Value = true) { DumpIR = Value; }
 
+  /// Setter of the number of parallel jobs for optimization and codegen.
+  ///
+  /// Functions are split into at most this many partitions, each optimized
+  /// and compiled on its own thread, and linked together into the output.
+  void setJobs(uint32_t Value) { Jobs = std::max(Value, UINT32_C(1)); }
+
+  /// Setter of the optimization level. Default is O3.
+  void setOptimizationLevel(OptimizationLevel Value) { OptLevel = Value; }
+
+  /// Setter of the target CPU name. Empty means the host CPU and its
+  /// features.
+  void setTargetCPU(std::string_view Value) { TargetCPU = Value; }
+
+  /// Setter of the additional target features, such as "+avx2,-bmi2".
+  void setTargetFeatures(std::string_view Value) { TargetFeatures = Value; }
+
+  /// Add a code variant for the target CPU and features.
+  ///
+  /// If any variant is added, the output contains code for all of them
+  /// instead of the single target, and the loader selects the supported
+  /// variant enabling the most features. Only the x86 features checked by
+  /// the loader are recorded, and variants with others are refused.
+  void addTargetVariant(std::string_view CPU, std::string_view Features) {
+    Variants.emplace_back(CPU, Features);
+  }
+
+  /// Setter of the cache directory of compiled functions.
+  ///
+  /// If set, functions are optimized and compiled one by one, and the object
+  /// code is reused from the cache when the function and the settings are not
+  /// changed.
+  void setCacheDir(std::string_view Value) { CacheDir = Value; }
+
+  /// Setter of the cost table for gas metering.
+  ///
+  /// If set, the compiled code accumulates instruction costs and traps with
+  /// `CostLimitExceeded` at loop headers, calls and returns when the cost
+  /// limit in the execution context is exceeded.
+  void setCostTable(Span<const uint64_t> Table) {
+    CostTable.assign(Table.begin(), Table.end());
+  }
+
+  /// Setter of emitting interruption checks.
+  ///
+  /// If set, the compiled code traps with `Interrupted` at loop headers when
+  /// the epoch counter in the execution context reaches the deadline.
+  void setInterruptible(bool Value = true) { Interruptible = Value; }
+
+  /// Setter of the execution profile of the module, which must outlive the
+  /// compilation.
+  ///
+  /// If set, the function entry counts and the branch weights of `if` and
+  /// `br_if` are taken from the profile, and the dominant target of a
+  /// `call_indirect` is called directly behind a function pointer check.
+  void setProfile(const Support::Profile *Value) { Profile = Value; }
+
+  /// Setter of the module name of static archive output.
+  ///
+  /// If set, the output is a static archive instead of a shared library, for
+  /// linking into the host binary. All symbols are prefixed by the name, and
+  /// the registration table `ssvm_module_<name>` lists the symbols used by
+  /// the loader. See "include/common/staticmodule.h". The name should only
+  /// contain letters, digits and underscores.
+  void setStaticName(std::string_view Value) { StaticName = Value; }
+
+  /// Setter of printing the time of compilation phases and optimization
+  /// passes to stderr.
+  void setTimeReport(bool Value = true) { TimeReport = Value; }
+
+  /// Setter of printing the IR instruction counts before and after
+  /// optimization and the code size of each function to stderr.
+  void setStats(bool Value = true) { Stats = Value; }
+
+  /// Setter of the bounds check strategy of memory accesses. Default is
+  /// guard pages. See "include/common/boundscheck.h".
+  void setBoundsCheck(BoundsCheck Value) { Bounds = Value; }
+
 private:
+  /// Emit the table of wrappers of the functions called from the runtime.
+  Expect<void> compileWrapperTable();
+
+  /// Emit the page aligned read-only images of the active data segments with
+  /// constant offsets, named `wasm.data.<index>`.
+  Expect<void> compileDataImages(const AST::DataSection &DataSection);
+
   CompileContext *Context = nullptr;
   bool DumpIR = false;
+  uint32_t Jobs = 1;
+  OptimizationLevel OptLevel = OptimizationLevel::O3;
+  std::string TargetCPU;
+  std::string TargetFeatures;
+  std::vector<std::pair<std::string, std::string>> Variants;
+  std::string CacheDir;
+  bool Interruptible = false;
+  std::vector<uint64_t> CostTable;
+  const Support::Profile *Profile = nullptr;
+  std::string StaticName;
+  bool TimeReport = false;
+  bool Stats = false;
+  BoundsCheck Bounds = BoundsCheck::GuardPage;
 };
 
 } // namespace AOT
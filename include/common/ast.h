@@ -33,6 +33,8 @@ enum class ASTNodeAttr : uint8_t {
   Sec_Element,
   Sec_Code,
   Sec_Data,
+  Sec_DataCount,
+  Sec_Name,
   Desc_Import,
   Desc_Export,
   Seg_Global,
@@ -63,6 +65,8 @@ static inline std::unordered_map<ASTNodeAttr, std::string> ASTNodeAttrStr = {
     {ASTNodeAttr::Sec_Element, "element section"},
     {ASTNodeAttr::Sec_Code, "code section"},
     {ASTNodeAttr::Sec_Data, "data section"},
+    {ASTNodeAttr::Sec_DataCount, "data count section"},
+    {ASTNodeAttr::Sec_Name, "name section"},
     {ASTNodeAttr::Desc_Import, "import description"},
     {ASTNodeAttr::Desc_Export, "export description"},
     {ASTNodeAttr::Seg_Global, "global segment"},
@@ -274,7 +278,13 @@ enum class OpCode : uint16_t {
   I64__trunc_sat_f32_s = 0xFC04,
   I64__trunc_sat_f32_u = 0xFC05,
   I64__trunc_sat_f64_s = 0xFC06,
-  I64__trunc_sat_f64_u = 0xFC07
+  I64__trunc_sat_f64_u = 0xFC07,
+
+  /// Bulk memory instructions
+  Memory__init = 0xFC08,
+  Data__drop = 0xFC09,
+  Memory__copy = 0xFC0A,
+  Memory__fill = 0xFC0B
 };
 
 /// Instruction opcode enumeration string mapping.
@@ -472,6 +482,12 @@ static inline std::unordered_map<OpCode, std::string> OpCodeStr = {
     {OpCode::I64__trunc_sat_f32_s, "i64.trunc_sat_f32_s"},
     {OpCode::I64__trunc_sat_f32_u, "i64.trunc_sat_f32_u"},
     {OpCode::I64__trunc_sat_f64_s, "i64.trunc_sat_f64_s"},
-    {OpCode::I64__trunc_sat_f64_u, "i64.trunc_sat_f64_u"}};
+    {OpCode::I64__trunc_sat_f64_u, "i64.trunc_sat_f64_u"},
+
+    /// Bulk memory instructions
+    {OpCode::Memory__init, "memory.init"},
+    {OpCode::Data__drop, "data.drop"},
+    {OpCode::Memory__copy, "memory.copy"},
+    {OpCode::Memory__fill, "memory.fill"}};
 
 } // namespace SSVM
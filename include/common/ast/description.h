@@ -96,11 +96,6 @@ public:
   /// Getter of external index.
   uint32_t getExternalIndex() const { return ExtIdx; }
 
-  /// Getter of compiled symbol.
-  void *getSymbol() const { return Symbol; }
-  /// Setter of compiled symbol.
-  void setSymbol(void *S) { Symbol = S; }
-
   /// The node type should be ASTNodeAttr::Desc_Export.
   const ASTNodeAttr NodeAttr = ASTNodeAttr::Desc_Export;
 
@@ -109,7 +104,6 @@ private:
   /// @{
   std::string ExtName;
   uint32_t ExtIdx;
-  void *Symbol = nullptr;
   /// @}
 };
 
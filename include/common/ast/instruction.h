@@ -88,6 +88,23 @@ public:
 
   /// Getter of Block Body
   const InstrVec &getBody() const { return Body; }
+  InstrVec &getBody() { return Body; }
+
+  /// Getter of block parameter number resolved in validation.
+  uint32_t getBlockParamNum() const { return BlockParamNum; }
+
+  /// Getter of block result number resolved in validation.
+  uint32_t getBlockResultNum() const { return BlockResultNum; }
+
+  /// Getter of checking block arity is resolved.
+  bool isArityResolved() const { return IsArityResolved; }
+
+  /// Setter of block arity. Filled by validator.
+  void setBlockArity(const uint32_t ParamNum, const uint32_t ResultNum) {
+    BlockParamNum = ParamNum;
+    BlockResultNum = ResultNum;
+    IsArityResolved = true;
+  }
 
 private:
   /// \name Data of block instruction: return type and block body.
@@ -95,6 +112,13 @@ private:
   BlockType ResType;
   InstrVec Body;
   /// @}
+
+  /// \name Side table of block arity filled by validator.
+  /// @{
+  uint32_t BlockParamNum = 0;
+  uint32_t BlockResultNum = 0;
+  bool IsArityResolved = false;
+  /// @}
 }; // namespace AST
 
 /// Derived if-else control instruction node.
@@ -121,9 +145,27 @@ public:
 
   /// Getter of if statement.
   const InstrVec &getIfStatement() const { return IfStatement; }
+  InstrVec &getIfStatement() { return IfStatement; }
 
   /// Getter of else statement.
   const InstrVec &getElseStatement() const { return ElseStatement; }
+  InstrVec &getElseStatement() { return ElseStatement; }
+
+  /// Getter of block parameter number resolved in validation.
+  uint32_t getBlockParamNum() const { return BlockParamNum; }
+
+  /// Getter of block result number resolved in validation.
+  uint32_t getBlockResultNum() const { return BlockResultNum; }
+
+  /// Getter of checking block arity is resolved.
+  bool isArityResolved() const { return IsArityResolved; }
+
+  /// Setter of block arity. Filled by validator.
+  void setBlockArity(const uint32_t ParamNum, const uint32_t ResultNum) {
+    BlockParamNum = ParamNum;
+    BlockResultNum = ResultNum;
+    IsArityResolved = true;
+  }
 
 private:
   /// \name Data of block instruction: return type and statements.
@@ -132,6 +174,13 @@ private:
   InstrVec IfStatement;
   InstrVec ElseStatement;
   /// @}
+
+  /// \name Side table of block arity filled by validator.
+  /// @{
+  uint32_t BlockParamNum = 0;
+  uint32_t BlockResultNum = 0;
+  bool IsArityResolved = false;
+  /// @}
 };
 
 /// Derived branch control instruction node.
@@ -270,12 +319,13 @@ public:
   /// Copy constructor.
   MemoryInstruction(const MemoryInstruction &Instr)
       : Instruction(Instr.Code, Instr.Offset), Align(Instr.Align),
-        Offset(Instr.Offset) {}
+        Offset(Instr.Offset), DataIdx(Instr.DataIdx) {}
 
   /// Load binary from file manager.
   ///
   /// Inheritted and overrided from Instruction.
-  /// Read the memory arguments: alignment and offset.
+  /// Read the memory arguments: alignment and offset, or the data segment
+  /// index of bulk memory instructions.
   ///
   /// \param Mgr the file manager reference.
   ///
@@ -286,11 +336,15 @@ public:
   uint32_t getMemoryAlign() const { return Align; }
   uint32_t getMemoryOffset() const { return Offset; }
 
+  /// Getter of the data segment index of memory.init and data.drop.
+  uint32_t getDataIndex() const { return DataIdx; }
+
 private:
-  /// \name Data of memory instruction: Alignment and offset.
+  /// \name Data of memory instruction: Alignment, offset, and data index.
   /// @{
   uint32_t Align = 0;
   uint32_t Offset = 0;
+  uint32_t DataIdx = 0;
   /// @}
 };
 
@@ -406,6 +460,10 @@ template <typename T> auto dispatchInstruction(OpCode Code, T &&Visitor) {
   case OpCode::I64__store32:
   case OpCode::Memory__size:
   case OpCode::Memory__grow:
+  case OpCode::Memory__init:
+  case OpCode::Data__drop:
+  case OpCode::Memory__copy:
+  case OpCode::Memory__fill:
     return Visitor(Support::tag<MemoryInstruction>());
 
   case OpCode::I32__const:
@@ -13,10 +13,13 @@
 #pragma once
 
 #include "base.h"
+#include "common/boundscheck.h"
 #include "loader/ldmgr.h"
 #include "section.h"
+#include "support/sha256.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -31,6 +34,8 @@ namespace AST {
 /// AST Module node.
 class Module : public Base {
 public:
+  ~Module() override;
+
   /// Load binary from file manager.
   ///
   /// Inheritted and overrided from Base.
@@ -45,8 +50,39 @@ public:
   /// Load compiled function from loadable manager.
   Expect<void> loadCompiled(LDMgr &Mgr);
 
+  /// Setter of skipping the function bodies in loading, for the modules
+  /// loaded from compiled binaries. The bodies are validated when compiling.
+  void setSkipFunctionBody(bool Skip) { IsSkipFunctionBody = Skip; }
+  bool isSkipFunctionBody() const { return IsSkipFunctionBody; }
+
+  /// Getter of the name section decoded in loading.
+  ///
+  /// \returns pointer to NameSection node, or nullptr if this module has no
+  /// name section or it is malformed.
+  const NameSection *getNameSection() const {
+    if (const auto *Sec = findCustomSection("name")) {
+      return Sec->getNameSection();
+    }
+    return nullptr;
+  }
+
+  /// Getter of custom section by name.
+  ///
+  /// \returns pointer to the first custom section named Name, nullptr if not
+  /// found.
+  const CustomSection *findCustomSection(std::string_view Name) const {
+    for (const auto &Sec : CustomSecs) {
+      if (Sec->getName() == Name) {
+        return Sec.get();
+      }
+    }
+    return nullptr;
+  }
+
   /// Getter of pointer to sections.
-  CustomSection *getCustomSection() const { return CustomSec.get(); }
+  Span<const std::unique_ptr<CustomSection>> getCustomSections() const {
+    return CustomSecs;
+  }
   TypeSection *getTypeSection() const { return TypeSec.get(); }
   ImportSection *getImportSection() const { return ImportSec.get(); }
   FunctionSection *getFunctionSection() const { return FunctionSec.get(); }
@@ -58,32 +94,21 @@ public:
   ElementSection *getElementSection() const { return ElementSec.get(); }
   CodeSection *getCodeSection() const { return CodeSec.get(); }
   DataSection *getDataSection() const { return DataSec.get(); }
+  DataCountSection *getDataCountSection() const { return DataCountSec.get(); }
 
-  using TrapCodeProxy = uint32_t *;
-  using CallProxy = void (*)(const uint32_t FuncIdx, const ValVariant *Args,
-                             ValVariant *Rets);
-  using MemGrowProxy = uint32_t (*)(const uint32_t Diff);
-
-  void setTrapCodeProxySymbol(TrapCodeProxy *Symbol) {
-    TrapCodeProxySymbol = Symbol;
-  }
-  void setCallProxySymbol(CallProxy *Symbol) { CallProxySymbol = Symbol; }
-  void setMemGrowProxySymbol(MemGrowProxy *Symbol) {
-    MemGrowProxySymbol = Symbol;
-  }
-  void setTrapCodeProxy(TrapCodeProxy Pointer) const {
-    if (TrapCodeProxySymbol)
-      *TrapCodeProxySymbol = Pointer;
+  /// Getter and setter of the SHA-256 digest of the module binary.
+  const std::optional<Support::SHA256::Digest> &getContentHash() const {
+    return ContentHash;
   }
-  void setCallProxy(CallProxy Pointer) const {
-    if (CallProxySymbol)
-      *CallProxySymbol = Pointer;
-  }
-  void setMemGrowProxy(MemGrowProxy Pointer) const {
-    if (MemGrowProxySymbol)
-      *MemGrowProxySymbol = Pointer;
+  void setContentHash(const Support::SHA256::Digest &Hash) {
+    ContentHash = Hash;
   }
 
+  /// Getter of the bounds check strategy of the code. Interpreted code
+  /// checks every access explicitly, and compiled code uses the strategy
+  /// recorded in the binary.
+  BoundsCheck getBoundsCheck() const { return Bounds; }
+
   /// The node type should be ASTNodeAttr::Module.
   const ASTNodeAttr NodeAttr = ASTNodeAttr::Module;
 
@@ -133,7 +158,7 @@ private:
 
   /// \name Section nodes of Module node.
   /// @{
-  std::unique_ptr<CustomSection> CustomSec;
+  std::vector<std::unique_ptr<CustomSection>> CustomSecs;
   std::unique_ptr<TypeSection> TypeSec;
   std::unique_ptr<ImportSection> ImportSec;
   std::unique_ptr<FunctionSection> FunctionSec;
@@ -145,11 +170,18 @@ private:
   std::unique_ptr<ElementSection> ElementSec;
   std::unique_ptr<CodeSection> CodeSec;
   std::unique_ptr<DataSection> DataSec;
+  std::unique_ptr<DataCountSection> DataCountSec;
   /// @}
 
-  TrapCodeProxy *TrapCodeProxySymbol = nullptr;
-  CallProxy *CallProxySymbol = nullptr;
-  MemGrowProxy *MemGrowProxySymbol = nullptr;
+  /// Digest of the module binary. Set by loader when hashing is enabled.
+  std::optional<Support::SHA256::Digest> ContentHash;
+
+  bool IsSkipFunctionBody = false;
+  BoundsCheck Bounds = BoundsCheck::Explicit;
+
+  /// Duplicated file descriptor of the compiled binary for the data images,
+  /// owned by the module, or -1 if none.
+  int ImageFD = -1;
 };
 
 } // namespace AST
@@ -18,7 +18,10 @@
 #include "support/log.h"
 #include "type.h"
 
+#include <map>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace SSVM {
@@ -90,9 +93,87 @@ protected:
   uint32_t ContentSize = 0;
 };
 
+/// AST NameSection node.
+///
+/// Decoder of the content of custom section named "name". Only the module name
+/// and function names subsections are kept, the others are skipped.
+class NameSection : public Base {
+public:
+  /// Load binary from file manager.
+  ///
+  /// Inheritted and overrided from Base.
+  /// Read the subsections until the end of content.
+  ///
+  /// \param Mgr the file manager reference.
+  ///
+  /// \returns void when success, ErrCode when failed.
+  Expect<void> loadBinary(FileMgr &Mgr) override;
+
+  /// Getter of module name.
+  std::string_view getModuleName() const { return ModuleName; }
+
+  /// Getter of function name by function index.
+  ///
+  /// \returns the function name, or empty string if not found.
+  std::string_view getFunctionName(uint32_t FuncIdx) const {
+    if (auto It = FunctionNames.find(FuncIdx); It != FunctionNames.end()) {
+      return It->second;
+    }
+    return {};
+  }
+
+  /// Getter of function names map.
+  const std::map<uint32_t, std::string> &getFunctionNames() const {
+    return FunctionNames;
+  }
+
+  /// The node type should be ASTNodeAttr::Sec_Name.
+  const ASTNodeAttr NodeAttr = ASTNodeAttr::Sec_Name;
+
+private:
+  /// \name Data of NameSection node.
+  /// @{
+  std::string ModuleName;
+  std::map<uint32_t, std::string> FunctionNames;
+  /// @}
+};
+
 /// AST CustomSection node.
+///
+/// The content of custom section is not read when loading. Only the name and
+/// the position of content in the module binary are recorded. The content can
+/// be fetched on demand by getContent() with the original module binary.
+/// The content of the name section is decoded when loading, since the binary
+/// may not be available afterwards.
 class CustomSection : public Section {
 public:
+  /// Getter of custom section name.
+  std::string_view getName() const { return Name; }
+
+  /// Getter of content offset in the module binary.
+  uint32_t getContentOffset() const { return ContentOffset; }
+
+  /// Getter of content length.
+  uint32_t getContentLength() const { return ContentLength; }
+
+  /// Get content bytes from the module binary.
+  ///
+  /// \param Code the binary which this custom section loaded from.
+  ///
+  /// \returns span of content when success, ErrCode when out of range.
+  Expect<Span<const Byte>> getContent(Span<const Byte> Code) const {
+    if (static_cast<uint64_t>(ContentOffset) + ContentLength > Code.size()) {
+      return Unexpect(ErrCode::EndOfFile);
+    }
+    return Code.subspan(ContentOffset, ContentLength);
+  }
+
+  /// Getter of the name section decoded from the content.
+  ///
+  /// \returns pointer to the decoded name section, or nullptr if this is not
+  /// the name section or the content is malformed.
+  const NameSection *getNameSection() const { return Names.get(); }
+
   /// The node type should be ASTNodeAttr::Sec_Custom.
   const ASTNodeAttr NodeAttr = ASTNodeAttr::Sec_Custom;
 
@@ -101,8 +182,13 @@ protected:
   Expect<void> loadContent(FileMgr &Mgr) override;
 
 private:
-  /// Vector of raw bytes of content.
-  std::vector<Byte> Content;
+  /// \name Data of CustomSection node.
+  /// @{
+  std::string Name;
+  uint32_t ContentOffset = 0;
+  uint32_t ContentLength = 0;
+  std::unique_ptr<NameSection> Names;
+  /// @}
 };
 
 /// AST TypeSection node.
@@ -253,6 +339,24 @@ private:
   uint32_t Content;
 };
 
+/// AST DataCountSection node.
+class DataCountSection : public Section {
+public:
+  /// Getter of content.
+  uint32_t getContent() const { return Content; }
+
+  /// The node type should be ASTNodeAttr::Sec_DataCount.
+  const ASTNodeAttr NodeAttr = ASTNodeAttr::Sec_DataCount;
+
+protected:
+  /// Overrided content loading of data count section.
+  virtual Expect<void> loadContent(FileMgr &Mgr);
+
+private:
+  /// Count of data segments.
+  uint32_t Content;
+};
+
 /// AST ElementSection node.
 class ElementSection : public Section {
 public:
@@ -281,6 +385,10 @@ public:
     return Content;
   }
 
+  /// Setter of skipping the function bodies in loading. See
+  /// CodeSegment::skipBinary().
+  void setSkipBody(bool Skip) { IsSkipBody = Skip; }
+
   /// The node type should be ASTNodeAttr::Sec_Code.
   const ASTNodeAttr NodeAttr = ASTNodeAttr::Sec_Code;
 
@@ -291,6 +399,7 @@ protected:
 private:
   /// Vector of CodeSegment nodes.
   std::vector<std::unique_ptr<CodeSegment>> Content;
+  bool IsSkipBody = false;
 };
 
 /// AST DataSection node.
@@ -119,9 +119,35 @@ public:
   /// \returns void when success, ErrCode when failed.
   Expect<void> loadBinary(FileMgr &Mgr) override;
 
+  /// Load binary from file manager without decoding the function body.
+  ///
+  /// Read the segment size and skip the locals and the function body, for
+  /// the functions already compiled. The instruction vector will be empty.
+  ///
+  /// \param Mgr the file manager reference.
+  ///
+  /// \returns void when success, ErrCode when failed.
+  Expect<void> skipBinary(FileMgr &Mgr);
+
+  /// Getter of whether the locals and function body are skipped in loading.
+  bool isBodySkipped() const { return IsBodySkipped; }
+
+  /// Getter and setter of the symbol of compiled function wrapper.
+  void *getSymbol() const { return Symbol; }
+  void setSymbol(void *S) { Symbol = S; }
+
   /// Getter of locals vector.
   Span<const std::pair<uint32_t, ValType>> getLocals() const { return Locals; }
 
+  /// Getter of total local number, which not includes parameters.
+  uint32_t getLocalNum() const { return LocalNum; }
+
+  /// Getter of maximum operand stack height resolved in validation.
+  uint32_t getMaxStackHeight() const { return MaxStackHeight; }
+
+  /// Setter of maximum operand stack height. Filled by validator.
+  void setMaxStackHeight(const uint32_t Height) { MaxStackHeight = Height; }
+
   /// The node type should be ASTNodeAttr::Seg_Code.
   const ASTNodeAttr NodeAttr = ASTNodeAttr::Seg_Code;
 
@@ -130,6 +156,17 @@ private:
   /// @{
   uint32_t SegSize = 0;
   std::vector<std::pair<uint32_t, ValType>> Locals;
+  bool IsBodySkipped = false;
+  /// @}
+
+  /// Symbol of the compiled wrapper, which has the same signature as the
+  /// exported functions. Set for every function of a compiled module.
+  void *Symbol = nullptr;
+
+  /// \name Side table filled in loading and validation.
+  /// @{
+  uint32_t LocalNum = 0;
+  uint32_t MaxStackHeight = 0;
   /// @}
 };
 
@@ -140,6 +177,7 @@ public:
   ///
   /// Inheritted and overrided from Base.
   /// Read the memory index, offset expression, and initialization data.
+  /// Passive segments have no memory index or offset expression.
   ///
   /// \param Mgr the file manager reference.
   ///
@@ -149,9 +187,25 @@ public:
   /// Getter of memory index.
   uint32_t getIdx() const { return MemoryIdx; }
 
+  /// Check the segment is passive, which is only copied by memory.init.
+  bool isPassive() const { return IsPassive; }
+
   /// Getter of data.
   Span<const Byte> getData() const { return Data; }
 
+  /// Getter of the file descriptor of the read-only image of data in a
+  /// compiled binary, or -1 if not compiled.
+  int getImageFD() const { return ImageFD; }
+
+  /// Getter of the file offset of the first byte of data in the image.
+  uint64_t getImageOffset() const { return ImageOffset; }
+
+  /// Setter of the data image. The file descriptor is owned by the module.
+  void setImage(int FD, uint64_t Offset) {
+    ImageFD = FD;
+    ImageOffset = Offset;
+  }
+
   /// The node type should be ASTNodeAttr::Seg_Data.
   const ASTNodeAttr NodeAttr = ASTNodeAttr::Seg_Data;
 
@@ -159,8 +213,14 @@ private:
   /// \name Data of DataSegment node.
   /// @{
   uint32_t MemoryIdx = 0;
+  bool IsPassive = false;
   std::vector<Byte> Data;
   /// @}
+
+  /// Image of data in the compiled binary, which can be mapped into memory
+  /// instances instead of copied.
+  int ImageFD = -1;
+  uint64_t ImageOffset = 0;
 };
 
 } // namespace AST
@@ -115,18 +115,12 @@ public:
   /// Getter of limit.
   const Limit *getLimit() const { return Memory.get(); }
 
-  /// Getter of compiled symbol.
-  void *getSymbol() const { return Symbol; }
-  /// Setter of compiled symbol.
-  void setSymbol(void *S) { Symbol = S; }
-
   /// The node type should be ASTNodeAttr::Type_Memory.
   const ASTNodeAttr NodeAttr = ASTNodeAttr::Type_Memory;
 
 private:
   /// Data of MemoryType node.
   std::unique_ptr<Limit> Memory;
-  void *Symbol = nullptr;
 };
 
 /// AST TableType node.
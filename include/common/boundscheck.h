@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/common/boundscheck.h - Bounds check strategy definition ------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the strategies of linear memory bounds checking shared
+/// between the AOT compiler and the runtime.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+
+namespace SSVM {
+
+/// Strategy of checking the bounds of linear memory accesses.
+enum class BoundsCheck : uint8_t {
+  /// No checks in compiled code. Memories reserve 8 GiB of address space, so
+  /// that every access out of bounds hits an inaccessible page and traps by
+  /// signal.
+  GuardPage = 0,
+  /// Compare every access with the current memory size and trap. Memories
+  /// only reserve the address space of their maximum size.
+  Explicit,
+  /// Mask the addresses by the memory size. Only applies to memories with
+  /// equal power of two minimum and maximum sizes, and falls back to explicit
+  /// checks otherwise. Accesses out of bounds wrap around instead of trapping,
+  /// so it is only for trusted modules.
+  Mask,
+};
+
+} // namespace SSVM
@@ -0,0 +1,121 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/common/cpufeature.h - Checked CPU features definition --------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the x86 CPU features recorded by the AOT compiler and
+/// checked by the loader against the host CPU.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace SSVM {
+
+/// CPU feature with the CPUID bit reporting it.
+struct CPUFeature {
+  /// Feature name in the spelling of LLVM.
+  std::string_view Name;
+  /// CPUID leaf and subleaf.
+  uint32_t Leaf;
+  uint32_t SubLeaf;
+  /// Index of the result register: 0 for EAX, 1 for EBX, 2 for ECX, and 3
+  /// for EDX.
+  uint8_t Reg;
+  uint8_t Bit;
+  /// Register states in XCR0 which the OS must enable for the feature.
+  uint8_t XCR0;
+};
+
+/// Register states of XCR0 for the AVX and AVX-512 features.
+inline constexpr uint8_t kXCR0AVX = 0x06;
+inline constexpr uint8_t kXCR0AVX512 = 0xE6;
+
+/// Features checked by the loader. They cover the x86-64 baseline, the
+/// x86-64-v2, v3, and v4 levels, and the other extensions the CPUs imply.
+/// Compiled code recording any other feature is refused at load time.
+inline constexpr std::array<CPUFeature, 60> kCPUFeatures = {{
+    /// x86-64 baseline.
+    {"x87", 1, 0, 3, 0, 0},
+    {"cx8", 1, 0, 3, 8, 0},
+    {"cmov", 1, 0, 3, 15, 0},
+    {"mmx", 1, 0, 3, 23, 0},
+    {"fxsr", 1, 0, 3, 24, 0},
+    {"sse", 1, 0, 3, 25, 0},
+    {"sse2", 1, 0, 3, 26, 0},
+    {"64bit", 0x80000001, 0, 3, 29, 0},
+    /// x86-64-v2.
+    {"sse3", 1, 0, 2, 0, 0},
+    {"ssse3", 1, 0, 2, 9, 0},
+    {"cx16", 1, 0, 2, 13, 0},
+    {"sse4.1", 1, 0, 2, 19, 0},
+    {"sse4.2", 1, 0, 2, 20, 0},
+    {"popcnt", 1, 0, 2, 23, 0},
+    {"sahf", 0x80000001, 0, 2, 0, 0},
+    /// x86-64-v3.
+    {"fma", 1, 0, 2, 12, kXCR0AVX},
+    {"movbe", 1, 0, 2, 22, 0},
+    {"xsave", 1, 0, 2, 26, 0},
+    {"avx", 1, 0, 2, 28, kXCR0AVX},
+    {"f16c", 1, 0, 2, 29, kXCR0AVX},
+    {"bmi", 7, 0, 1, 3, 0},
+    {"avx2", 7, 0, 1, 5, kXCR0AVX},
+    {"bmi2", 7, 0, 1, 8, 0},
+    {"lzcnt", 0x80000001, 0, 2, 5, 0},
+    /// x86-64-v4.
+    {"avx512f", 7, 0, 1, 16, kXCR0AVX512},
+    {"avx512dq", 7, 0, 1, 17, kXCR0AVX512},
+    {"avx512cd", 7, 0, 1, 28, kXCR0AVX512},
+    {"avx512bw", 7, 0, 1, 30, kXCR0AVX512},
+    {"avx512vl", 7, 0, 1, 31, kXCR0AVX512},
+    /// Other extensions.
+    {"pclmul", 1, 0, 2, 1, 0},
+    {"aes", 1, 0, 2, 25, 0},
+    {"rdrnd", 1, 0, 2, 30, 0},
+    {"fsgsbase", 7, 0, 1, 0, 0},
+    {"invpcid", 7, 0, 1, 10, 0},
+    {"rtm", 7, 0, 1, 11, 0},
+    {"rdseed", 7, 0, 1, 18, 0},
+    {"adx", 7, 0, 1, 19, 0},
+    {"avx512ifma", 7, 0, 1, 21, kXCR0AVX512},
+    {"clflushopt", 7, 0, 1, 23, 0},
+    {"clwb", 7, 0, 1, 24, 0},
+    {"sha", 7, 0, 1, 29, 0},
+    {"avx512vbmi", 7, 0, 2, 1, kXCR0AVX512},
+    {"pku", 7, 0, 2, 3, 0},
+    {"avx512vbmi2", 7, 0, 2, 6, kXCR0AVX512},
+    {"gfni", 7, 0, 2, 8, 0},
+    {"vaes", 7, 0, 2, 9, kXCR0AVX},
+    {"vpclmulqdq", 7, 0, 2, 10, kXCR0AVX},
+    {"avx512vnni", 7, 0, 2, 11, kXCR0AVX512},
+    {"avx512bitalg", 7, 0, 2, 12, kXCR0AVX512},
+    {"avx512vpopcntdq", 7, 0, 2, 14, kXCR0AVX512},
+    {"rdpid", 7, 0, 2, 22, 0},
+    {"avxvnni", 7, 1, 0, 4, kXCR0AVX},
+    {"avx512bf16", 7, 1, 0, 5, kXCR0AVX512},
+    {"xsaveopt", 0xD, 1, 0, 0, 0},
+    {"xsavec", 0xD, 1, 0, 1, 0},
+    {"xsaves", 0xD, 1, 0, 3, 0},
+    {"sse4a", 0x80000001, 0, 2, 6, 0},
+    {"prfchw", 0x80000001, 0, 2, 8, 0},
+    {"xop", 0x80000001, 0, 2, 11, kXCR0AVX},
+    {"fma4", 0x80000001, 0, 2, 16, kXCR0AVX},
+}};
+
+/// Check the feature is in the checked list.
+inline bool isCheckedCPUFeature(std::string_view Name) {
+  for (const auto &Feature : kCPUFeatures) {
+    if (Feature.Name == Name) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace SSVM
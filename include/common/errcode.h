@@ -45,12 +45,16 @@ enum class ErrCode : uint8_t {
   CostLimitExceeded = 0x02, /// Exceeded cost limit (out of gas).
   WrongVMWorkflow = 0x03,   /// Wrong VM's workflow
   FuncNotFound = 0x04,      /// Wasm function not found
+  Interrupted = 0x05,       /// Execution interrupted by epoch deadline
+  CompileFailed = 0x06,     /// AOT compilation failed
   /// Load phase
-  InvalidPath = 0x20,    /// File not found
-  ReadError = 0x21,      /// Error when reading
-  EndOfFile = 0x22,      /// Reach end of file when reading
-  InvalidGrammar = 0x23, /// Parsing error
-  InvalidVersion = 0x24, /// Unsupported version
+  InvalidPath = 0x20,     /// File not found
+  ReadError = 0x21,       /// Error when reading
+  EndOfFile = 0x22,       /// Reach end of file when reading
+  InvalidGrammar = 0x23,  /// Parsing error
+  InvalidVersion = 0x24,  /// Unsupported version
+  InvalidTarget = 0x25,   /// Unsupported CPU features of compiled binary
+  InvalidMetering = 0x26, /// Compiled binary without gas metering
   /// Validation phase
   InvalidOpCode = 0x40,      /// Invalid instruction type
   InvalidAlignment = 0x41,   /// Alignment > natural
@@ -70,12 +74,15 @@ enum class ErrCode : uint8_t {
   InvalidLimit = 0x4F,       /// Invalid Limit grammar
   InvalidMemPages = 0x50,    /// Memory pages > 65536
   InvalidStartFunc = 0x51,   /// Invalid start function signature
+  InvalidDataIdx = 0x52,     /// Data segment index not defined
   /// Instantiation phase
   ModuleNameConflict = 0x60,     /// Module name conflicted when importing.
   IncompatibleImportType = 0x61, /// Import matching failed
   UnknownImport = 0x62,          /// Unknown import instances
   DataSegDoesNotFit = 0x63,      /// Init failed when instantiating data segment
   ElemSegDoesNotFit = 0x64, /// Init failed when instantiating element segment
+  MemoryReserveFailed = 0x65, /// Address space of memory instance not reserved
+  MissingCompiledFunc = 0x66, /// Compiled function of skipped body not found
   /// Execution phase
   WrongInstanceAddress = 0x80, /// Wrong access of instances addresses
   WrongInstanceIndex = 0x81,   /// Wrong access of instances indices
@@ -89,7 +96,8 @@ enum class ErrCode : uint8_t {
   UninitializedElement = 0x89, /// Uninitialized element in table instance
   UndefinedElement = 0x8A,     /// Access undefined element in table instances
   IndirectCallTypeMismatch = 0x8B, /// Func type mismatch in call_indirect
-  ExecutionFailed = 0x8C           /// Host function execution failed
+  ExecutionFailed = 0x8C,          /// Host function execution failed
+  CallStackExhausted = 0x8D        /// Stack limit exceeded when calling
 };
 
 /// Error code enumeration string mapping.
@@ -100,12 +108,16 @@ static inline std::unordered_map<ErrCode, std::string> ErrCodeStr = {
     {ErrCode::CostLimitExceeded, "cost limit exceeded"},
     {ErrCode::WrongVMWorkflow, "wrong VM workflow"},
     {ErrCode::FuncNotFound, "wasm function not found"},
+    {ErrCode::Interrupted, "execution interrupted"},
+    {ErrCode::CompileFailed, "compilation failed"},
     /// Load phase
     {ErrCode::InvalidPath, "invalid path"},
     {ErrCode::ReadError, "read error"},
     {ErrCode::EndOfFile, "read end of file"},
     {ErrCode::InvalidGrammar, "invalid wasm grammar"},
     {ErrCode::InvalidVersion, "invalid version"},
+    {ErrCode::InvalidTarget, "invalid target"},
+    {ErrCode::InvalidMetering, "compiled without gas metering"},
     /// Validation phase
     {ErrCode::InvalidOpCode, "invalid instruction opcode"},
     {ErrCode::InvalidAlignment, "alignment must not be larger than natural"},
@@ -126,12 +138,15 @@ static inline std::unordered_map<ErrCode, std::string> ErrCodeStr = {
     {ErrCode::InvalidMemPages,
      "memory size must be at most 65536 pages (4GiB)"},
     {ErrCode::InvalidStartFunc, "start function"},
+    {ErrCode::InvalidDataIdx, "unknown data segment"},
     /// Instantiation phase
     {ErrCode::ModuleNameConflict, "module name conflict"},
     {ErrCode::IncompatibleImportType, "incompatible import type"},
     {ErrCode::UnknownImport, "unknown import"},
     {ErrCode::DataSegDoesNotFit, "data segment does not fit"},
     {ErrCode::ElemSegDoesNotFit, "elements segment does not fit"},
+    {ErrCode::MemoryReserveFailed, "memory reservation failed"},
+    {ErrCode::MissingCompiledFunc, "compiled function not found"},
     /// Execution phase
     {ErrCode::WrongInstanceAddress, "wrong instance address"},
     {ErrCode::WrongInstanceIndex, "wrong instance index"},
@@ -145,7 +160,8 @@ static inline std::unordered_map<ErrCode, std::string> ErrCodeStr = {
     {ErrCode::UninitializedElement, "uninitialized element"},
     {ErrCode::UndefinedElement, "undefined element"},
     {ErrCode::IndirectCallTypeMismatch, "indirect call type mismatch"},
-    {ErrCode::ExecutionFailed, "host function failed"}};
+    {ErrCode::ExecutionFailed, "host function failed"},
+    {ErrCode::CallStackExhausted, "call stack exhausted"}};
 
 static inline WasmPhase getErrCodePhase(ErrCode Code) {
   return static_cast<WasmPhase>((static_cast<uint8_t>(Code) & 0xF0) >> 5);
@@ -84,7 +84,8 @@ enum class IndexCategory : uint8_t {
   Function,
   Table,
   Memory,
-  Global
+  Global,
+  Data
 };
 
 static inline std::unordered_map<IndexCategory, std::string> IndexCategoryStr =
@@ -94,7 +95,8 @@ static inline std::unordered_map<IndexCategory, std::string> IndexCategoryStr =
      {IndexCategory::Function, "function"},
      {IndexCategory::Table, "table"},
      {IndexCategory::Memory, "memory"},
-     {IndexCategory::Global, "global"}};
+     {IndexCategory::Global, "global"},
+     {IndexCategory::Data, "data"}};
 
 /// Information structures.
 struct InfoFile {
@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/common/executioncontext.h - Execution context definition -----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the execution context struct shared between the AOT
+/// compiled code and the runtime.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/value.h"
+
+#include <cstdint>
+
+namespace SSVM {
+
+/// Per-instance execution context of compiled modules.
+///
+/// Every compiled function receives a pointer to this struct as the first
+/// argument, so that instances of the same compiled module are independent
+/// and can be executed concurrently. The layout is a part of the ABI of the
+/// compiled binaries. Append new fields at the end and bump `kVersion`.
+struct ExecutionContext {
+  using CallProxy = void (*)(ExecutionContext *Ctx, const uint32_t FuncIdx,
+                             const ValVariant *Args, ValVariant *Rets);
+  using MemGrowProxy = uint32_t (*)(ExecutionContext *Ctx,
+                                    const uint32_t Diff);
+  using HostProxy = void (*)(ExecutionContext *Ctx, void *Func,
+                             ValVariant *Args, ValVariant *Rets);
+  using MemInitProxy = void (*)(ExecutionContext *Ctx, const uint32_t DataIdx,
+                                const uint32_t Dst, const uint32_t Src,
+                                const uint32_t Length);
+  using DataDropProxy = void (*)(ExecutionContext *Ctx,
+                                 const uint32_t DataIdx);
+
+  /// Direct binding of an imported host function.
+  struct HostBinding {
+    /// Trampoline for calling the host function. Null if not bound.
+    HostProxy Call = nullptr;
+    /// Opaque pointer to the host function.
+    void *Func = nullptr;
+  };
+
+  /// Base address of the linear memory. Null if no memory.
+  uint8_t *Memory = nullptr;
+  /// Addresses of global values, indexed by the global index in module.
+  ValVariant *const *Globals = nullptr;
+  /// Trampoline for calling the imported functions.
+  CallProxy Call = nullptr;
+  /// Trampoline for the `memory.grow` and `memory.size` instructions.
+  MemGrowProxy MemGrow = nullptr;
+  /// Opaque pointer to the executor, used by the trampolines.
+  void *Host = nullptr;
+  /// Error code of the latest trap.
+  uint32_t TrapCode = 0;
+  /// Counter of executed instructions.
+  uint64_t InstrCount = 0;
+  /// Accumulated cost and the cost limit, used by binaries compiled with gas
+  /// metering. Synchronized with the measurement of the executor.
+  uint64_t CostSum = 0;
+  uint64_t CostLimit = UINT64_MAX;
+  /// Epoch counter of the executor and the deadline, used by binaries
+  /// compiled with interruption checks. The counter may be increased by other
+  /// threads and should be read atomically.
+  const uint64_t *Epoch = nullptr;
+  uint64_t EpochDeadline = UINT64_MAX;
+  /// Address of the current page count of the linear memory, used by binaries
+  /// compiled with explicit bounds checks. Null if no memory.
+  const uint32_t *MemoryPages = nullptr;
+  /// Trampolines for the `memory.init` and `data.drop` instructions, which
+  /// access the data segments kept by the executor.
+  MemInitProxy MemInit = nullptr;
+  DataDropProxy DataDrop = nullptr;
+  /// Current call depth and the limit of compiled functions. Direct calls
+  /// between compiled functions do not enter the executor, so the depth is
+  /// counted by the compiled code.
+  uint32_t CallDepth = 0;
+  uint32_t CallDepthLimit = UINT32_MAX;
+  /// Bindings of imported host functions, indexed by the function index in
+  /// module. Imports without bindings are called through `Call`.
+  const HostBinding *HostFuncs = nullptr;
+
+  /// Field indices in the compiled code.
+  enum class Field : uint32_t {
+    Memory = 0,
+    Globals,
+    Call,
+    MemGrow,
+    Host,
+    TrapCode,
+    InstrCount,
+    CostSum,
+    CostLimit,
+    Epoch,
+    EpochDeadline,
+    MemoryPages,
+    MemInit,
+    DataDrop,
+    CallDepth,
+    CallDepthLimit,
+    HostFuncs,
+  };
+};
+
+} // namespace SSVM
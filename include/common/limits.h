@@ -0,0 +1,27 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/common/limits.h - Default execution limits definition --------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the default limits of value entries and call frames
+/// shared between the VM configuration and the runtime.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+
+namespace SSVM {
+
+/// Default limit of value entries in the execution stack.
+inline constexpr uint32_t kDefaultValueLimit = 1U << 24;
+
+/// Default limit of call frames. Compiled functions call each other on the
+/// native stack without an alternate signal stack, so the depth is kept low
+/// enough for frames of up to 512 bytes in an 8 MiB thread stack.
+inline constexpr uint32_t kDefaultFrameLimit = 1U << 14;
+
+} // namespace SSVM
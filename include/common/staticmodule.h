@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/common/staticmodule.h - Static module definition -------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the registration table of the compiled modules linked
+/// into the host binary.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+
+namespace SSVM {
+
+/// Registration table of a compiled module in a static archive.
+///
+/// `ssvmc --static-name NAME` emits the table as `ssvm_module_NAME`, which
+/// lists the symbols looked up by the loader instead of `dlsym`. Embedders
+/// declare it and pass it to the loader:
+///
+///   extern "C" const SSVM::StaticModule ssvm_module_NAME;
+///
+/// The layout is a part of the ABI of the compiled binaries. Append new fields
+/// at the end and bump `kVersion`.
+struct StaticModule {
+  /// Symbol name used by the loader and its address.
+  struct Symbol {
+    const char *Name;
+    const void *Address;
+  };
+
+  /// Module name given at compile time.
+  const char *Name;
+  /// Number of symbols.
+  uint32_t SymbolCount;
+  /// Symbols of the module.
+  const Symbol *Symbols;
+};
+
+} // namespace SSVM
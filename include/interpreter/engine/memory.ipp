@@ -5,7 +5,9 @@
 #include "runtime/instance/memory.h"
 #include "support/log.h"
 
+#include <atomic>
 #include <cstdint>
+#include <cstring>
 
 namespace SSVM {
 namespace Interpreter {
@@ -71,5 +73,45 @@ TypeB<T> Interpreter::runStoreOp(Runtime::Instance::MemoryInstance &MemInst,
   return {};
 }
 
+template <typename T, typename MemT>
+TypeT<T>
+Interpreter::runLoadUncheckedOp(Runtime::Instance::MemoryInstance &MemInst,
+                                const AST::MemoryInstruction &Instr) {
+  /// Calculate EA. It is less than 8 GiB, so the accesses out of bounds hit
+  /// the guard pages, and the fault jumps back to the instruction loop.
+  ValVariant &Val = StackMgr.getTop();
+  const uint64_t EA = static_cast<uint64_t>(retrieveValue<uint32_t>(Val)) +
+                      Instr.getMemoryOffset();
+
+  /// Value = Mem.Data[EA : sizeof(MemT)], extended by the conversion.
+  MemT Value;
+  AccessJump = AccessBuffer;
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  std::memcpy(&Value, MemInst.getDataPtr() + EA, sizeof(MemT));
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  AccessJump = nullptr;
+  retrieveValue<T>(Val) = static_cast<T>(Value);
+  return {};
+}
+
+template <typename T, typename MemT>
+TypeB<T>
+Interpreter::runStoreUncheckedOp(Runtime::Instance::MemoryInstance &MemInst,
+                                 const AST::MemoryInstruction &Instr) {
+  /// Pop the value t.const c and the address i from the Stack.
+  const MemT Value = static_cast<MemT>(retrieveValue<T>(StackMgr.pop()));
+  const uint64_t EA =
+      static_cast<uint64_t>(retrieveValue<uint32_t>(StackMgr.pop())) +
+      Instr.getMemoryOffset();
+
+  /// Mem.Data[EA : sizeof(MemT)] = Value
+  AccessJump = AccessBuffer;
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  std::memcpy(MemInst.getDataPtr() + EA, &Value, sizeof(MemT));
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+  AccessJump = nullptr;
+  return {};
+}
+
 } // namespace Interpreter
 } // namespace SSVM
@@ -14,7 +14,9 @@
 
 #include "common/ast/instruction.h"
 #include "common/ast/module.h"
+#include "common/boundscheck.h"
 #include "common/errcode.h"
+#include "common/executioncontext.h"
 #include "common/statistics.h"
 #include "common/value.h"
 #include "engine/provider.h"
@@ -22,8 +24,10 @@
 #include "runtime/stackmgr.h"
 #include "runtime/storemgr.h"
 #include "support/measure.h"
+#include "support/profile.h"
 #include "support/time.h"
 
+#include <atomic>
 #include <cassert>
 #include <csetjmp>
 #include <csignal>
@@ -90,10 +94,36 @@ public:
   Interpreter(Support::Measurement *M = nullptr,
               Statistics::Statistics *S = nullptr)
       : Measure(M), Stat(S) {
-    assert(This == nullptr);
-    This = this;
+    installSignalHandlers();
+  }
+  ~Interpreter() noexcept = default;
+
+  /// Increase the epoch counter. Can be called from other threads.
+  void incrementEpoch() { Epoch.fetch_add(1, std::memory_order_relaxed); }
+
+  /// Interrupt the execution when the epoch counter reaches the given ticks
+  /// after the current epoch.
+  void setEpochDeadline(const uint64_t Ticks) {
+    const uint64_t Curr = Epoch.load(std::memory_order_relaxed);
+    EpochDeadline = (Ticks > UINT64_MAX - Curr) ? UINT64_MAX : Curr + Ticks;
+  }
+
+  /// Set the profile to record function entries, branches and indirect call
+  /// targets of the interpreted functions into. nullptr to disable.
+  void setProfile(Support::Profile *P) { Profile = P; }
+
+  /// Set the bounds check strategy of the runtime. Memories reserve 8 GiB of
+  /// address space only with guard pages, or if compiled code relies on them.
+  void setBoundsCheck(const BoundsCheck Value) { Bounds = Value; }
+
+  /// Enable or disable the memory accesses without bounds checks on memories
+  /// with guard pages. The faults on guard pages are turned into traps.
+  void setMemoryFastPath(const bool Enable) { MemoryFastPath = Enable; }
+
+  /// Set the limits of execution stack.
+  void setStackLimit(const uint32_t ValueNum, const uint32_t FrameNum) {
+    StackMgr.setLimit(ValueNum, FrameNum);
   }
-  ~Interpreter() noexcept { This = nullptr; }
 
   /// Instantiate Wasm Module.
   Expect<void> instantiateModule(Runtime::StoreManager &StoreMgr,
@@ -153,7 +183,8 @@ private:
   /// Instantiation of Memory Instances.
   Expect<void> instantiate(Runtime::StoreManager &StoreMgr,
                            Runtime::Instance::ModuleInstance &ModInst,
-                           const AST::MemorySection &MemSec);
+                           const AST::MemorySection &MemSec,
+                           const bool GuardPages);
 
   /// Calculate offsets of table initializations.
   Expect<std::vector<uint32_t>>
@@ -188,6 +219,7 @@ private:
   /// \name Functions for instruction dispatchers.
   /// @{
   Expect<void> execute(Runtime::StoreManager &StoreMgr);
+  Expect<void> executeInstrs(Runtime::StoreManager &StoreMgr);
   Expect<void> execute(Runtime::StoreManager &StoreMgr,
                        const AST::ControlInstruction &Instr);
   Expect<void> execute(Runtime::StoreManager &StoreMgr,
@@ -206,6 +238,9 @@ private:
                        const AST::VariableInstruction &Instr);
   Expect<void> execute(Runtime::StoreManager &StoreMgr,
                        const AST::MemoryInstruction &Instr);
+  Expect<void> executeUnchecked(Runtime::StoreManager &StoreMgr,
+                                Runtime::Instance::MemoryInstance &MemInst,
+                                const AST::MemoryInstruction &Instr);
   Expect<void> execute(Runtime::StoreManager &StoreMgr,
                        const AST::ConstInstruction &Instr);
   Expect<void> execute(Runtime::StoreManager &StoreMgr,
@@ -231,6 +266,15 @@ private:
   /// Helper function for return from functions.
   Expect<void> leaveFunction();
 
+  /// Helper function for checking the epoch deadline.
+  Expect<void> checkInterrupted() const {
+    if (unlikely(Epoch.load(std::memory_order_relaxed) >= EpochDeadline)) {
+      LOG(ERROR) << ErrCode::Interrupted;
+      return Unexpect(ErrCode::Interrupted);
+    }
+    return {};
+  }
+
   /// Helper function for branching to label.
   Expect<void> branchToLabel(Runtime::StoreManager &StoreMgr,
                              const uint32_t Cnt);
@@ -288,8 +332,23 @@ private:
   TypeB<T> runStoreOp(Runtime::Instance::MemoryInstance &MemInst,
                       const AST::MemoryInstruction &Instr,
                       const uint32_t BitWidth = sizeof(T) * 8);
+  template <typename T, typename MemT>
+  TypeT<T> runLoadUncheckedOp(Runtime::Instance::MemoryInstance &MemInst,
+                              const AST::MemoryInstruction &Instr);
+  template <typename T, typename MemT>
+  TypeB<T> runStoreUncheckedOp(Runtime::Instance::MemoryInstance &MemInst,
+                               const AST::MemoryInstruction &Instr);
   Expect<void> runMemorySizeOp(Runtime::Instance::MemoryInstance &MemInst);
   Expect<void> runMemoryGrowOp(Runtime::Instance::MemoryInstance &MemInst);
+  Expect<void> runMemoryInitOp(Runtime::StoreManager &StoreMgr,
+                               Runtime::Instance::MemoryInstance &MemInst,
+                               const AST::MemoryInstruction &Instr);
+  Expect<void> runDataDropOp(Runtime::StoreManager &StoreMgr,
+                             const AST::MemoryInstruction &Instr);
+  Expect<void> runMemoryCopyOp(Runtime::Instance::MemoryInstance &MemInst,
+                               const AST::MemoryInstruction &Instr);
+  Expect<void> runMemoryFillOp(Runtime::Instance::MemoryInstance &MemInst,
+                               const AST::MemoryInstruction &Instr);
   /// ======= Test and Relation Numeric instructions =======
   template <typename T> TypeU<T> runEqzOp(ValVariant &Val) const;
   template <typename T>
@@ -372,16 +431,33 @@ private:
   /// @{
   void call(const uint32_t FuncIndex, const ValVariant *Args, ValVariant *Rets);
   uint32_t memGrow(const uint32_t NewSize);
-
-  /// Pointer to current object.
-  static Interpreter *This;
-  /// jmp_buf for trap.
-  static sigjmp_buf *TrapJump;
-  static uint32_t TrapCodeProxy;
-  static void callProxy(const uint32_t FuncIndex, const ValVariant *Args,
+  Expect<void> memInit(const uint32_t DataIdx, const uint32_t Dst,
+                       const uint32_t Src, const uint32_t Length);
+  Expect<void> dataDrop(const uint32_t DataIdx);
+  Expect<void> callHost(Runtime::HostFunctionBase &HostFunc, ValVariant *Args,
                         ValVariant *Rets);
-  static uint32_t memGrowProxy(const uint32_t NewSize);
-  static void signalHandler(int Signal, siginfo_t *Siginfo, void *);
+
+  /// jmp_buf for trap. Only set while running compiled code on this thread,
+  /// and the outer one is restored when the compiled code returns.
+  static thread_local sigjmp_buf *TrapJump;
+  /// Execution context of the running compiled function.
+  static thread_local ExecutionContext *CurrentExecCtx;
+  static void callProxy(ExecutionContext *ExecCtx, const uint32_t FuncIndex,
+                        const ValVariant *Args, ValVariant *Rets);
+  static uint32_t memGrowProxy(ExecutionContext *ExecCtx,
+                               const uint32_t NewSize);
+  static void hostFuncProxy(ExecutionContext *ExecCtx, void *Func,
+                            ValVariant *Args, ValVariant *Rets);
+  static void memInitProxy(ExecutionContext *ExecCtx, const uint32_t DataIdx,
+                           const uint32_t Dst, const uint32_t Src,
+                           const uint32_t Length);
+  static void dataDropProxy(ExecutionContext *ExecCtx, const uint32_t DataIdx);
+  /// jmp_buf for faults of the memory accesses without bounds checks. Only
+  /// set during the access.
+  static thread_local sigjmp_buf *AccessJump;
+  static void signalHandler(int Signal, siginfo_t *Siginfo, void *Context);
+  /// Install the trap signal handlers once for the process.
+  static void installSignalHandlers();
   /// @}
 
   enum class InstantiateMode : uint8_t { Instantiate = 0, ImportWasm };
@@ -397,6 +473,17 @@ private:
   /// Interpreter statistics
   Statistics::Statistics *Stat;
   Runtime::StoreManager *CurrentStore;
+  /// Epoch counter and the deadline for interruption.
+  std::atomic<uint64_t> Epoch = 0;
+  uint64_t EpochDeadline = UINT64_MAX;
+  /// Pointer to the profile being recorded, or nullptr.
+  Support::Profile *Profile = nullptr;
+  /// Bounds check strategy of the runtime.
+  BoundsCheck Bounds = BoundsCheck::GuardPage;
+  /// Access memories with guard pages without bounds checks, and the jump
+  /// buffer of the running instructions for the faults.
+  bool MemoryFastPath = false;
+  sigjmp_buf *AccessBuffer = nullptr;
 };
 
 } // namespace Interpreter
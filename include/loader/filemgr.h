@@ -39,6 +39,9 @@ public:
   /// Read number of bytes into a vector.
   virtual Expect<std::vector<Byte>> readBytes(size_t SizeToRead) = 0;
 
+  /// Skip number of bytes without reading them out.
+  virtual Expect<void> skipBytes(size_t SizeToSkip) = 0;
+
   /// Read an unsigned int.
   virtual Expect<uint32_t> readU32() = 0;
 
@@ -81,6 +84,7 @@ public:
   }
   Expect<Byte> readByte() override;
   Expect<std::vector<Byte>> readBytes(size_t SizeToRead) override;
+  Expect<void> skipBytes(size_t SizeToSkip) override;
   Expect<uint32_t> readU32() override;
   Expect<uint64_t> readU64() override;
   Expect<int32_t> readS32() override;
@@ -93,6 +97,8 @@ public:
 private:
   /// file stream.
   std::ifstream Fin;
+  /// File size recorded when opening.
+  uint64_t Size = 0;
 };
 
 /// Vector version of file manager.
@@ -105,8 +111,11 @@ public:
     return Unexpect(ErrCode::InvalidPath);
   }
   Expect<void> setCode(Span<const Byte> CodeData) override;
+  /// Take the binary data without copying.
+  Expect<void> setCode(std::vector<Byte> &&CodeData);
   Expect<Byte> readByte() override;
   Expect<std::vector<Byte>> readBytes(size_t SizeToRead) override;
+  Expect<void> skipBytes(size_t SizeToSkip) override;
   Expect<uint32_t> readU32() override;
   Expect<uint64_t> readU64() override;
   Expect<int32_t> readS32() override;
@@ -117,6 +126,7 @@ public:
   uint32_t getOffset() override { return Pos; }
 
   uint32_t getRemainSize() const { return Code.size() - Pos; }
+  Span<const Byte> getCode() const { return Code; }
   void clearBuffer() {
     Code.clear();
     Pos = 0;
@@ -13,11 +13,13 @@
 #pragma once
 
 #include "common/errcode.h"
+#include "common/staticmodule.h"
 #include "common/types.h"
 #include "common/value.h"
 
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace SSVM {
@@ -30,20 +32,58 @@ public:
   /// Set the file path.
   Expect<void> setPath(std::string_view FilePath);
 
+  /// Set the registration table of a compiled module linked into the host
+  /// binary, which must outlive the loaded modules.
+  Expect<void> setStatic(const StaticModule &Module);
+
   /// Read embedded Wasm binary.
   Expect<std::vector<Byte>> getWasm();
 
   /// Read ssvm version.
   Expect<uint32_t> getVersion();
 
-  /// Get symbol.
+  /// Read target settings in the form of "cpu;level;+feature,...".
+  Expect<std::string_view> getTarget();
+
+  /// Check the binary is compiled with gas metering.
+  bool isMetered();
+
+  /// Check the enabled features in target settings are supported by the
+  /// host CPU.
+  static bool isTargetSupported(std::string_view Target);
+
+  /// Get symbol of the selected code variant.
   template <typename T> T *getSymbol(const char *Name) {
     return reinterpret_cast<T *>(getRawSymbol(Name));
   }
   void *getRawSymbol(const char *Name);
 
+  /// Get symbol shared by all code variants.
+  template <typename T> T *getSharedSymbol(const char *Name) {
+    return reinterpret_cast<T *>(getRawSharedSymbol(Name));
+  }
+  void *getRawSharedSymbol(const char *Name);
+
+  /// Getter of the read-only file descriptor of the loaded binary, or -1 if
+  /// not opened. Valid until the next setPath.
+  int getFD() const { return FD; }
+
+  /// Get the offset in the loaded binary file of the mapped address.
+  ///
+  /// \param Ptr the address in the loaded binary.
+  ///
+  /// \returns file offset when success, ErrCode when not mapped from file.
+  Expect<uint64_t> getFileOffset(const void *Ptr);
+
 private:
+  /// Select the code variant by the target settings.
+  void selectVariant();
+
   void *Handler = nullptr;
+  int FD = -1;
+  const StaticModule *Static = nullptr;
+  /// Symbol prefix of the selected code variant.
+  std::string Prefix;
 };
 
 } // namespace SSVM
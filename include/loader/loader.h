@@ -14,6 +14,8 @@
 
 #include "common/ast/module.h"
 #include "common/errcode.h"
+#include "common/staticmodule.h"
+#include "support/measure.h"
 
 #include <string>
 #include <vector>
@@ -24,7 +26,7 @@ namespace Loader {
 /// Loader flow control class.
 class Loader {
 public:
-  Loader() = default;
+  Loader(Support::Measurement *M = nullptr) : Measure(M) {}
   ~Loader() = default;
 
   /// Load data from file path.
@@ -36,10 +38,27 @@ public:
   /// Parse module from byte code.
   Expect<std::unique_ptr<AST::Module>> parseModule(Span<const uint8_t> Code);
 
+  /// Parse compiled module linked into the host binary.
+  Expect<std::unique_ptr<AST::Module>>
+  parseModule(const StaticModule &Module);
+
+  /// Enable or disable recording SHA-256 digest of loaded module binaries.
+  void setModuleHashing(bool Enable) { IsHashing = Enable; }
+  bool isModuleHashing() const { return IsHashing; }
+
 private:
+  /// Parse module from the binary set in the vector file manager.
+  Expect<std::unique_ptr<AST::Module>> loadBuffer();
+
+  /// Check and parse the compiled module set in the loadable manager.
+  Expect<std::unique_ptr<AST::Module>> loadCompiled(std::string_view Name);
+
   FileMgrFStream FSMgr;
   FileMgrVector FVMgr;
   LDMgr LMgr;
+  /// Measurement of the executor, whose cost limit requires metered code.
+  Support::Measurement *Measure;
+  bool IsHashing = false;
 };
 
 } // namespace Loader
@@ -36,6 +36,17 @@ public:
   virtual Expect<void> run(Instance::MemoryInstance *MemInst,
                            Span<ValVariant> Args, Span<ValVariant> Rets) = 0;
 
+  /// Run host function body with the buffers sized by the function type.
+  /// Skips the virtual dispatch and the size checks of `run`.
+  Expect<void> call(Instance::MemoryInstance *MemInst, ValVariant *Args,
+                    ValVariant *Rets) {
+    if (likely(Entry != nullptr)) {
+      return Entry(*this, MemInst, Args, Rets);
+    }
+    return run(MemInst, Span<ValVariant>(Args, FuncType.Params.size()),
+               Span<ValVariant>(Rets, FuncType.Returns.size()));
+  }
+
   /// Getter of function type.
   const Instance::FType &getFuncType() const { return FuncType; }
 
@@ -43,14 +54,21 @@ public:
   uint64_t getCost() const { return Cost; }
 
 protected:
+  using EntryFunc = Expect<void> (*)(HostFunctionBase &,
+                                     Instance::MemoryInstance *, ValVariant *,
+                                     ValVariant *);
+
   Instance::FType FuncType;
   const uint64_t Cost;
+  /// Typed entry of `call`. Null if only `run` is implemented.
+  EntryFunc Entry = nullptr;
 };
 
 template <typename T> class HostFunction : public HostFunctionBase {
 public:
   HostFunction(const uint64_t FuncCost = 0) : HostFunctionBase(FuncCost) {
     initializeFuncType();
+    Entry = &entry;
   }
 
   Expect<void> run(Instance::MemoryInstance *MemInst, Span<ValVariant> Args,
@@ -66,6 +84,15 @@ public:
   }
 
 protected:
+  static Expect<void> entry(HostFunctionBase &Func,
+                            Instance::MemoryInstance *MemInst,
+                            ValVariant *Args, ValVariant *Rets) {
+    using F = FuncTraits<decltype(&T::body)>;
+    return static_cast<HostFunction &>(Func).invoke(
+        MemInst, Span<ValVariant, F::ArgsN>(Args, F::ArgsN),
+        Span<ValVariant, F::RetsN>(Rets, F::RetsN));
+  }
+
   template <typename SpanA, typename SpanR>
   Expect<void> invoke(Instance::MemoryInstance *MemInst, SpanA &&Args,
                       SpanR &&Rets) {
@@ -12,6 +12,7 @@
 #pragma once
 
 #include "common/ast/instruction.h"
+#include "common/executioncontext.h"
 #include "module.h"
 #include "runtime/hostfunc.h"
 
@@ -25,15 +26,18 @@ namespace Instance {
 
 class FunctionInstance {
 public:
-  using CompiledFunction = void (*)(const ValVariant *Args, ValVariant *Rets);
+  using CompiledFunction = void (*)(ExecutionContext *ExecCtx,
+                                    const ValVariant *Args, ValVariant *Rets);
 
   FunctionInstance() = delete;
   /// Constructor for native function.
   FunctionInstance(const uint32_t ModAddr, const FType &Type,
                    Span<const std::pair<uint32_t, ValType>> Locs,
+                   const uint32_t LocNum, const uint32_t MaxStack,
                    const AST::InstrVec &Expr)
       : IsHostFunction(false), FuncType(Type), ModuleAddr(ModAddr),
-        Locals(Locs.begin(), Locs.end()) {
+        Locals(Locs.begin(), Locs.end()), LocalNum(LocNum),
+        MaxStackHeight(MaxStack) {
     /// Copy instructions
     for (auto &It : Expr) {
       if (auto Res = makeInstructionNode(*It.get())) {
@@ -62,6 +66,12 @@ public:
   /// Getter of function body instrs.
   Span<const std::pair<uint32_t, ValType>> getLocals() const { return Locals; }
 
+  /// Getter of total local number, which not includes parameters.
+  uint32_t getLocalNum() const { return LocalNum; }
+
+  /// Getter of maximum operand stack height resolved in validation.
+  uint32_t getMaxStackHeight() const { return MaxStackHeight; }
+
   /// Getter of function body instrs.
   const AST::InstrVec &getInstrs() const { return Instrs; }
 
@@ -81,6 +91,8 @@ private:
   /// @{
   uint32_t ModuleAddr;
   const std::vector<std::pair<uint32_t, ValType>> Locals;
+  const uint32_t LocalNum = 0;
+  const uint32_t MaxStackHeight = 0;
   AST::InstrVec Instrs;
   CompiledFunction Symbol = nullptr;
   /// @}
@@ -33,27 +33,10 @@ public:
   ValMut getValMut() const { return Mut; }
 
   /// Getter of value.
-  const ValVariant &getValue() const {
-    if (Symbol) {
-      return *Symbol;
-    } else {
-      return Value;
-    }
-  }
+  const ValVariant &getValue() const { return Value; }
 
   /// Getter of value.
-  ValVariant &getValue() {
-    if (Symbol) {
-      return *Symbol;
-    } else {
-      return Value;
-    }
-  }
-
-  /// Getter of symbol
-  void *getSymbol() const { return Symbol; }
-  /// Setter of symbol
-  void setSymbol(void *S) { Symbol = reinterpret_cast<ValVariant *>(S); }
+  ValVariant &getValue() { return Value; }
 
 private:
   /// \name Data of global instance.
@@ -61,7 +44,6 @@ private:
   const ValType Type;
   const ValMut Mut;
   ValVariant Value;
-  ValVariant *Symbol = nullptr;
   /// @}
 };
 
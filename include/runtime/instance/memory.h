@@ -25,6 +25,7 @@
 
 #include <linux/mman.h>
 #include <sys/mman.h>
+#include <unistd.h>
 
 namespace SSVM {
 namespace Runtime {
@@ -36,21 +37,47 @@ public:
   static inline constexpr const uint64_t k4G = UINT64_C(0x100000000);
   static inline constexpr const uint64_t k8G = UINT64_C(0x200000000);
   MemoryInstance() = delete;
-  MemoryInstance(const AST::Limit &Lim)
+  /// Reserve the address space of memory and commit the minimum pages.
+  ///
+  /// With guard pages, 8 GiB are reserved so that compiled code without
+  /// bounds checks cannot access outside the reservation. Otherwise the
+  /// maximum size and one guard page are reserved, or only the minimum size
+  /// and one guard page for memories without maximum, which are moved to a
+  /// larger reservation when growing. The data pointer is null if the
+  /// reservation failed.
+  MemoryInstance(const AST::Limit &Lim, const bool GuardPages = true)
       : HasMaxPage(Lim.hasMax()), MinPage(Lim.getMin()), MaxPage(Lim.getMax()),
+        ReservedSize(GuardPages ? k8G : getReservedPages() * kPageSize),
         CurrPage(Lim.getMin()) {
-    const auto Pages = static_cast<uint8_t *>(
-        mmap(nullptr, k8G, PROT_READ | PROT_WRITE,
-             MAP_PRIVATE | MAP_ANONYMOUS | MAP_UNINITIALIZED, -1, 0));
-    mprotect(Pages + CurrPage * kPageSize, k8G - CurrPage * kPageSize,
-             PROT_NONE);
-    DataPtr = Pages;
+    void *Pages = mmap(nullptr, ReservedSize, PROT_NONE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_UNINITIALIZED, -1, 0);
+    if (Pages == MAP_FAILED) {
+      return;
+    }
+    if (CurrPage > 0 && mprotect(Pages, CurrPage * kPageSize,
+                                 PROT_READ | PROT_WRITE) != 0) {
+      munmap(Pages, ReservedSize);
+      return;
+    }
+    DataPtr = static_cast<uint8_t *>(Pages);
+  }
+  ~MemoryInstance() noexcept {
+    if (DataPtr) {
+      munmap(DataPtr, ReservedSize);
+    }
   }
-  ~MemoryInstance() noexcept { munmap(DataPtr, k8G); }
 
   /// Get page size of memory.data
   uint32_t getDataPageSize() const noexcept { return CurrPage; }
 
+  /// Get the address of the page size, which is read by compiled code with
+  /// explicit bounds checks.
+  const uint32_t *getDataPageSizeAddr() const noexcept { return &CurrPage; }
+
+  /// Check all accesses with 32-bit addresses and offsets out of bounds hit
+  /// the reserved inaccessible pages.
+  bool hasGuardPages() const noexcept { return ReservedSize >= k8G; }
+
   /// Getter of limit definition.
   bool getHasMax() const noexcept { return HasMaxPage; }
 
@@ -74,16 +101,21 @@ public:
 
   /// Grow page
   bool growPage(const uint32_t Count) {
-    /// Maximum pages count, 65536
-    uint32_t MaxPageCaped = k4G / kPageSize;
-    if (HasMaxPage) {
-      MaxPageCaped = std::min(MaxPage, MaxPageCaped);
+    if (static_cast<uint64_t>(Count) + CurrPage > getMaxPageCaped()) {
+      return false;
     }
-    if (Count + CurrPage > MaxPageCaped) {
+    /// Only memories without guard pages and maximum size may need a larger
+    /// reservation for the grown pages and the guard page.
+    const uint64_t Needed = (CurrPage + static_cast<uint64_t>(Count) + 1) *
+                            kPageSize;
+    if (Needed > ReservedSize && !reserve(Needed)) {
+      return false;
+    }
+    if (Count > 0 &&
+        mprotect(DataPtr + CurrPage * kPageSize, Count * kPageSize,
+                 PROT_READ | PROT_WRITE) != 0) {
       return false;
     }
-    mprotect(DataPtr + CurrPage * kPageSize, Count * kPageSize,
-             PROT_READ | PROT_WRITE);
     CurrPage += Count;
     return true;
   }
@@ -125,6 +157,69 @@ public:
     return {};
   }
 
+  /// Copy Data[Src : Src + Length - 1] to Data[Dst :]. Regions may overlap.
+  Expect<void> copyBytes(const uint32_t Dst, const uint32_t Src,
+                         const uint32_t Length) {
+    /// Check memory boundary.
+    if (!checkAccessBound(Src, Length)) {
+      LOG(ERROR) << ErrCode::MemoryOutOfBounds;
+      LOG(ERROR) << ErrInfo::InfoBoundary(Src, Length, getBoundIdx());
+      return Unexpect(ErrCode::MemoryOutOfBounds);
+    }
+    if (!checkAccessBound(Dst, Length)) {
+      LOG(ERROR) << ErrCode::MemoryOutOfBounds;
+      LOG(ERROR) << ErrInfo::InfoBoundary(Dst, Length, getBoundIdx());
+      return Unexpect(ErrCode::MemoryOutOfBounds);
+    }
+
+    /// Copy data.
+    if (Length > 0) {
+      std::memmove(DataPtr + Dst, DataPtr + Src, Length);
+    }
+    return {};
+  }
+
+  /// Fill the bytes of Data[Offset : Offset + Length - 1] with Val.
+  Expect<void> fillBytes(const uint32_t Offset, const Byte Val,
+                         const uint32_t Length) {
+    /// Check memory boundary.
+    if (!checkAccessBound(Offset, Length)) {
+      LOG(ERROR) << ErrCode::MemoryOutOfBounds;
+      LOG(ERROR) << ErrInfo::InfoBoundary(Offset, Length, getBoundIdx());
+      return Unexpect(ErrCode::MemoryOutOfBounds);
+    }
+
+    /// Fill data.
+    if (Length > 0) {
+      std::memset(DataPtr + Offset, Val, Length);
+    }
+    return {};
+  }
+
+  /// Map the file to Data[Offset : Offset + Length - 1] copy-on-write.
+  ///
+  /// The pages are shared with the file until written. Offset, FileOffset,
+  /// and Length should be multiples of the host page size.
+  ///
+  /// \param FD the file descriptor opened for reading.
+  /// \param FileOffset the start offset in file.
+  /// \param Offset the start offset in data array.
+  /// \param Length the mapping length.
+  ///
+  /// \returns true when success, false when not aligned or mapping failed.
+  bool mapBytes(int FD, uint64_t FileOffset, const uint32_t Offset,
+                const uint32_t Length) {
+    const uint64_t HostPageSize = static_cast<uint64_t>(getpagesize());
+    if (!checkAccessBound(Offset, Length) || Offset % HostPageSize != 0 ||
+        FileOffset % HostPageSize != 0 || Length % HostPageSize != 0) {
+      return false;
+    }
+    return Length == 0 ||
+           mmap(DataPtr + Offset, Length, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_FIXED, FD,
+                static_cast<off_t>(FileOffset)) != MAP_FAILED;
+  }
+
   /// Get an uint8 array from Data[Offset : Offset + Length - 1]
   Expect<void> getArray(uint8_t *Arr, const uint32_t Offset,
                         const uint32_t Length, const bool IsReverse = false) {
@@ -165,6 +260,10 @@ public:
     return {};
   }
 
+  /// Getter of the base address of memory. The address is only changed by
+  /// growing memories without guard pages and maximum size.
+  uint8_t *getDataPtr() const { return DataPtr; }
+
   /// Get pointer to specific offset of memory or null.
   template <typename T>
   typename std::enable_if_t<std::is_pointer_v<T>, T>
@@ -269,23 +368,65 @@ public:
     return {};
   }
 
-  /// Getter of symbol
-  void *getSymbol() const { return Symbol; }
-  /// Setter of symbol
-  void setSymbol(void *S) {
-    Symbol = reinterpret_cast<uint8_t **>(S);
-    *Symbol = DataPtr;
+private:
+  /// Move the memory to a new reservation of at least Size bytes.
+  ///
+  /// The reservation is at least doubled to amortize the moves. The
+  /// accessible pages are remapped to the new reservation, or copied if they
+  /// cannot be remapped at once, such as the pages mapped from a file.
+  bool reserve(const uint64_t Size) {
+    const uint64_t NewReservedSize =
+        std::min(std::max(Size, ReservedSize * 2),
+                 (getMaxPageCaped() + 1) * kPageSize);
+    void *Pages = mmap(nullptr, NewReservedSize, PROT_NONE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_UNINITIALIZED, -1, 0);
+    if (Pages == MAP_FAILED) {
+      return false;
+    }
+    const uint64_t DataSize = CurrPage * kPageSize;
+    if (DataSize > 0 && mremap(DataPtr, DataSize, DataSize,
+                               MREMAP_MAYMOVE | MREMAP_FIXED,
+                               Pages) != MAP_FAILED) {
+      /// The accessible pages are moved, and only the rest is unmapped.
+      munmap(DataPtr + DataSize, ReservedSize - DataSize);
+    } else {
+      if (DataSize > 0) {
+        if (mprotect(Pages, DataSize, PROT_READ | PROT_WRITE) != 0) {
+          munmap(Pages, NewReservedSize);
+          return false;
+        }
+        std::memcpy(Pages, DataPtr, DataSize);
+      }
+      munmap(DataPtr, ReservedSize);
+    }
+    DataPtr = static_cast<uint8_t *>(Pages);
+    ReservedSize = NewReservedSize;
+    return true;
+  }
+
+  /// Pages reserved without guard pages, including one guard page after the
+  /// maximum size, or after the minimum size if there is no maximum.
+  uint64_t getReservedPages() const noexcept {
+    return (HasMaxPage ? getMaxPageCaped()
+                       : std::min<uint64_t>(MinPage, getMaxPageCaped())) +
+           1;
+  }
+
+  /// Maximum pages count, 65536 or the limit.
+  uint64_t getMaxPageCaped() const noexcept {
+    const uint64_t MaxPageCaped = k4G / kPageSize;
+    return HasMaxPage ? std::min<uint64_t>(MaxPage, MaxPageCaped)
+                      : MaxPageCaped;
   }
 
-private:
   /// \name Data of memory instance.
   /// @{
   const bool HasMaxPage;
   const uint32_t MinPage;
   const uint32_t MaxPage;
+  uint64_t ReservedSize;
   uint8_t *DataPtr = nullptr;
   uint32_t CurrPage = 0;
-  uint8_t **Symbol = nullptr;
   /// @}
 };
 
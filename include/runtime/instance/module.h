@@ -12,6 +12,7 @@
 #pragma once
 
 #include "common/errcode.h"
+#include "common/executioncontext.h"
 #include "common/types.h"
 #include "support/span.h"
 #include "type.h"
@@ -117,6 +118,30 @@ public:
   uint32_t getMemNum() const { return MemAddrs.size(); }
   uint32_t getGlobalNum() const { return GlobalAddrs.size(); }
 
+  /// Append data segment. Active segments are added as dropped.
+  void addDataSeg(Span<const Byte> Data) {
+    DataSegs.emplace_back(Data.begin(), Data.end());
+  }
+
+  /// Get data segment by index. Dropped segment is an empty span.
+  Expect<Span<const Byte>> getDataSeg(const uint32_t Idx) const {
+    if (Idx >= DataSegs.size()) {
+      /// Error logging need to be handled in caller.
+      return Unexpect(ErrCode::WrongInstanceIndex);
+    }
+    return DataSegs[Idx];
+  }
+
+  /// Drop data segment by index and release its content.
+  Expect<void> dropDataSeg(const uint32_t Idx) {
+    if (Idx >= DataSegs.size()) {
+      /// Error logging need to be handled in caller.
+      return Unexpect(ErrCode::WrongInstanceIndex);
+    }
+    std::vector<Byte>().swap(DataSegs[Idx]);
+    return {};
+  }
+
   /// Set start function index and find the address in Store.
   void setStartIdx(const uint32_t Idx) {
     StartAddr = FuncAddrs[Idx];
@@ -131,6 +156,21 @@ public:
     return {StartAddr};
   };
 
+  /// Getter of the execution context for compiled functions.
+  ExecutionContext &getExecutionContext() { return ExecCtx; }
+
+  /// Setter of the global value addresses in the execution context.
+  void setGlobalPtrs(std::vector<ValVariant *> Ptrs) {
+    GlobalPtrs = std::move(Ptrs);
+    ExecCtx.Globals = GlobalPtrs.data();
+  }
+
+  /// Setter of the host function bindings in the execution context.
+  void setHostBindings(std::vector<ExecutionContext::HostBinding> Bindings) {
+    HostBindings = std::move(Bindings);
+    ExecCtx.HostFuncs = HostBindings.data();
+  }
+
   /// Module Instance address in store manager.
   uint32_t Addr;
 
@@ -147,6 +187,9 @@ private:
   std::vector<uint32_t> MemAddrs;
   std::vector<uint32_t> GlobalAddrs;
 
+  /// Data segment contents for memory.init.
+  std::vector<std::vector<Byte>> DataSegs;
+
   /// Exports.
   std::map<std::string, uint32_t, std::less<>> ExpFuncs;
   std::map<std::string, uint32_t, std::less<>> ExpTables;
@@ -156,6 +199,11 @@ private:
   /// Start function address
   bool HasStartFunc = false;
   uint32_t StartAddr;
+
+  /// Execution context for compiled functions of this instance.
+  ExecutionContext ExecCtx;
+  std::vector<ValVariant *> GlobalPtrs;
+  std::vector<ExecutionContext::HostBinding> HostBindings;
 };
 
 } // namespace Instance
@@ -74,23 +74,14 @@ public:
       LOG(ERROR) << ErrInfo::InfoBoundary(Idx, 1, getBoundIdx());
       return Unexpect(ErrCode::UndefinedElement);
     }
-    if (Symbol) {
-      return Symbol[Idx];
+    if (FuncElemInit[Idx]) {
+      return FuncElem[Idx];
     } else {
-      if (FuncElemInit[Idx]) {
-        return FuncElem[Idx];
-      } else {
-        LOG(ERROR) << ErrCode::UninitializedElement;
-        return Unexpect(ErrCode::UninitializedElement);
-      }
+      LOG(ERROR) << ErrCode::UninitializedElement;
+      return Unexpect(ErrCode::UninitializedElement);
     }
   }
 
-  /// Getter of symbol
-  void *getSymbol() const { return Symbol; }
-  /// Setter of symbol
-  void setSymbol(void *S) { Symbol = reinterpret_cast<uint32_t *>(S); }
-
 private:
   /// \name Data of table instance.
   /// @{
@@ -100,7 +91,6 @@ private:
   const uint32_t MaxSize = 0;
   std::vector<uint32_t> FuncElem;
   std::vector<bool> FuncElemInit;
-  uint32_t *Symbol = nullptr;
   /// @}
 };
 
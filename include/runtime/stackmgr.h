@@ -12,10 +12,12 @@
 #pragma once
 
 #include "common/ast/instruction.h"
+#include "common/limits.h"
 #include "common/value.h"
 #include "support/casting.h"
 #include "support/span.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -85,6 +87,43 @@ public:
     return V;
   }
 
+  /// Setter of stack limits.
+  ///
+  /// \param ValueNum the maximum number of value entries in stack.
+  /// \param FrameNum the maximum number of frames, i.e. the call depth.
+  void setLimit(const uint32_t ValueNum, const uint32_t FrameNum) {
+    ValueLimit = ValueNum;
+    FrameLimit = FrameNum;
+  }
+
+  /// Getter of the number of frames, i.e. the current call depth.
+  uint32_t getFrameNum() const { return FrameStack.size(); }
+
+  /// Getter of the maximum number of frames.
+  uint32_t getFrameLimit() const { return FrameLimit; }
+
+  /// Check and reserve the stack space for a new frame.
+  ///
+  /// The value stack will not be reallocated when pushing the ValueNum value
+  /// entries of the new frame after this function succeeded.
+  ///
+  /// \param ValueNum the number of value entries needed by the new frame.
+  ///
+  /// \returns false if the stack limits will be exceeded, true if not.
+  bool reserveFrame(const uint32_t ValueNum) {
+    if (unlikely(FrameStack.size() >= FrameLimit ||
+                 ValueStack.size() + ValueNum > ValueLimit)) {
+      return false;
+    }
+    const size_t Need = ValueStack.size() + ValueNum;
+    if (unlikely(Need > ValueStack.capacity())) {
+      ValueStack.reserve(std::min(
+          static_cast<size_t>(ValueLimit),
+          std::max(Need, ValueStack.capacity() * 2)));
+    }
+    return true;
+  }
+
   /// Push a new frame entry to stack.
   void pushFrame(const uint32_t ModuleAddr, const uint32_t LocalNum = 0,
                  const uint32_t ArityNum = 0) {
@@ -156,6 +195,8 @@ private:
   std::vector<Value> ValueStack;
   std::vector<Label> LabelStack;
   std::vector<Frame> FrameStack;
+  uint32_t ValueLimit = kDefaultValueLimit;
+  uint32_t FrameLimit = kDefaultFrameLimit;
   /// @}
 };
 
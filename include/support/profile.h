@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/support/profile.h - Execution profile class definition -------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the Profile class, which records the
+/// function entry counts, branch counts and indirect call targets of a module
+/// for profile guided AOT compilation.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+
+#include <cstdint>
+#include <map>
+#include <string_view>
+#include <unordered_map>
+
+namespace SSVM {
+namespace Support {
+
+/// Execution profile of a module.
+///
+/// Functions and instructions are identified by their offsets in the module
+/// binary, and a function by the offset of its first instruction. So the
+/// profile is only meaningful for the same module binary.
+class Profile {
+public:
+  /// Counts of a conditional branch.
+  struct BranchCount {
+    uint64_t Taken = 0;
+    uint64_t NotTaken = 0;
+  };
+
+  /// Record an entry of the function.
+  void addEntry(uint32_t FuncOffset) { ++Entries[FuncOffset]; }
+
+  /// Record the result of the conditional branch at `br_if` or `if`.
+  void addBranch(uint32_t Offset, bool Taken) {
+    auto &Count = Branches[Offset];
+    ++(Taken ? Count.Taken : Count.NotTaken);
+  }
+
+  /// Record the target function of the `call_indirect`.
+  void addIndirectCall(uint32_t Offset, uint32_t FuncOffset) {
+    ++IndirectCalls[Offset][FuncOffset];
+  }
+
+  /// Getter of the entry count of the function.
+  uint64_t getEntryCount(uint32_t FuncOffset) const {
+    if (auto It = Entries.find(FuncOffset); It != Entries.end()) {
+      return It->second;
+    }
+    return 0;
+  }
+
+  /// Getter of the branch counts, or nullptr if not executed.
+  const BranchCount *getBranchCount(uint32_t Offset) const {
+    if (auto It = Branches.find(Offset); It != Branches.end()) {
+      return &It->second;
+    }
+    return nullptr;
+  }
+
+  /// Getter of the counts of target functions, or nullptr if not executed.
+  const std::map<uint32_t, uint64_t> *getIndirectCalls(uint32_t Offset) const {
+    if (auto It = IndirectCalls.find(Offset); It != IndirectCalls.end()) {
+      return &It->second;
+    }
+    return nullptr;
+  }
+
+  /// Check no count is recorded.
+  bool empty() const {
+    return Entries.empty() && Branches.empty() && IndirectCalls.empty();
+  }
+
+  /// Remove all counts.
+  void clear() {
+    Entries.clear();
+    Branches.clear();
+    IndirectCalls.clear();
+  }
+
+  /// Read a profile file and add the counts into this profile.
+  ///
+  /// \param Path the path of profile file.
+  ///
+  /// \returns void when success, ErrCode when failed.
+  Expect<void> load(std::string_view Path);
+
+  /// Write this profile into file.
+  ///
+  /// \param Path the path of profile file.
+  ///
+  /// \returns void when success, ErrCode when failed.
+  Expect<void> save(std::string_view Path) const;
+
+private:
+  std::unordered_map<uint32_t, uint64_t> Entries;
+  std::unordered_map<uint32_t, BranchCount> Branches;
+  std::unordered_map<uint32_t, std::map<uint32_t, uint64_t>> IndirectCalls;
+};
+
+} // namespace Support
+} // namespace SSVM
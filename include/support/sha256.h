@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/support/sha256.h - SHA-256 digest class definition -----------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the SHA256 class, which computes the
+/// SHA-256 digest of byte sequences for identifying module binaries.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "support/span.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace SSVM {
+namespace Support {
+
+class SHA256 {
+public:
+  using Digest = std::array<uint8_t, 32>;
+
+  SHA256() { reset(); }
+
+  /// Reset to the initial state.
+  void reset();
+
+  /// Append bytes to the message.
+  void update(Span<const uint8_t> Data);
+
+  /// Finish the message and get the digest. The state will be reset.
+  Digest finalize();
+
+  /// Helper function to get digest of a byte sequence.
+  static Digest hash(Span<const uint8_t> Data) {
+    SHA256 Hasher;
+    Hasher.update(Data);
+    return Hasher.finalize();
+  }
+
+  /// Helper function to convert digest into hex string.
+  static std::string toHexStr(const Digest &D);
+
+private:
+  void processBlock(const uint8_t *Block);
+
+  std::array<uint32_t, 8> State;
+  std::array<uint8_t, 64> Buffer;
+  uint64_t Length;
+  uint32_t BufferSize;
+};
+
+} // namespace Support
+} // namespace SSVM
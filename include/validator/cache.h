@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/validator/cache.h - Validation cache class definition --------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the ValidationCache class, which
+/// memorizes the validated modules by the digest of their binaries.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "support/sha256.h"
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace SSVM {
+namespace Validator {
+
+/// Process-wide validation results cache.
+class ValidationCache {
+public:
+  using Digest = Support::SHA256::Digest;
+
+  /// Results of validation which will be restored into AST on cache hit.
+  struct Entry {
+    /// Maximum value stack height of each code segment.
+    std::vector<uint32_t> MaxStackHeights;
+    /// Parameter and result numbers of each block, loop, and if instruction
+    /// in the code segments, in pre-order.
+    std::vector<std::pair<uint32_t, uint32_t>> BlockArities;
+  };
+
+  /// Get the process-wide cache instance.
+  static ValidationCache &getInstance();
+
+  /// Find the validation results of the module digest.
+  ///
+  /// \param Hash the SHA-256 digest of module binary.
+  ///
+  /// \returns the validation results if found, nullopt otherwise.
+  std::optional<Entry> find(const Digest &Hash);
+
+  /// Insert the validation results of the module digest.
+  ///
+  /// The oldest entry will be evicted when the cache is full.
+  ///
+  /// \param Hash the SHA-256 digest of module binary.
+  /// \param E the validation results.
+  void insert(const Digest &Hash, Entry E);
+
+  /// Remove all entries.
+  void clear();
+
+  /// Getter and setter of the maximum entry number.
+  void setCapacity(uint32_t Cap);
+  uint32_t getCapacity();
+
+  static inline constexpr const uint32_t kDefaultCapacity = 256;
+
+private:
+  ValidationCache() = default;
+  void evict();
+
+  std::mutex Mutex;
+  std::map<Digest, Entry> Entries;
+  std::deque<Digest> InsertOrder;
+  uint32_t Capacity = kDefaultCapacity;
+};
+
+} // namespace Validator
+} // namespace SSVM
@@ -20,6 +20,7 @@
 #include "support/span.h"
 
 #include <deque>
+#include <optional>
 #include <vector>
 
 namespace SSVM {
@@ -33,9 +34,8 @@ public:
   ~FormChecker() = default;
 
   void reset(bool CleanGlobal = false);
-  Expect<void> validate(const AST::InstrVec &Instrs,
-                        Span<const ValType> RetVals);
-  Expect<void> validate(const AST::InstrVec &Instrs, Span<const VType> RetVals);
+  Expect<void> validate(AST::InstrVec &Instrs, Span<const ValType> RetVals);
+  Expect<void> validate(AST::InstrVec &Instrs, Span<const VType> RetVals);
 
   /// Adder of contexts
   void addType(const AST::FunctionType &Func);
@@ -45,6 +45,7 @@ public:
   void addGlobal(const AST::GlobalType &Glob, const bool IsImport = false);
   void addLocal(const ValType &V);
   void addLocal(const VType &V);
+  void setDataCount(const uint32_t Cnt) { NumDatas = Cnt; }
 
   std::vector<VType> result() { return ValStack; };
   auto &getTypes() { return Types; }
@@ -55,40 +56,39 @@ public:
   uint32_t getNumImportFuncs() const { return NumImportFuncs; }
   uint32_t getNumImportGlobals() const { return NumImportGlobals; }
 
+  /// Getter of maximum value stack height of the last validated expression.
+  uint32_t getMaxStackHeight() const { return MaxValStackHeight; }
+
   /// Helper function
   VType ASTToVType(const ValType &V);
   ValType VTypeToAST(const VType &V);
 
+  /// Control frame. The start and end types refer to the types stored in the
+  /// checker contexts, which are not changed when checking function bodies.
   struct CtrlFrame {
     CtrlFrame() = default;
-    CtrlFrame(struct CtrlFrame &&F)
-        : StartTypes(std::move(F.StartTypes)), EndTypes(std::move(F.EndTypes)),
-          Height(F.Height), IsUnreachable(F.IsUnreachable), IsLoop(F.IsLoop) {}
-    CtrlFrame(const struct CtrlFrame &F)
-        : StartTypes(F.StartTypes), EndTypes(F.EndTypes), Height(F.Height),
-          IsUnreachable(F.IsUnreachable), IsLoop(F.IsLoop) {}
     CtrlFrame(Span<const VType> In, Span<const VType> Out, size_t H,
               bool IsLoopOp = false)
-        : StartTypes(In.begin(), In.end()), EndTypes(Out.begin(), Out.end()),
-          Height(H), IsUnreachable(false), IsLoop(IsLoopOp) {}
-    std::vector<VType> StartTypes;
-    std::vector<VType> EndTypes;
-    size_t Height;
-    bool IsUnreachable;
-    bool IsLoop;
+        : StartTypes(In), EndTypes(Out), Height(H), IsUnreachable(false),
+          IsLoop(IsLoopOp) {}
+    Span<const VType> StartTypes;
+    Span<const VType> EndTypes;
+    size_t Height = 0;
+    bool IsUnreachable = false;
+    bool IsLoop = false;
   };
 
 private:
   /// Checking expression
-  Expect<void> checkExpr(const AST::InstrVec &Instrs);
+  Expect<void> checkExpr(AST::InstrVec &Instrs);
 
   /// Checking instruction list
-  Expect<void> checkInstrs(const AST::InstrVec &Instrs);
+  Expect<void> checkInstrs(AST::InstrVec &Instrs);
 
   /// Instruction iteration
   Expect<void> checkInstr(const AST::ControlInstruction &Instr);
-  Expect<void> checkInstr(const AST::BlockControlInstruction &Instr);
-  Expect<void> checkInstr(const AST::IfElseControlInstruction &Instr);
+  Expect<void> checkInstr(AST::BlockControlInstruction &Instr);
+  Expect<void> checkInstr(AST::IfElseControlInstruction &Instr);
   Expect<void> checkInstr(const AST::BrControlInstruction &Instr);
   Expect<void> checkInstr(const AST::BrTableControlInstruction &Instr);
   Expect<void> checkInstr(const AST::CallControlInstruction &Instr);
@@ -114,7 +114,7 @@ private:
 
   /// Helper functions
   Expect<std::pair<Span<const VType>, Span<const VType>>>
-  resolveBlockType(std::vector<VType> &Buffer, BlockType Type);
+  resolveBlockType(BlockType Type);
 
   /// Contexts.
   std::vector<std::pair<std::vector<VType>, std::vector<VType>>> Types;
@@ -124,12 +124,15 @@ private:
   std::vector<std::pair<VType, ValMut>> Globals;
   uint32_t NumImportFuncs = 0;
   uint32_t NumImportGlobals = 0;
+  /// Count of data segments. Set only when data count section exists.
+  std::optional<uint32_t> NumDatas;
   std::vector<VType> Locals;
   std::vector<VType> Returns;
 
   /// Running stack.
   std::vector<CtrlFrame> CtrlStack;
   std::vector<VType> ValStack;
+  uint32_t MaxValStackHeight = 0;
 };
 
 } // namespace Validator
@@ -15,6 +15,7 @@
 #include "common/ast/module.h"
 #include "common/errcode.h"
 #include "formchecker.h"
+#include "validator/cache.h"
 
 #include <memory>
 
@@ -28,7 +29,14 @@ public:
   ~Validator() = default;
 
   /// Validate AST::Module.
-  Expect<void> validate(const AST::Module &Mod);
+  ///
+  /// If the module carries the digest of its binary and the caching is
+  /// enabled, the validated results will be shared in process-wide cache.
+  Expect<void> validate(AST::Module &Mod);
+
+  /// Enable or disable the process-wide validation cache. Enabled by default.
+  void setCaching(bool Enable) { IsCaching = Enable; }
+  bool isCaching() const { return IsCaching; }
 
 private:
   /// Validate AST::Types
@@ -40,8 +48,7 @@ private:
   /// Validate AST::Segments
   Expect<void> validate(const AST::GlobalSegment &GlobSeg);
   Expect<void> validate(const AST::ElementSegment &ElemSeg);
-  Expect<void> validate(const AST::CodeSegment &CodeSeg,
-                        const uint32_t TypeIdx);
+  Expect<void> validate(AST::CodeSegment &CodeSeg, const uint32_t TypeIdx);
   Expect<void> validate(const AST::DataSegment &DataSeg);
 
   /// Validate AST::Desc
@@ -55,17 +62,21 @@ private:
   Expect<void> validate(const AST::MemorySection &MemSec);
   Expect<void> validate(const AST::GlobalSection &GlobSec);
   Expect<void> validate(const AST::ElementSection &ElemSec);
-  Expect<void> validate(const AST::CodeSection &CodeSec);
+  Expect<void> validate(AST::CodeSection &CodeSec);
   Expect<void> validate(const AST::DataSection &DataSec);
   Expect<void> validate(const AST::StartSection &StartSec);
   Expect<void> validate(const AST::ExportSection &ExportSec);
 
   /// Validate const expression
-  Expect<void> validateConstExpr(const AST::InstrVec &Instrs,
+  Expect<void> validateConstExpr(AST::InstrVec &Instrs,
                                  Span<const ValType> Returns);
 
+  /// Restore cached validation results into AST. Return false if mismatched.
+  bool restoreResults(AST::Module &Mod, const ValidationCache::Entry &Entry);
+
   static inline const uint32_t LIMIT_MEMORYTYPE = 1U << 16;
   FormChecker Checker;
+  bool IsCaching = true;
 };
 
 } // namespace Validator
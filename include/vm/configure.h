@@ -11,6 +11,9 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include "common/boundscheck.h"
+#include "common/limits.h"
+
 #include <memory>
 #include <string>
 #include <unordered_set>
@@ -34,8 +37,37 @@ public:
     return ((Types.find(Type) != Types.end()) ? true : false);
   }
 
+  /// Setter and getter of maximum value entries in execution stack.
+  void setMaxStackValues(const uint32_t Num) { MaxStackValues = Num; }
+  uint32_t getMaxStackValues() const { return MaxStackValues; }
+
+  /// Setter and getter of maximum call depth in execution.
+  void setMaxCallDepth(const uint32_t Depth) { MaxCallDepth = Depth; }
+  uint32_t getMaxCallDepth() const { return MaxCallDepth; }
+
+  /// Enable or disable the validation results cache keyed by module digest.
+  /// Enabled by default.
+  void setValidationCache(const bool Enable) { IsValidationCache = Enable; }
+  bool isValidationCache() const { return IsValidationCache; }
+
+  /// Setter and getter of the bounds check strategy. Without guard pages,
+  /// memories only reserve the address space of their maximum size, except
+  /// for compiled code relying on guard pages.
+  void setBoundsCheck(const BoundsCheck Value) { Bounds = Value; }
+  BoundsCheck getBoundsCheck() const { return Bounds; }
+
+  /// Enable or disable the interpreter memory accesses without bounds checks,
+  /// which rely on the guard pages to trap.
+  void setMemoryFastPath(const bool Enable) { IsMemoryFastPath = Enable; }
+  bool isMemoryFastPath() const { return IsMemoryFastPath; }
+
 private:
   std::unordered_set<VMType> Types;
+  uint32_t MaxStackValues = kDefaultValueLimit;
+  uint32_t MaxCallDepth = kDefaultFrameLimit;
+  bool IsValidationCache = true;
+  BoundsCheck Bounds = BoundsCheck::GuardPage;
+  bool IsMemoryFastPath = false;
 };
 
 } // namespace VM
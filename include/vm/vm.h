@@ -43,6 +43,8 @@ public:
   /// Register wasm modules and host modules.
   Expect<void> registerModule(std::string_view Name, std::string_view Path);
   Expect<void> registerModule(std::string_view Name, Span<const Byte> Code);
+  Expect<void> registerModule(std::string_view Name,
+                              const StaticModule &Module);
   Expect<void> registerModule(const Runtime::ImportObject &Obj);
 
   /// Rapidly load, validate, instantiate, and run wasm function.
@@ -53,9 +55,11 @@ public:
   runWasmFile(Span<const Byte> Code, std::string_view Func,
               Span<const ValVariant> Params = {});
 
-  /// Load given wasm file or wasm bytecode.
+  /// Load given wasm file, wasm bytecode, or compiled module linked into the
+  /// host binary.
   Expect<void> loadWasm(std::string_view Path);
   Expect<void> loadWasm(Span<const Byte> Code);
+  Expect<void> loadWasm(const StaticModule &Module);
 
   /// ======= Functions can be called after loaded stage. =======
   /// Validate loaded wasm module.
@@ -89,6 +93,18 @@ public:
   /// Getter of store set in VM.
   Runtime::StoreManager &getStoreManager() { return StoreRef; }
 
+  /// Increase the epoch counter of the executor. Thread-safe.
+  void incrementEpoch() { InterpreterEngine.incrementEpoch(); }
+
+  /// Interrupt the execution after the given ticks of epoch.
+  void setEpochDeadline(const uint64_t Ticks) {
+    InterpreterEngine.setEpochDeadline(Ticks);
+  }
+
+  /// Record the execution profile of interpreted functions into the given
+  /// profile. nullptr to stop recording.
+  void setProfile(Support::Profile *P) { InterpreterEngine.setProfile(P); }
+
   /// Getter of measurement.
   Support::Measurement &getMeasurement() { return Measure; }
 
@@ -105,8 +121,8 @@ private:
   enum class VMStage : uint8_t { Inited, Loaded, Validated, Instantiated };
 
   void initVM();
-  Expect<void> registerModule(std::string_view Name, const AST::Module &Module);
-  Expect<std::vector<ValVariant>> runWasmFile(const AST::Module &Module,
+  Expect<void> registerModule(std::string_view Name, AST::Module &Module);
+  Expect<std::vector<ValVariant>> runWasmFile(AST::Module &Module,
                                               std::string_view Func,
                                               Span<const ValVariant> Params);
 
@@ -1,19 +1,40 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "aot/compiler.h"
+#include "common/cpufeature.h"
+#include "common/executioncontext.h"
 #include "runtime/instance/memory.h"
 #include "support/filesystem.h"
 #include "support/log.h"
+#include "support/sha256.h"
 #include <lld/Common/Driver.h>
+#include <llvm/Analysis/AliasAnalysis.h>
 #include <llvm/Analysis/TargetLibraryInfo.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/MC/MCSubtargetInfo.h>
 #include <llvm/MC/SubtargetFeature.h>
+#include <llvm/Object/ArchiveWriter.h>
+#include <llvm/Object/SymbolSize.h>
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Support/FileSystem.h>
-#include <llvm/Support/TargetRegistry.h>
+#include <llvm/Support/Format.h>
+#include <llvm/Support/Host.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Target/TargetMachine.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
 
 #if LLVM_VERSION_MAJOR >= 10
 #include <llvm/IR/IntrinsicsAArch64.h>
@@ -21,27 +42,68 @@
 #include <llvm/Support/Alignment.h>
 #endif
 
+#if LLVM_VERSION_MAJOR >= 14
+#include <llvm/MC/TargetRegistry.h>
+#else
+#include <llvm/Support/TargetRegistry.h>
+#endif
+
 namespace {
 
+#if LLVM_VERSION_MAJOR >= 11
+static inline constexpr auto kRoundToNearest =
+    llvm::RoundingMode::NearestTiesToEven;
+#elif LLVM_VERSION_MAJOR >= 10
+static inline constexpr auto kRoundToNearest = llvm::fp::rmToNearest;
+#else
+static inline constexpr auto kRoundToNearest =
+    llvm::ConstrainedFPIntrinsic::rmToNearest;
+#endif
+
 #if LLVM_VERSION_MAJOR >= 10
-using RoundingMode = llvm::fp::RoundingMode;
 using ExceptionBehavior = llvm::fp::ExceptionBehavior;
 using Align = llvm::Align;
 #else
-using RoundingMode = llvm::ConstrainedFPIntrinsic::RoundingMode;
 using ExceptionBehavior = llvm::ConstrainedFPIntrinsic::ExceptionBehavior;
 static inline unsigned Align(unsigned Value) noexcept { return Value; }
 #endif
 
+/// IRBuilder helpers taking the element type from the typed pointer, since
+/// the overloads without an explicit type are removed in newer LLVM.
+static inline llvm::LoadInst *createLoad(llvm::IRBuilder<> &Builder,
+                                         llvm::Value *Ptr) {
+  return Builder.CreateLoad(Ptr->getType()->getPointerElementType(), Ptr);
+}
+static inline llvm::Value *
+createInBoundsGEP(llvm::IRBuilder<> &Builder, llvm::Value *Ptr,
+                  llvm::ArrayRef<llvm::Value *> IdxList) {
+  return Builder.CreateInBoundsGEP(Ptr->getType()->getPointerElementType(),
+                                   Ptr, IdxList);
+}
+static inline llvm::Value *
+createConstInBoundsGEP1_64(llvm::IRBuilder<> &Builder, llvm::Value *Ptr,
+                           uint64_t Idx) {
+  return Builder.CreateConstInBoundsGEP1_64(
+      Ptr->getType()->getPointerElementType(), Ptr, Idx);
+}
+static inline llvm::CallInst *createCall(llvm::IRBuilder<> &Builder,
+                                         llvm::Value *Callee,
+                                         llvm::ArrayRef<llvm::Value *> Args) {
+  return Builder.CreateCall(
+      llvm::cast<llvm::FunctionType>(
+          Callee->getType()->getPointerElementType()),
+      Callee, Args);
+}
+
 static bool isVoidReturn(SSVM::Span<const SSVM::ValType> ValTypes);
 static llvm::Type *toLLVMType(llvm::LLVMContext &Context,
                               const SSVM::ValType &ValType);
 static std::vector<llvm::Type *>
-toLLVMArgsType(llvm::LLVMContext &Context,
+toLLVMArgsType(llvm::PointerType *ExecCtxPtrTy,
                SSVM::Span<const SSVM::ValType> ValTypes);
 static llvm::Type *toLLVMRetsType(llvm::LLVMContext &Context,
                                   SSVM::Span<const SSVM::ValType> ValTypes);
-static llvm::FunctionType *toLLVMType(llvm::LLVMContext &Context,
+static llvm::FunctionType *toLLVMType(llvm::PointerType *ExecCtxPtrTy,
                                       const SSVM::AST::FunctionType &FuncType);
 static llvm::Constant *toLLVMConstantZero(llvm::LLVMContext &Context,
                                           const SSVM::ValType &ValType);
@@ -57,6 +119,24 @@ template <typename... Ts> overloaded(Ts...) -> overloaded<Ts...>;
 /// force checking div/rem on zero
 static inline constexpr bool ForceDivCheck = false;
 
+/// function index of uninitialized table elements
+static inline constexpr unsigned int NullElement = UINT32_MAX;
+
+/// alignment of data segment images, the smallest page size of hosts
+static inline constexpr uint64_t kDataImageAlign = 4096;
+
+/// size of wasm pages
+static inline constexpr uint64_t kPageSize =
+    SSVM::Runtime::Instance::MemoryInstance::kPageSize;
+
+/// Make branch weights from profile counts, scaled down to 32 bits.
+static llvm::MDNode *toBranchWeights(llvm::LLVMContext &Context,
+                                     uint64_t TrueCount, uint64_t FalseCount) {
+  const uint64_t Scale = std::max(TrueCount, FalseCount) / UINT32_MAX + 1;
+  return llvm::MDBuilder(Context).createBranchWeights(
+      uint32_t(TrueCount / Scale), uint32_t(FalseCount / Scale));
+}
+
 } // namespace
 
 struct SSVM::AOT::Compiler::CompileContext {
@@ -76,47 +156,81 @@ struct SSVM::AOT::Compiler::CompileContext {
 #endif
   std::vector<const AST::FunctionType *> FunctionTypes;
   std::vector<unsigned int> Elements;
+  /// Table of {type index, function pointer} for call_indirect.
+  llvm::GlobalVariable *FunctionTable = nullptr;
+  /// Wrappers of the functions called from the runtime, by function index.
+  std::unordered_map<uint32_t, llvm::Function *> Wrappers;
   std::vector<
       std::tuple<unsigned int, llvm::Function *, SSVM::AST::CodeSegment *>>
       Functions;
-  std::vector<llvm::GlobalVariable *> Globals;
-  llvm::GlobalVariable *Call;
-  llvm::GlobalVariable *MemGrow;
-  llvm::GlobalVariable *Mem;
-  llvm::GlobalVariable *TrapCode;
-  llvm::GlobalVariable *InstrCount;
+  /// Cost table of instructions. Gas metering is disabled if empty.
+  std::vector<uint64_t> CostTable;
+  /// Emit epoch deadline checks at loop headers.
+  bool Interruptible = false;
+  /// Decoded name section for naming the functions, or nullptr.
+  const AST::NameSection *Names = nullptr;
+  /// Execution profile, or nullptr.
+  const Support::Profile *Profile = nullptr;
+  /// Function indices by the offsets of their first instructions, which
+  /// identify the functions in the profile.
+  std::unordered_map<uint32_t, uint32_t> ProfileFunctions;
+  /// Value types of globals, including the imported ones.
+  std::vector<llvm::Type *> Globals;
+  /// Layout of SSVM::ExecutionContext.
+  llvm::StructType *ExecCtxTy;
+  llvm::PointerType *ExecCtxPtrTy;
+  llvm::FunctionType *CallTy;
+  llvm::FunctionType *MemGrowTy;
+  llvm::FunctionType *HostCallTy;
+  llvm::StructType *HostBindingTy;
+  llvm::FunctionType *MemInitTy;
+  llvm::FunctionType *DataDropTy;
   llvm::Function *Trap;
   llvm::MDNode *Likely;
+  /// TBAA access tags, separating linear memory, the execution context and
+  /// the values of globals from each other.
+  llvm::MDNode *MemoryTBAA;
+  llvm::MDNode *ContextTBAA;
+  llvm::MDNode *GlobalTBAA;
   uint32_t MemMin = 1, MemMax = 65536;
-  CompileContext(llvm::Module &M)
+  bool HasMemory = false;
+  /// Requested bounds check strategy.
+  BoundsCheck Bounds = BoundsCheck::GuardPage;
+  CompileContext(llvm::Module &M, bool UseHostFeatures)
       : Context(M.getContext()), Module(M),
-        Call(new llvm::GlobalVariable(
-            Module,
-            llvm::FunctionType::get(llvm::Type::getVoidTy(Context),
-                                    {llvm::Type::getInt32Ty(Context),
-                                     llvm::Type::getInt8PtrTy(Context),
-                                     llvm::Type::getInt8PtrTy(Context)},
-                                    false)
-                ->getPointerTo(),
-            true, llvm::GlobalVariable::ExternalLinkage, nullptr, "call")),
-        MemGrow(new llvm::GlobalVariable(
-            Module,
-            llvm::FunctionType::get(llvm::Type::getInt32Ty(Context),
-                                    {llvm::Type::getInt32Ty(Context)}, false)
-                ->getPointerTo(),
-            true, llvm::GlobalVariable::ExternalLinkage, nullptr, "memgrow")),
-        Mem(new llvm::GlobalVariable(Module, llvm::Type::getInt8PtrTy(Context),
-                                     true, llvm::GlobalValue::ExternalLinkage,
-                                     nullptr, "mem")),
-        TrapCode(new llvm::GlobalVariable(
-            Module, llvm::Type::getInt32PtrTy(Context), false,
-            llvm::GlobalValue::ExternalLinkage, nullptr, "code")),
-        InstrCount(new llvm::GlobalVariable(
-            Module, llvm::Type::getInt64Ty(Context), false,
-            llvm::GlobalValue::ExternalLinkage, nullptr, "instr")),
+        ExecCtxTy(llvm::StructType::create(Context, "ExecCtx")),
+        ExecCtxPtrTy(ExecCtxTy->getPointerTo()),
+        CallTy(llvm::FunctionType::get(llvm::Type::getVoidTy(Context),
+                                       {ExecCtxPtrTy,
+                                        llvm::Type::getInt32Ty(Context),
+                                        llvm::Type::getInt8PtrTy(Context),
+                                        llvm::Type::getInt8PtrTy(Context)},
+                                       false)),
+        MemGrowTy(llvm::FunctionType::get(
+            llvm::Type::getInt32Ty(Context),
+            {ExecCtxPtrTy, llvm::Type::getInt32Ty(Context)}, false)),
+        HostCallTy(llvm::FunctionType::get(llvm::Type::getVoidTy(Context),
+                                           {ExecCtxPtrTy,
+                                            llvm::Type::getInt8PtrTy(Context),
+                                            llvm::Type::getInt8PtrTy(Context),
+                                            llvm::Type::getInt8PtrTy(Context)},
+                                           false)),
+        HostBindingTy(llvm::StructType::get(
+            HostCallTy->getPointerTo(), llvm::Type::getInt8PtrTy(Context))),
+        MemInitTy(llvm::FunctionType::get(llvm::Type::getVoidTy(Context),
+                                          {ExecCtxPtrTy,
+                                           llvm::Type::getInt32Ty(Context),
+                                           llvm::Type::getInt32Ty(Context),
+                                           llvm::Type::getInt32Ty(Context),
+                                           llvm::Type::getInt32Ty(Context)},
+                                          false)),
+        DataDropTy(llvm::FunctionType::get(
+            llvm::Type::getVoidTy(Context),
+            {ExecCtxPtrTy, llvm::Type::getInt32Ty(Context)}, false)),
         Trap(llvm::Function::Create(
-            llvm::FunctionType::get(llvm::Type::getVoidTy(Context),
-                                    {llvm::Type::getInt32Ty(Context)}, false),
+            llvm::FunctionType::get(
+                llvm::Type::getVoidTy(Context),
+                {ExecCtxPtrTy, llvm::Type::getInt32Ty(Context)}, false),
             llvm::Function::InternalLinkage, "trap", Module)),
         Likely(llvm::MDTuple::getDistinct(
             Context, {llvm::MDString::get(Context, "branch_weights"),
@@ -124,19 +238,41 @@ struct SSVM::AOT::Compiler::CompileContext {
                           Context, llvm::APInt(32, 2000))),
                       llvm::ConstantAsMetadata::get(llvm::ConstantInt::get(
                           Context, llvm::APInt(32, 0)))})) {
+    /// Keep in sync with SSVM::ExecutionContext.
+    ExecCtxTy->setBody({llvm::Type::getInt8PtrTy(Context),
+                        llvm::Type::getInt8PtrTy(Context)->getPointerTo(),
+                        CallTy->getPointerTo(), MemGrowTy->getPointerTo(),
+                        llvm::Type::getInt8PtrTy(Context),
+                        llvm::Type::getInt32Ty(Context),
+                        llvm::Type::getInt64Ty(Context),
+                        llvm::Type::getInt64Ty(Context),
+                        llvm::Type::getInt64Ty(Context),
+                        llvm::Type::getInt64PtrTy(Context),
+                        llvm::Type::getInt64Ty(Context),
+                        llvm::Type::getInt32PtrTy(Context),
+                        MemInitTy->getPointerTo(),
+                        DataDropTy->getPointerTo(),
+                        llvm::Type::getInt32Ty(Context),
+                        llvm::Type::getInt32Ty(Context),
+                        HostBindingTy->getPointerTo()});
     Trap->addFnAttr(llvm::Attribute::NoReturn);
-    TrapCode->setInitializer(
-        llvm::ConstantPointerNull::get(llvm::Type::getInt32PtrTy(Context)));
-    InstrCount->setInitializer(
-        llvm::ConstantInt::get(InstrCount->getValueType(), 0));
-
-    new llvm::GlobalVariable(
-        Module, llvm::Type::getInt32Ty(Context), true,
-        llvm::GlobalValue::ExternalLinkage,
-        llvm::ConstantInt::get(llvm::Type::getInt32Ty(Context), kVersion),
-        "version");
 
     {
+      llvm::MDBuilder MDB(Context);
+      auto *Root = MDB.createTBAARoot("ssvm tbaa");
+      auto CreateTag = [&MDB, Root](llvm::StringRef Name) {
+        auto *Type = MDB.createTBAAScalarTypeNode(Name, Root);
+        return MDB.createTBAAStructTagNode(Type, Type, 0);
+      };
+      MemoryTBAA = CreateTag("memory");
+      ContextTBAA = CreateTag("context");
+      GlobalTBAA = CreateTag("global");
+    }
+
+    if (!UseHostFeatures) {
+      /// Only the explicitly given features are known for other targets.
+      SupportRoundeven = false;
+    } else {
       llvm::StringMap<bool> FeatureMap;
       llvm::sys::getHostCPUFeatures(FeatureMap);
       for (auto &Feature : FeatureMap) {
@@ -153,6 +289,14 @@ struct SSVM::AOT::Compiler::CompileContext {
             SupportRoundeven = true;
           }
         }
+#if defined(__i386__) || defined(_M_IX86) || defined(__x86_64__) ||            \
+    defined(_M_X64)
+        /// Only the features checked by the loader are enabled, or the code
+        /// is refused at load time.
+        if (!isCheckedCPUFeature(Feature.first())) {
+          continue;
+        }
+#endif
         SubtargetFeatures.AddFeature(Feature.first(), Feature.second);
       }
     }
@@ -161,11 +305,105 @@ struct SSVM::AOT::Compiler::CompileContext {
       /// create trap
       llvm::IRBuilder<> Builder(
           llvm::BasicBlock::Create(Context, "entry", Trap));
-      Builder.CreateStore(Trap->arg_begin(), Builder.CreateLoad(TrapCode));
+      Builder.CreateStore(
+          Trap->arg_begin() + 1,
+          getExecCtxField(Builder, Trap->arg_begin(),
+                          ExecutionContext::Field::TrapCode));
       Builder.CreateIntrinsic(llvm::Intrinsic::trap, {}, {});
       Builder.CreateUnreachable();
     }
   }
+
+  /// Add the target features in the form of "+feature,-feature".
+  void addFeatures(llvm::StringRef Features) {
+    llvm::SmallVector<llvm::StringRef, 16> List;
+    Features.split(List, ',', -1, false);
+    for (auto Feature : List) {
+      Feature = Feature.trim();
+      if (Feature.empty()) {
+        continue;
+      }
+      const std::string Flag =
+          (Feature.front() == '+' || Feature.front() == '-')
+              ? Feature.str()
+              : "+" + Feature.str();
+      SubtargetFeatures.AddFeature(Flag);
+      if (llvm::StringSwitch<bool>(llvm::StringRef(Flag).drop_front())
+#if defined(__i386__) || defined(_M_IX86) || defined(__x86_64__) ||            \
+    defined(_M_X64)
+              .Cases("avx512f", "avx", "sse4.1", true)
+#endif
+#if defined(__arm__) || defined(__aarch64__)
+              .Case("neon", true)
+#endif
+              .Default(false)) {
+        /// Disabling any of them is treated conservatively.
+        SupportRoundeven = Flag.front() == '+';
+      }
+    }
+  }
+
+  /// Get the smallest index of the function types equal to the given one.
+  uint32_t getCanonicalTypeIndex(uint32_t Index) const {
+    for (uint32_t I = 0; I < Index; ++I) {
+      if (*FunctionTypes[I] == *FunctionTypes[Index]) {
+        return I;
+      }
+    }
+    return Index;
+  }
+
+  /// Get the function table, and create it at the first time.
+  ///
+  /// Each entry is the canonical type index and the function pointer of the
+  /// element, or {NullElement, null} for uninitialized elements.
+  llvm::GlobalVariable *getFunctionTable() {
+    if (FunctionTable) {
+      return FunctionTable;
+    }
+    auto *Int32Ty = llvm::Type::getInt32Ty(Context);
+    auto *Int8PtrTy = llvm::Type::getInt8PtrTy(Context);
+    auto *EntryTy = llvm::StructType::get(Int32Ty, Int8PtrTy);
+    std::vector<llvm::Constant *> Entries;
+    Entries.reserve(Elements.size());
+    for (const auto FuncIdx : Elements) {
+      if (FuncIdx == NullElement) {
+        Entries.push_back(llvm::ConstantStruct::get(
+            EntryTy, {llvm::ConstantInt::get(Int32Ty, NullElement),
+                      llvm::ConstantPointerNull::get(Int8PtrTy)}));
+      } else {
+        const auto TypeIdx = std::get<0>(Functions[FuncIdx]);
+        auto *Function = std::get<1>(Functions[FuncIdx]);
+        Entries.push_back(llvm::ConstantStruct::get(
+            EntryTy,
+            {llvm::ConstantInt::get(Int32Ty, getCanonicalTypeIndex(TypeIdx)),
+             llvm::ConstantExpr::getBitCast(Function, Int8PtrTy)}));
+      }
+    }
+    auto *TableTy = llvm::ArrayType::get(EntryTy, Entries.size());
+    FunctionTable = new llvm::GlobalVariable(
+        Module, TableTy, true, llvm::GlobalValue::InternalLinkage,
+        llvm::ConstantArray::get(TableTy, Entries), "table");
+    return FunctionTable;
+  }
+
+  /// Get the address of a field in the execution context.
+  llvm::Value *getExecCtxField(llvm::IRBuilder<> &Builder,
+                               llvm::Value *ExecCtx,
+                               ExecutionContext::Field Field) const {
+    return Builder.CreateStructGEP(ExecCtxTy, ExecCtx,
+                                   static_cast<uint32_t>(Field));
+  }
+
+  /// Get the bounds check strategy of the compiled code. Masking falls back
+  /// to explicit checks unless the memory size is a fixed power of two.
+  BoundsCheck getBoundsCheck() const {
+    if (Bounds == BoundsCheck::Mask &&
+        !(HasMemory && MemMin == MemMax && llvm::isPowerOf2_32(MemMin))) {
+      return BoundsCheck::Explicit;
+    }
+    return Bounds;
+  }
 };
 
 namespace {
@@ -204,9 +442,11 @@ toLLVMTypeVector(llvm::LLVMContext &Context, Span<const ValType> ValTypes) {
   return Result;
 }
 
-static std::vector<llvm::Type *> toLLVMArgsType(llvm::LLVMContext &Context,
+static std::vector<llvm::Type *> toLLVMArgsType(llvm::PointerType *ExecCtxPtrTy,
                                                 Span<const ValType> ValTypes) {
-  return toLLVMTypeVector(Context, ValTypes);
+  auto Result = toLLVMTypeVector(ExecCtxPtrTy->getContext(), ValTypes);
+  Result.insert(Result.begin(), ExecCtxPtrTy);
+  return Result;
 }
 
 static llvm::Type *toLLVMRetsType(llvm::LLVMContext &Context,
@@ -225,9 +465,10 @@ static llvm::Type *toLLVMRetsType(llvm::LLVMContext &Context,
   return llvm::StructType::create(Result);
 }
 
-static llvm::FunctionType *toLLVMType(llvm::LLVMContext &Context,
+static llvm::FunctionType *toLLVMType(llvm::PointerType *ExecCtxPtrTy,
                                       const AST::FunctionType &FuncType) {
-  auto ArgsTy = toLLVMArgsType(Context, FuncType.getParamTypes());
+  auto &Context = ExecCtxPtrTy->getContext();
+  auto ArgsTy = toLLVMArgsType(ExecCtxPtrTy, FuncType.getParamTypes());
   auto RetTy = toLLVMRetsType(Context, FuncType.getReturnTypes());
   return llvm::FunctionType::get(RetTy, ArgsTy, false);
 }
@@ -257,7 +498,7 @@ public:
         Builder(llvm::BasicBlock::Create(VMContext, "entry", F)) {
     if (F) {
       Builder.setIsFPConstrained(true);
-      Builder.setDefaultConstrainedRounding(RoundingMode::rmToNearest);
+      Builder.setDefaultConstrainedRounding(kRoundToNearest);
       Builder.setDefaultConstrainedExcept(ExceptionBehavior::ebIgnore);
 
       if (CalculateInstrCount) {
@@ -265,7 +506,21 @@ public:
         Builder.CreateStore(Builder.getInt64(0), LocalInstrCount);
       }
 
-      for (llvm::Argument *Arg = F->arg_begin(); Arg != F->arg_end(); ++Arg) {
+      if (!Context.CostTable.empty()) {
+        LocalGas = Builder.CreateAlloca(Builder.getInt64Ty());
+        Builder.CreateStore(Builder.getInt64(0), LocalGas);
+      }
+
+      /// The first argument is the execution context.
+      ExecCtx = F->arg_begin();
+      LocalMemory = Builder.CreateAlloca(Builder.getInt8PtrTy());
+      if (Context.HasMemory &&
+          Context.getBoundsCheck() == BoundsCheck::Explicit) {
+        LocalMemorySize = Builder.CreateAlloca(Builder.getInt64Ty());
+      }
+      updateMemory();
+      for (llvm::Argument *Arg = F->arg_begin() + 1; Arg != F->arg_end();
+           ++Arg) {
         llvm::Value *ArgPtr = Builder.CreateAlloca(Arg->getType());
         Builder.CreateStore(Arg, ArgPtr);
         Local.push_back(ArgPtr);
@@ -276,6 +531,22 @@ public:
         Builder.CreateStore(toLLVMConstantZero(VMContext, Type), ArgPtr);
         Local.push_back(ArgPtr);
       }
+
+      /// Count the call depth after all allocas, which should stay in the
+      /// entry block.
+      CallDepth = loadExecCtxField(ExecutionContext::Field::CallDepth);
+      auto *DepthOkBB = llvm::BasicBlock::Create(VMContext, "depth.ok", F);
+      Builder.CreateCondBr(
+          Builder.CreateICmpULT(
+              CallDepth,
+              loadExecCtxField(ExecutionContext::Field::CallDepthLimit)),
+          DepthOkBB, getTrapBB(ErrCode::CallStackExhausted), Context.Likely);
+      Builder.SetInsertPoint(DepthOkBB);
+      storeExecCtxField(Builder.CreateAdd(CallDepth, Builder.getInt32(1)),
+                        ExecutionContext::Field::CallDepth);
+
+      /// Recursion without loops should be interruptible as well.
+      checkInterrupted();
     }
   }
 
@@ -314,7 +585,8 @@ public:
     for (auto &[Error, BB] : TrapBB) {
       Builder.SetInsertPoint(BB);
       updateInstrCount();
-      Builder.CreateCall(Context.Trap, {Builder.getInt32(uint32_t(Error))});
+      Builder.CreateCall(Context.Trap,
+                         {ExecCtx, Builder.getInt32(uint32_t(Error))});
       Builder.CreateUnreachable();
     }
 
@@ -339,10 +611,22 @@ public:
               /// Make the instruction node according to Code.
               if (LocalInstrCount) {
                 Builder.CreateStore(
-                    Builder.CreateAdd(Builder.CreateLoad(LocalInstrCount),
+                    Builder.CreateAdd(createLoad(Builder, LocalInstrCount),
                                       Builder.getInt64(1)),
                     LocalInstrCount);
               }
+              if (LocalGas) {
+                const auto Code = uint16_t(Instr->getOpCode());
+                const uint64_t Cost = Code < Context.CostTable.size()
+                                          ? Context.CostTable[Code]
+                                          : 0;
+                if (Cost != 0) {
+                  Builder.CreateStore(
+                      Builder.CreateAdd(createLoad(Builder, LocalGas),
+                                        Builder.getInt64(Cost)),
+                      LocalGas);
+                }
+              }
               if (auto Status = compile(
                       *static_cast<
                           const typename std::decay_t<decltype(Arg)>::type *>(
@@ -399,6 +683,9 @@ public:
 
       enterBlock(Loop, false, Instr.getBlockType());
       Builder.SetInsertPoint(Loop);
+      /// Check the cost and the epoch deadline at every back-edge.
+      updateGas();
+      checkInterrupted();
       compile(Instr.getBody());
       buildPHI(resolveBlockType(Instr.getBlockType()).second,
                leaveBlock(EndLoop));
@@ -426,7 +713,8 @@ public:
         Args[J] = stackPop();
       }
 
-      Builder.CreateCondBr(Cond, Then, Else);
+      Builder.CreateCondBr(Cond, Then, Else,
+                           getBranchWeights(Instr.getOffset()));
 
       for (auto *Value : Args) {
         stackPush(Value);
@@ -474,7 +762,8 @@ public:
       }
       llvm::BasicBlock *Next =
           llvm::BasicBlock::Create(VMContext, "br_if.end", F);
-      Builder.CreateCondBr(Cond, getLabel(Label), Next);
+      Builder.CreateCondBr(Cond, getLabel(Label), Next,
+                           getBranchWeights(Instr.getOffset()));
       Builder.SetInsertPoint(Next);
       break;
     }
@@ -510,11 +799,12 @@ public:
   }
   Expect<void> compile(const AST::CallControlInstruction &Instr) {
     updateInstrCount();
+    updateGas();
     switch (Instr.getOpCode()) {
     case OpCode::Call:
       return compileCallOp(Instr.getFuncIndex());
     case OpCode::Call_indirect: {
-      return compileIndirectCallOp(Instr.getFuncIndex());
+      return compileIndirectCallOp(Instr.getFuncIndex(), Instr.getOffset());
     }
     default:
       __builtin_unreachable();
@@ -545,7 +835,7 @@ public:
     /// Check OpCode and run the specific instruction.
     switch (Instr.getOpCode()) {
     case OpCode::Local__get:
-      stackPush(Builder.CreateLoad(Local[Index]));
+      stackPush(createLoad(Builder, Local[Index]));
       break;
     case OpCode::Local__set:
       Builder.CreateStore(stackPop(), Local[Index]);
@@ -553,18 +843,27 @@ public:
     case OpCode::Local__tee:
       Builder.CreateStore(Stack.back(), Local[Index]);
       break;
-    case OpCode::Global__get:
+    case OpCode::Global__get: {
       if (Index >= Context.Globals.size()) {
         return Unexpect(ErrCode::InvalidGlobalIdx);
       }
-      stackPush(Builder.CreateLoad(Context.Globals[Index]));
+      if (!ExecCtx) {
+        /// Globals are only accessible at runtime.
+        return Unexpect(ErrCode::ConstExprRequired);
+      }
+      auto *Load = createLoad(Builder, getGlobalPtr(Index));
+      Load->setMetadata(llvm::LLVMContext::MD_tbaa, Context.GlobalTBAA);
+      stackPush(Load);
       break;
-    case OpCode::Global__set:
+    }
+    case OpCode::Global__set: {
       if (Index >= Context.Globals.size()) {
         return Unexpect(ErrCode::InvalidGlobalIdx);
       }
-      Builder.CreateStore(stackPop(), Context.Globals[Index]);
+      auto *Store = Builder.CreateStore(stackPop(), getGlobalPtr(Index));
+      Store->setMetadata(llvm::LLVMContext::MD_tbaa, Context.GlobalTBAA);
       break;
+    }
     default:
       __builtin_unreachable();
     }
@@ -640,16 +939,49 @@ public:
       return compileStoreOp(Instr.getMemoryOffset(), Instr.getMemoryAlign(),
                             Builder.getInt32Ty(), true);
     case OpCode::Memory__size:
-      stackPush(Builder.CreateCall(Builder.CreateLoad(Context.MemGrow),
-                                   {Builder.getInt32(0)}));
+      stackPush(
+          createCall(Builder, getMemGrow(), {ExecCtx, Builder.getInt32(0)}));
       break;
     case OpCode::Memory__grow: {
       auto *Diff = stackPop();
-      auto *Result =
-          Builder.CreateCall(Builder.CreateLoad(Context.MemGrow), {Diff});
+      auto *Result = createCall(Builder, getMemGrow(), {ExecCtx, Diff});
+      updateMemory();
       stackPush(Result);
       break;
     }
+    case OpCode::Memory__init: {
+      auto *Len = stackPop();
+      auto *Src = stackPop();
+      auto *Dst = stackPop();
+      createCall(Builder, loadExecCtxField(ExecutionContext::Field::MemInit),
+                         {ExecCtx, Builder.getInt32(Instr.getDataIndex()), Dst,
+                          Src, Len});
+      break;
+    }
+    case OpCode::Data__drop:
+      createCall(Builder, loadExecCtxField(ExecutionContext::Field::DataDrop),
+                         {ExecCtx, Builder.getInt32(Instr.getDataIndex())});
+      break;
+    case OpCode::Memory__copy: {
+      auto *Len = Builder.CreateZExt(stackPop(), Builder.getInt64Ty());
+      auto *Src = Builder.CreateZExt(stackPop(), Builder.getInt64Ty());
+      auto *Dst = Builder.CreateZExt(stackPop(), Builder.getInt64Ty());
+      compileBulkBound({Src, Dst}, Len);
+      auto *Memory = getMemory();
+      Builder.CreateMemMove(createInBoundsGEP(Builder, Memory, {Dst}), Align(1),
+                            createInBoundsGEP(Builder, Memory, {Src}), Align(1),
+                            Len);
+      break;
+    }
+    case OpCode::Memory__fill: {
+      auto *Len = Builder.CreateZExt(stackPop(), Builder.getInt64Ty());
+      auto *Val = Builder.CreateTrunc(stackPop(), Builder.getInt8Ty());
+      auto *Dst = Builder.CreateZExt(stackPop(), Builder.getInt64Ty());
+      compileBulkBound({Dst}, Len);
+      Builder.CreateMemSet(createInBoundsGEP(Builder, getMemory(), {Dst}), Val,
+                           Len, Align(1));
+      break;
+    }
     default:
       __builtin_unreachable();
     }
@@ -739,8 +1071,13 @@ public:
     defined(_M_X64)
 
       if (Context.SupportRoundeven) {
+#if LLVM_VERSION_MAJOR >= 11
+        llvm::Value *Ret = llvm::UndefValue::get(
+            llvm::FixedVectorType::get(Value->getType(), VectorSize));
+#else
         llvm::Value *Ret = llvm::UndefValue::get(
             llvm::VectorType::get(Value->getType(), VectorSize));
+#endif
         Ret = Builder.CreateInsertElement(Ret, Value, UINT64_C(0));
         if (IsFloat) {
           Ret = Builder.CreateIntrinsic(llvm::Intrinsic::x86_sse41_round_ss, {},
@@ -757,8 +1094,13 @@ public:
 
 #if defined(__arm__) || defined(__aarch64__)
       if (Context.SupportRoundeven) {
+#if LLVM_VERSION_MAJOR >= 11
+        llvm::Value *Ret = llvm::UndefValue::get(
+            llvm::FixedVectorType::get(Value->getType(), VectorSize));
+#else
         llvm::Value *Ret = llvm::UndefValue::get(
             llvm::VectorType::get(Value->getType(), VectorSize));
+#endif
         Ret = Builder.CreateInsertElement(Ret, Value, UINT64_C(0));
         Ret = Builder.CreateBinaryIntrinsic(
             llvm::Intrinsic::aarch64_neon_frintn, Ret, Ret);
@@ -1367,6 +1709,8 @@ public:
 
   void compileReturn() {
     updateInstrCount();
+    updateGas();
+    storeExecCtxField(CallDepth, ExecutionContext::Field::CallDepth);
     auto *Ty = F->getReturnType();
     if (Ty->isVoidTy()) {
       Builder.CreateRetVoid();
@@ -1385,14 +1729,50 @@ public:
 
   void updateInstrCount() {
     if (LocalInstrCount) {
-      Builder.CreateStore(
-          Builder.CreateAdd(Builder.CreateLoad(LocalInstrCount),
-                            Builder.CreateLoad(Context.InstrCount)),
-          Context.InstrCount);
+      storeExecCtxField(
+          Builder.CreateAdd(
+              createLoad(Builder, LocalInstrCount),
+              loadExecCtxField(ExecutionContext::Field::InstrCount)),
+          ExecutionContext::Field::InstrCount);
       Builder.CreateStore(Builder.getInt64(0), LocalInstrCount);
     }
   }
 
+  /// Add the accumulated cost into the execution context, and trap if the
+  /// cost limit is exceeded.
+  void updateGas() {
+    if (LocalGas) {
+      auto *CostLimit = loadExecCtxField(ExecutionContext::Field::CostLimit);
+      auto *NewCost =
+          Builder.CreateAdd(loadExecCtxField(ExecutionContext::Field::CostSum),
+                            createLoad(Builder, LocalGas));
+      Builder.CreateStore(Builder.getInt64(0), LocalGas);
+      auto *OkBB = llvm::BasicBlock::Create(VMContext, "gas.ok", F);
+      Builder.CreateCondBr(Builder.CreateICmpULE(NewCost, CostLimit), OkBB,
+                           getTrapBB(ErrCode::CostLimitExceeded),
+                           Context.Likely);
+      Builder.SetInsertPoint(OkBB);
+      storeExecCtxField(NewCost, ExecutionContext::Field::CostSum);
+    }
+  }
+
+  /// Trap if the epoch counter in the execution context reaches the deadline.
+  void checkInterrupted() {
+    if (Context.Interruptible) {
+      auto *Epoch = createLoad(
+          Builder, loadExecCtxField(ExecutionContext::Field::Epoch));
+      Epoch->setAtomic(llvm::AtomicOrdering::Monotonic);
+      Epoch->setAlignment(Align(8));
+      Epoch->setMetadata(llvm::LLVMContext::MD_tbaa, Context.ContextTBAA);
+      auto *Deadline =
+          loadExecCtxField(ExecutionContext::Field::EpochDeadline);
+      auto *OkBB = llvm::BasicBlock::Create(VMContext, "epoch.ok", F);
+      Builder.CreateCondBr(Builder.CreateICmpULT(Epoch, Deadline), OkBB,
+                           getTrapBB(ErrCode::Interrupted), Context.Likely);
+      Builder.SetInsertPoint(OkBB);
+    }
+  }
+
   static Expect<llvm::Constant *>
   evaluate(const AST::InstrVec &Instrs,
            AOT::Compiler::CompileContext &Context) {
@@ -1416,13 +1796,15 @@ private:
     const auto &Function = std::get<1>(Context.Functions[FuncIndex]);
     const auto &ParamTypes = FuncType.getParamTypes();
 
-    std::vector<llvm::Value *> Args(ParamTypes.size());
+    std::vector<llvm::Value *> Args(ParamTypes.size() + 1);
     for (size_t I = 0; I < ParamTypes.size(); ++I) {
-      const size_t J = ParamTypes.size() - 1 - I;
+      const size_t J = ParamTypes.size() - I;
       Args[J] = stackPop();
     }
+    Args[0] = ExecCtx;
 
     auto *Ret = Builder.CreateCall(Function, Args);
+    updateMemory();
     auto *Ty = Ret->getType();
     if (Ty->isVoidTy()) {
       // nothing to do
@@ -1437,55 +1819,147 @@ private:
     return {};
   }
 
-  Expect<void> compileIndirectCallOp(const unsigned int FuncTypeIndex) {
+  /// Get the branch weights of the conditional branch from the profile, or
+  /// nullptr if not profiled.
+  llvm::MDNode *getBranchWeights(uint32_t Offset) const {
+    if (!Context.Profile) {
+      return nullptr;
+    }
+    if (const auto *Count = Context.Profile->getBranchCount(Offset)) {
+      return toBranchWeights(VMContext, Count->Taken, Count->NotTaken);
+    }
+    return nullptr;
+  }
+
+  /// Get the target function called by the most of the executions of the
+  /// `call_indirect` in the profile, and the counts of calls to it and to
+  /// the others.
+  std::tuple<llvm::Function *, uint64_t, uint64_t>
+  getDominantTarget(uint32_t Offset, llvm::FunctionType *FTy) const {
+    if (!Context.Profile) {
+      return {nullptr, 0, 0};
+    }
+    const auto *Targets = Context.Profile->getIndirectCalls(Offset);
+    if (!Targets) {
+      return {nullptr, 0, 0};
+    }
+    uint32_t Target = 0;
+    uint64_t Count = 0, Total = 0;
+    for (const auto &[FuncOffset, N] : *Targets) {
+      Total += N;
+      if (N > Count) {
+        Target = FuncOffset;
+        Count = N;
+      }
+    }
+    /// Only promote the target taking more than half of the calls.
+    if (Count <= Total - Count) {
+      return {nullptr, 0, 0};
+    }
+    auto It = Context.ProfileFunctions.find(Target);
+    if (It == Context.ProfileFunctions.end()) {
+      return {nullptr, 0, 0};
+    }
+    auto *Function = std::get<1>(Context.Functions[It->second]);
+    if (Function->getFunctionType() != FTy) {
+      return {nullptr, 0, 0};
+    }
+    return {Function, Count, Total - Count};
+  }
+
+  Expect<void> compileIndirectCallOp(const unsigned int FuncTypeIndex,
+                                     const uint32_t Offset) {
     llvm::Value *Value = stackPop();
     const auto &FuncType = *Context.FunctionTypes[FuncTypeIndex];
     const auto &ParamTypes = FuncType.getParamTypes();
-    std::vector<llvm::Value *> Args(ParamTypes.size());
+    std::vector<llvm::Value *> Args(ParamTypes.size() + 1);
     for (size_t I = 0; I < ParamTypes.size(); ++I) {
-      const size_t J = ParamTypes.size() - 1 - I;
+      const size_t J = ParamTypes.size() - I;
       Args[J] = stackPop();
     }
+    Args[0] = ExecCtx;
 
-    std::vector<std::pair<size_t, llvm::Function *>> Table;
-    for (uint32_t I = 0; I < Context.Elements.size(); ++I) {
-      const auto FuncIdx = Context.Elements[I];
-      const auto FuncTypeIndex2 = std::get<0>(Context.Functions[FuncIdx]);
-      const auto &FuncType2 = *Context.FunctionTypes[FuncTypeIndex2];
-      if (FuncTypeIndex == FuncTypeIndex2 || FuncType == FuncType2) {
-        Table.emplace_back(I, std::get<1>(Context.Functions[FuncIdx]));
+    /// Check the table bounds.
+    auto *Table = Context.getFunctionTable();
+    auto *InBoundBB =
+        llvm::BasicBlock::Create(VMContext, "call_indirect.in_bound", F);
+    Builder.CreateCondBr(
+        Builder.CreateICmpULT(Value,
+                              Builder.getInt32(Context.Elements.size())),
+        InBoundBB, getTrapBB(ErrCode::UndefinedElement), Context.Likely);
+    Builder.SetInsertPoint(InBoundBB);
+
+    /// Check the type index of the entry, and distinguish uninitialized
+    /// elements from mismatched types only on the failure path.
+    auto *Index = Builder.CreateZExt(Value, Builder.getInt64Ty());
+    auto *TypeIdx = createLoad(
+        Builder,
+        createInBoundsGEP(Builder, Table,
+                          {Builder.getInt64(0), Index, Builder.getInt32(0)}));
+    auto *TypeOKBB =
+        llvm::BasicBlock::Create(VMContext, "call_indirect.type_ok", F);
+    auto *MismatchBB =
+        llvm::BasicBlock::Create(VMContext, "call_indirect.mismatch", F);
+    Builder.CreateCondBr(
+        Builder.CreateICmpEQ(
+            TypeIdx,
+            Builder.getInt32(Context.getCanonicalTypeIndex(FuncTypeIndex))),
+        TypeOKBB, MismatchBB, Context.Likely);
+    Builder.SetInsertPoint(MismatchBB);
+    Builder.CreateCondBr(
+        Builder.CreateICmpEQ(TypeIdx, Builder.getInt32(NullElement)),
+        getTrapBB(ErrCode::UninitializedElement),
+        getTrapBB(ErrCode::IndirectCallTypeMismatch));
+    Builder.SetInsertPoint(TypeOKBB);
+
+    /// Call the function pointer.
+    auto *FTy = toLLVMType(Context.ExecCtxPtrTy, FuncType);
+    auto *FPtr = createLoad(
+        Builder,
+        createInBoundsGEP(Builder, Table,
+                          {Builder.getInt64(0), Index, Builder.getInt32(1)}));
+    llvm::Value *Ret;
+    if (auto [Target, Count, Others] = getDominantTarget(Offset, FTy); Target) {
+      /// Call the dominant target in the profile directly, which can be
+      /// inlined, and the others through the function pointer.
+      auto *DirectBB =
+          llvm::BasicBlock::Create(VMContext, "call_indirect.direct", F);
+      auto *IndirectBB =
+          llvm::BasicBlock::Create(VMContext, "call_indirect.indirect", F);
+      auto *EndBB = llvm::BasicBlock::Create(VMContext, "call_indirect.end", F);
+      Builder.CreateCondBr(
+          Builder.CreateICmpEQ(
+              FPtr, Builder.CreateBitCast(Target, Builder.getInt8PtrTy())),
+          DirectBB, IndirectBB, toBranchWeights(VMContext, Count, Others));
+      Builder.SetInsertPoint(DirectBB);
+      auto *DirectRet = Builder.CreateCall(Target, Args);
+      Builder.CreateBr(EndBB);
+      Builder.SetInsertPoint(IndirectBB);
+      auto *IndirectRet = Builder.CreateCall(
+          FTy, Builder.CreateBitCast(FPtr, FTy->getPointerTo()), Args);
+      Builder.CreateBr(EndBB);
+      Builder.SetInsertPoint(EndBB);
+      if (FTy->getReturnType()->isVoidTy()) {
+        Ret = DirectRet;
+      } else {
+        auto *PHIRet = Builder.CreatePHI(FTy->getReturnType(), 2);
+        PHIRet->addIncoming(DirectRet, DirectBB);
+        PHIRet->addIncoming(IndirectRet, IndirectBB);
+        Ret = PHIRet;
       }
+    } else {
+      Ret = Builder.CreateCall(
+          FTy, Builder.CreateBitCast(FPtr, FTy->getPointerTo()), Args);
     }
-    auto *OKBB = llvm::BasicBlock::Create(VMContext, "call_indirect.end", F);
-    auto *Switch = Builder.CreateSwitch(
-        Value, getTrapBB(ErrCode::UndefinedElement), Table.size());
-
-    const bool HasReturnValue = !isVoidReturn(FuncType.getReturnTypes());
-    const bool HasMultipleValule = FuncType.getReturnTypes().size() > 1;
-    std::vector<std::tuple<std::vector<llvm::Value *>, llvm::BasicBlock *>>
-        ReturnValues;
-    if (HasReturnValue) {
-      ReturnValues.reserve(Table.size());
-    }
-
-    for (const auto &[Value, Function] : Table) {
-      auto *Entry = llvm::BasicBlock::Create(
-          VMContext, "call_indirect." + std::to_string(Value), F);
-      Builder.SetInsertPoint(Entry);
-
-      auto *Ret = Builder.CreateCall(Function, Args);
-      if (HasMultipleValule) {
-        ReturnValues.emplace_back(unpackStruct(Builder, Ret), Entry);
-      } else if (HasReturnValue) {
-        ReturnValues.emplace_back(std::vector<llvm::Value *>{Ret}, Entry);
+    updateMemory();
+    if (Ret->getType()->isVoidTy()) {
+      // nothing to do
+    } else if (Ret->getType()->isStructTy()) {
+      for (auto *Val : unpackStruct(Builder, Ret)) {
+        stackPush(Val);
       }
-      Builder.CreateBr(OKBB);
-      Switch->addCase(Builder.getInt32(Value), Entry);
-    }
-
-    Builder.SetInsertPoint(OKBB);
-    if (HasReturnValue) {
-      buildPHI(FuncType.getReturnTypes(), ReturnValues);
+    } else {
+      stackPush(Ret);
     }
 
     return {};
@@ -1493,16 +1967,12 @@ private:
 
   Expect<void> compileLoadOp(unsigned Offset, unsigned Alignment,
                              llvm::Type *LoadTy) {
-    auto *Off = Builder.CreateZExt(stackPop(), Builder.getInt64Ty());
-    if (Offset != 0) {
-      Off = Builder.CreateAdd(Off, Builder.getInt64(Offset));
-    }
-
-    auto *VPtr =
-        Builder.CreateInBoundsGEP(Builder.CreateLoad(Context.Mem), {Off});
+    auto *Off = compileAddress(stackPop(), Offset, LoadTy);
+    auto *VPtr = createInBoundsGEP(Builder, getMemory(), {Off});
     auto *Ptr = Builder.CreateBitCast(VPtr, LoadTy->getPointerTo());
-    auto *LoadInst = Builder.CreateLoad(Ptr);
+    auto *LoadInst = createLoad(Builder, Ptr);
     LoadInst->setAlignment(Align(UINT64_C(1) << Alignment));
+    LoadInst->setMetadata(llvm::LLVMContext::MD_tbaa, Context.MemoryTBAA);
     stackPush(LoadInst);
     return {};
   }
@@ -1522,22 +1992,74 @@ private:
   Expect<void> compileStoreOp(unsigned Offset, unsigned Alignment,
                               llvm::Type *LoadTy, bool Trunc = false) {
     auto *V = stackPop();
-    auto *Off = Builder.CreateZExt(stackPop(), Builder.getInt64Ty());
-    if (Offset != 0) {
-      Off = Builder.CreateAdd(Off, Builder.getInt64(Offset));
-    }
-
+    auto *Off = compileAddress(stackPop(), Offset, LoadTy);
     if (Trunc) {
       V = Builder.CreateTrunc(V, LoadTy);
     }
-    auto *VPtr =
-        Builder.CreateInBoundsGEP(Builder.CreateLoad(Context.Mem), {Off});
+    auto *VPtr = createInBoundsGEP(Builder, getMemory(), {Off});
     auto *Ptr = Builder.CreateBitCast(VPtr, LoadTy->getPointerTo());
     auto *StoreInst = Builder.CreateStore(V, Ptr);
     StoreInst->setAlignment(Align(UINT64_C(1) << Alignment));
+    StoreInst->setMetadata(llvm::LLVMContext::MD_tbaa, Context.MemoryTBAA);
     return {};
   }
 
+  /// Compute the offset in memory of an access, and check the bounds by the
+  /// strategy. Guard pages need no checks, since the offset is less than 8 GiB.
+  llvm::Value *compileAddress(llvm::Value *Addr, unsigned Offset,
+                              llvm::Type *AccessTy) {
+    auto *Off = Builder.CreateZExt(Addr, Builder.getInt64Ty());
+    if (Offset != 0) {
+      Off = Builder.CreateAdd(Off, Builder.getInt64(Offset));
+    }
+    switch (Context.getBoundsCheck()) {
+    case BoundsCheck::GuardPage:
+      break;
+    case BoundsCheck::Explicit: {
+      const uint64_t Size = AccessTy->getPrimitiveSizeInBits() / 8;
+      auto *End = Builder.CreateAdd(Off, Builder.getInt64(Size));
+      auto *OkBB = llvm::BasicBlock::Create(VMContext, "mem.ok", F);
+      Builder.CreateCondBr(
+          Builder.CreateICmpULE(End, createLoad(Builder, LocalMemorySize)),
+          OkBB, getTrapBB(ErrCode::MemoryOutOfBounds), Context.Likely);
+      Builder.SetInsertPoint(OkBB);
+      break;
+    }
+    case BoundsCheck::Mask:
+      /// The accesses crossing the end hit the guard page after memory.
+      Off = Builder.CreateAnd(
+          Off, Builder.getInt64(uint64_t(Context.MemMin) * kPageSize - 1));
+      break;
+    }
+    return Off;
+  }
+
+  /// Check the bounds of bulk memory accesses of the same length, whatever
+  /// the strategy is, since they must trap before writing anything. The
+  /// accesses are lowered to the memmove and memset intrinsics afterwards.
+  void compileBulkBound(std::initializer_list<llvm::Value *> Offsets,
+                        llvm::Value *Len) {
+    llvm::Value *Size = nullptr;
+    if (LocalMemorySize) {
+      Size = createLoad(Builder, LocalMemorySize);
+    } else {
+      auto *Pages = createLoad(
+          Builder, loadExecCtxField(ExecutionContext::Field::MemoryPages));
+      Pages->setMetadata(llvm::LLVMContext::MD_tbaa, Context.ContextTBAA);
+      Size = Builder.CreateMul(Builder.CreateZExt(Pages, Builder.getInt64Ty()),
+                               Builder.getInt64(kPageSize));
+    }
+    llvm::Value *InBound = Builder.getTrue();
+    for (auto *Off : Offsets) {
+      InBound = Builder.CreateAnd(
+          InBound, Builder.CreateICmpULE(Builder.CreateAdd(Off, Len), Size));
+    }
+    auto *OkBB = llvm::BasicBlock::Create(VMContext, "mem.ok", F);
+    Builder.CreateCondBr(InBound, OkBB, getTrapBB(ErrCode::MemoryOutOfBounds),
+                         Context.Likely);
+    Builder.SetInsertPoint(OkBB);
+  }
+
   std::pair<std::vector<ValType>, std::vector<ValType>>
   resolveBlockType(const BlockType &ResultType) const {
     using VecT = std::vector<ValType>;
@@ -1656,6 +2178,66 @@ private:
     return std::get<kJumpBlock>(*(ControlStack.rbegin() + Index));
   }
 
+  /// Load a field of the execution context.
+  llvm::LoadInst *loadExecCtxField(ExecutionContext::Field Field) {
+    auto *Load =
+        createLoad(Builder, Context.getExecCtxField(Builder, ExecCtx, Field));
+    Load->setMetadata(llvm::LLVMContext::MD_tbaa, Context.ContextTBAA);
+    return Load;
+  }
+
+  /// Store a field of the execution context.
+  void storeExecCtxField(llvm::Value *Value, ExecutionContext::Field Field) {
+    auto *Store = Builder.CreateStore(
+        Value, Context.getExecCtxField(Builder, ExecCtx, Field));
+    Store->setMetadata(llvm::LLVMContext::MD_tbaa, Context.ContextTBAA);
+  }
+
+  /// Get the base address of linear memory.
+  ///
+  /// The base is kept in a local slot and only reloaded from the execution
+  /// context after calls and memory.grow, so that it can be promoted to a
+  /// register and hoisted out of loops.
+  llvm::Value *getMemory() {
+    if (LocalMemory) {
+      return createLoad(Builder, LocalMemory);
+    }
+    return loadExecCtxField(ExecutionContext::Field::Memory);
+  }
+
+  /// Reload the base address of linear memory into the local slot, and the
+  /// memory size in bytes for explicit bounds checks.
+  void updateMemory() {
+    if (LocalMemory) {
+      Builder.CreateStore(loadExecCtxField(ExecutionContext::Field::Memory),
+                          LocalMemory);
+    }
+    if (LocalMemorySize) {
+      auto *Pages = createLoad(
+          Builder, loadExecCtxField(ExecutionContext::Field::MemoryPages));
+      Pages->setMetadata(llvm::LLVMContext::MD_tbaa, Context.ContextTBAA);
+      Builder.CreateStore(
+          Builder.CreateMul(Builder.CreateZExt(Pages, Builder.getInt64Ty()),
+                            Builder.getInt64(kPageSize)),
+          LocalMemorySize);
+    }
+  }
+
+  /// Load the memory.grow trampoline from the execution context.
+  llvm::Value *getMemGrow() {
+    return loadExecCtxField(ExecutionContext::Field::MemGrow);
+  }
+
+  /// Get the typed address of a global from the execution context.
+  llvm::Value *getGlobalPtr(unsigned int Index) {
+    auto *Globals = loadExecCtxField(ExecutionContext::Field::Globals);
+    auto *Ptr = createLoad(Builder,
+                           createConstInBoundsGEP1_64(Builder, Globals, Index));
+    Ptr->setMetadata(llvm::LLVMContext::MD_tbaa, Context.ContextTBAA);
+    return Builder.CreateBitCast(Ptr,
+                                 Context.Globals[Index]->getPointerTo());
+  }
+
   void stackPush(llvm::Value *Value) { Stack.push_back(Value); }
   llvm::Value *stackPop() {
     assert(!ControlStack.empty() || !Stack.empty());
@@ -1670,7 +2252,12 @@ private:
   llvm::LLVMContext &VMContext;
   std::vector<llvm::Value *> Local;
   std::vector<llvm::Value *> Stack;
+  llvm::Value *ExecCtx = nullptr;
+  llvm::Value *CallDepth = nullptr;
   llvm::Value *LocalInstrCount = nullptr;
+  llvm::Value *LocalGas = nullptr;
+  llvm::Value *LocalMemory = nullptr;
+  llvm::Value *LocalMemorySize = nullptr;
   std::unordered_map<ErrCode, llvm::BasicBlock *> TrapBB;
   bool IsUnreachable = false;
   static inline constexpr size_t kStackSize = 0;
@@ -1697,277 +2284,1072 @@ static std::vector<llvm::Value *> unpackStruct(llvm::IRBuilder<> &Builder,
   return Ret;
 }
 
-} // namespace
+using OptimizationLevel = SSVM::AOT::Compiler::OptimizationLevel;
 
-namespace SSVM {
-namespace AOT {
+static llvm::CodeGenOpt::Level toCodeGenLevel(OptimizationLevel Level) {
+  switch (Level) {
+  case OptimizationLevel::O0:
+    return llvm::CodeGenOpt::None;
+  case OptimizationLevel::O1:
+    return llvm::CodeGenOpt::Less;
+  case OptimizationLevel::O3:
+    return llvm::CodeGenOpt::Aggressive;
+  default:
+    return llvm::CodeGenOpt::Default;
+  }
+}
 
-Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
-                               std::string_view OutputPath) {
-  namespace fs = std::filesystem;
-  using namespace std::literals;
+static const char *toString(OptimizationLevel Level) {
+  switch (Level) {
+  case OptimizationLevel::O0:
+    return "O0";
+  case OptimizationLevel::O1:
+    return "O1";
+  case OptimizationLevel::O2:
+    return "O2";
+  case OptimizationLevel::O3:
+    return "O3";
+  case OptimizationLevel::Os:
+    return "Os";
+  case OptimizationLevel::Oz:
+    return "Oz";
+  default:
+    __builtin_unreachable();
+  }
+}
 
-  LOG(INFO) << "compile start";
-  const fs::path Path(fs::u8path(OutputPath));
-  fs::path LLPath(Path);
-  LLPath.replace_extension("ll"sv);
-  std::filesystem::path OPath(Path);
-  OPath.replace_extension("%%%%%%%%%%.o"sv);
+/// Symbols shared by all variants of a compiled binary.
+static bool isSharedSymbol(llvm::StringRef Name) {
+  return llvm::StringSwitch<bool>(Name)
+      .Cases("version", "wasm.code", "wasm.size", "variants", "bounds",
+             "metered", true)
+      .StartsWith("wasm.data.", true)
+      .Default(false);
+}
 
-  llvm::InitializeNativeTarget();
-  llvm::InitializeNativeTargetAsmPrinter();
+/// Get the target settings in the form of "cpu;level;+feature,...".
+///
+/// The features include the ones implied by the CPU which the loader knows how
+/// to check, so that the variants for newer CPUs are not selected on older
+/// ones, and the loader ranks the variants by the number of features.
+static std::string getTargetString(const std::string &CPU,
+                                   const llvm::SubtargetFeatures &Features,
+                                   OptimizationLevel Level) {
+  std::vector<std::string> Enabled;
+  for (const auto &Feature : Features.getFeatures()) {
+    if (!Feature.empty() && Feature.front() == '+') {
+      Enabled.push_back(Feature);
+    }
+  }
 
-  llvm::LLVMContext VMContext;
-  auto LLModule = std::make_unique<llvm::Module>(LLPath.native(), VMContext);
-  LLModule->setTargetTriple(llvm::sys::getProcessTriple());
-  CompileContext NewContext(*LLModule);
-  struct RAIICleanup {
-    RAIICleanup(CompileContext *&Context, CompileContext &NewContext)
-        : Context(Context) {
-      Context = &NewContext;
-    }
-    ~RAIICleanup() { Context = nullptr; }
-    CompileContext *&Context;
+  std::string Error;
+  const std::string Triple = llvm::sys::getProcessTriple();
+  if (const auto *TheTarget =
+          llvm::TargetRegistry::lookupTarget(Triple, Error)) {
+    std::unique_ptr<llvm::MCSubtargetInfo> STI(TheTarget->createMCSubtargetInfo(
+        Triple, CPU, Features.getString()));
+#if defined(__i386__) || defined(_M_IX86) || defined(__x86_64__) ||            \
+    defined(_M_X64)
+    for (const auto &Feature : kCPUFeatures) {
+      const std::string Flag = "+" + std::string(Feature.Name);
+      if (STI && STI->checkFeatures(Flag) &&
+          std::find(Enabled.begin(), Enabled.end(), Flag) == Enabled.end()) {
+        Enabled.push_back(Flag);
+      }
+    }
+#endif
+  }
+
+  std::string Result = CPU + ';' + toString(Level) + ';';
+  for (size_t I = 0; I < Enabled.size(); ++I) {
+    if (I > 0) {
+      Result += ',';
+    }
+    Result += Enabled[I];
+  }
+  return Result;
+}
+
+/// Time of compilation phases and statistics of functions, shared by the
+/// worker threads.
+class CompileReport {
+public:
+  using Clock = std::chrono::steady_clock;
+  using TimeList = std::vector<std::pair<std::string, Clock::duration>>;
+
+  /// Accumulate the time of a compilation phase.
+  void addTime(llvm::StringRef Phase, Clock::duration Duration) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    accumulate(Phases, Phase, Duration);
+  }
+
+  /// Accumulate the time of optimization passes.
+  void addPassTimes(const TimeList &Times) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    for (const auto &[Pass, Duration] : Times) {
+      accumulate(Passes, Pass, Duration);
+    }
+  }
+
+  /// Record the IR instruction counts of the defined functions.
+  void addInstrCounts(const llvm::Module &LLModule, bool Optimized) {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    for (const auto &F : LLModule) {
+      if (!F.isDeclaration()) {
+        auto &Stats = Functions[F.getName().str()];
+        (Optimized ? Stats.After : Stats.Before) += F.getInstructionCount();
+      }
+    }
+  }
+
+  /// Record the code sizes of the functions in the object file.
+  void addCodeSizes(llvm::StringRef ObjectPath) {
+    auto Buffer = llvm::MemoryBuffer::getFile(ObjectPath);
+    if (!Buffer) {
+      return;
+    }
+    auto Object = llvm::object::ObjectFile::createObjectFile(
+        (*Buffer)->getMemBufferRef());
+    if (!Object) {
+      llvm::consumeError(Object.takeError());
+      return;
+    }
+    std::lock_guard<std::mutex> Lock(Mutex);
+    for (const auto &[Symbol, Size] :
+         llvm::object::computeSymbolSizes(**Object)) {
+      auto Type = Symbol.getType();
+      auto Name = Symbol.getName();
+      if (Type && Name && *Type == llvm::object::SymbolRef::ST_Function) {
+        Functions[Name->str()].CodeSize += Size;
+      } else {
+        llvm::consumeError(Type.takeError());
+        llvm::consumeError(Name.takeError());
+      }
+    }
+  }
+
+  /// Print the time of phases and passes.
+  void printTimes(llvm::raw_ostream &OS) const {
+    const auto ToMs = [](Clock::duration Duration) {
+      return std::chrono::duration<double, std::milli>(Duration).count();
+    };
+    OS << "===-- Compile time report --===\n";
+    OS << "   Time (ms)  Phase\n";
+    for (const auto &[Phase, Duration] : Phases) {
+      OS << llvm::format("%12.3f  %s\n", ToMs(Duration), Phase.c_str());
+    }
+    if (Passes.empty()) {
+      return;
+    }
+    /// Passes of all partitions are summed, so the total may exceed the
+    /// optimization phase with parallel jobs.
+    TimeList Sorted(Passes);
+    std::stable_sort(Sorted.begin(), Sorted.end(),
+                     [](const auto &L, const auto &R) {
+                       return L.second > R.second;
+                     });
+    OS << "===-- Optimization pass time report --===\n";
+    OS << "   Time (ms)  Pass\n";
+    for (const auto &[Pass, Duration] : Sorted) {
+      OS << llvm::format("%12.3f  %s\n", ToMs(Duration), Pass.c_str());
+    }
+  }
+
+  /// Print the statistics of functions, ordered by the code size.
+  void printStats(llvm::raw_ostream &OS) const {
+    std::vector<std::pair<std::string, FunctionStats>> Sorted(
+        Functions.begin(), Functions.end());
+    std::stable_sort(Sorted.begin(), Sorted.end(),
+                     [](const auto &L, const auto &R) {
+                       return L.second.CodeSize > R.second.CodeSize;
+                     });
+    FunctionStats Total;
+    OS << "===-- Function statistics --===\n";
+    OS << "   IR before    IR after   Code size  Function\n";
+    for (const auto &[Name, Stats] : Sorted) {
+      OS << llvm::format("%12" PRIu64 "%12" PRIu64 "%12" PRIu64 "  %s\n",
+                         Stats.Before, Stats.After, Stats.CodeSize,
+                         Name.c_str());
+      Total.Before += Stats.Before;
+      Total.After += Stats.After;
+      Total.CodeSize += Stats.CodeSize;
+    }
+    OS << llvm::format("%12" PRIu64 "%12" PRIu64 "%12" PRIu64 "  (total)\n",
+                       Total.Before, Total.After, Total.CodeSize);
+  }
+
+  /// Add the time to the named item of the list.
+  static void accumulate(TimeList &List, llvm::StringRef Name,
+                         Clock::duration Duration) {
+    auto It = std::find_if(List.begin(), List.end(), [Name](const auto &Item) {
+      return Item.first == Name;
+    });
+    if (It == List.end()) {
+      List.emplace_back(Name.str(), Duration);
+    } else {
+      It->second += Duration;
+    }
+  }
+
+private:
+  struct FunctionStats {
+    uint64_t Before = 0;
+    uint64_t After = 0;
+    uint64_t CodeSize = 0;
   };
-  RAIICleanup Cleanup(Context, NewContext);
 
-  return Expect<void>()
-      .and_then([&]() -> Expect<void> {
-        /// Compile Function Types
-        if (const AST::TypeSection *TypeSec = Module.getTypeSection()) {
-          return compile(*TypeSec);
-        }
-        return {};
-      })
-      .and_then([&]() -> Expect<void> {
-        /// Compile ImportSection
-        if (const AST::ImportSection *ImportSec = Module.getImportSection()) {
-          return compile(*ImportSec);
-        }
-        return {};
-      })
-      .and_then([&]() -> Expect<void> {
-        /// Compile GlobalSection
-        if (const AST::GlobalSection *GlobSec = Module.getGlobalSection()) {
-          return compile(*GlobSec);
-        }
-        return {};
-      })
-      .and_then([&]() -> Expect<void> {
-        /// Compile MemorySection (MemorySec, DataSec)
-        if (const AST::MemorySection *MemSec = Module.getMemorySection()) {
-          if (const AST::DataSection *DataSec = Module.getDataSection()) {
-            return compile(*MemSec, *DataSec);
-          }
-        }
-        return {};
-      })
-      .and_then([&]() -> Expect<void> {
-        /// Compile TableSection
-        if (const AST::TableSection *TabSec = Module.getTableSection()) {
-          if (const AST::ElementSection *ElemSec = Module.getElementSection()) {
-            return compile(*TabSec, *ElemSec);
-          }
-        }
-        return {};
-      })
-      .and_then([&]() -> Expect<void> {
-        /// compile Functions in module. (FuncionSec, CodeSec)
-        if (const AST::FunctionSection *FuncSec = Module.getFunctionSection()) {
-          if (const AST::CodeSection *CodeSec = Module.getCodeSection()) {
-            return compile(*FuncSec, *CodeSec);
-          }
-        }
-        return {};
-      })
-      .and_then([&]() -> Expect<void> {
-        /// Compile ExportSection
-        if (const AST::ExportSection *ExportSec = Module.getExportSection()) {
-          return compile(*ExportSec);
-        }
-        return {};
-      })
-      .and_then([&]() -> Expect<void> {
-        /// Compile StartSection (StartSec)
-        if (Module.getStartSection()) {
-          ;
-        }
-        return {};
-      })
-      .and_then([&]() -> Expect<void> {
-        /// create wasm.code and wasm.size
-        {
-          auto *Int32Ty = llvm::Type::getInt32Ty(VMContext);
-          auto *Content = llvm::ConstantDataArray::getString(
-              VMContext,
-              llvm::StringRef(reinterpret_cast<const char *>(Data.data()),
-                              Data.size()),
-              false);
-          new llvm::GlobalVariable(Context->Module, Content->getType(), false,
-                                   llvm::GlobalValue::ExternalLinkage, Content,
-                                   "wasm.code");
-          new llvm::GlobalVariable(Context->Module, Int32Ty, false,
-                                   llvm::GlobalValue::ExternalLinkage,
-                                   llvm::ConstantInt::get(Int32Ty, Data.size()),
-                                   "wasm.size");
-        }
+  std::mutex Mutex;
+  /// Phases in the order of first record.
+  TimeList Phases;
+  TimeList Passes;
+  std::map<std::string, FunctionStats> Functions;
+};
 
-        if (DumpIR) {
-          int Fd;
-          llvm::sys::fs::openFileForWrite("wasm.ll", Fd);
-          llvm::raw_fd_ostream OS(Fd, true);
-          LLModule->print(OS, nullptr);
-        }
+/// Add the time of the scope to the report, if any.
+class ScopedPhase {
+public:
+  ScopedPhase(CompileReport *Report, llvm::StringRef Phase)
+      : Report(Report), Phase(Phase), Start(CompileReport::Clock::now()) {}
+  ~ScopedPhase() {
+    if (Report) {
+      Report->addTime(Phase, CompileReport::Clock::now() - Start);
+    }
+  }
 
-        LOG(INFO) << "verify start";
-        llvm::verifyModule(*LLModule, &llvm::errs());
-        LOG(INFO) << "optimize start";
+private:
+  CompileReport *Report;
+  llvm::StringRef Phase;
+  CompileReport::Clock::time_point Start;
+};
 
-        // tempfile
-        auto Object = llvm::sys::fs::TempFile::create(OPath.native());
-        if (!Object) {
-          // TODO:return error
-          llvm::consumeError(Object.takeError());
-          return {};
-        }
-        std::error_code EC;
-        auto OS = std::make_unique<llvm::raw_fd_ostream>(Object->TmpName, EC);
-        if (EC) {
-          // TODO:return error
-          llvm::consumeError(Object->discard());
-          return {};
-        }
+#if LLVM_VERSION_MAJOR >= 12
+/// Measure the time of each pass and analysis, excluding the nested ones.
+class PassTimer {
+public:
+  void registerCallbacks(llvm::PassInstrumentationCallbacks &PIC) {
+    PIC.registerBeforeNonSkippedPassCallback(
+        [this](llvm::StringRef Pass, llvm::Any) { start(Pass); });
+    PIC.registerAfterPassCallback(
+        [this](llvm::StringRef, llvm::Any, const llvm::PreservedAnalyses &) {
+          stop();
+        });
+    PIC.registerAfterPassInvalidatedCallback(
+        [this](llvm::StringRef, const llvm::PreservedAnalyses &) { stop(); });
+    PIC.registerBeforeAnalysisCallback(
+        [this](llvm::StringRef Pass, llvm::Any) { start(Pass); });
+    PIC.registerAfterAnalysisCallback(
+        [this](llvm::StringRef, llvm::Any) { stop(); });
+  }
 
-        // optimize + codegen
-        {
-          std::string Error;
-          std::string Triple = LLModule->getTargetTriple();
-          const llvm::Target *TheTarget =
-              llvm::TargetRegistry::lookupTarget(Triple, Error);
-          if (!TheTarget) {
-            // TODO:return error
-            llvm::errs() << "lookupTarget failed\n";
-            llvm::consumeError(Object->discard());
-            return {};
-          }
+  const CompileReport::TimeList &getTimes() const { return Times; }
+
+private:
+  void start(llvm::StringRef Pass) {
+    const auto Now = CompileReport::Clock::now();
+    if (!Running.empty()) {
+      CompileReport::accumulate(Times, Running.back().first,
+                                Now - Running.back().second);
+    }
+    Running.emplace_back(Pass.str(), Now);
+  }
+
+  void stop() {
+    if (Running.empty()) {
+      return;
+    }
+    const auto Now = CompileReport::Clock::now();
+    CompileReport::accumulate(Times, Running.back().first,
+                              Now - Running.back().second);
+    Running.pop_back();
+    if (!Running.empty()) {
+      Running.back().second = Now;
+    }
+  }
+
+  std::vector<std::pair<std::string, CompileReport::Clock::time_point>> Running;
+  CompileReport::TimeList Times;
+};
+#endif
+
+/// Optimize module and generate object code into a temporary file.
+static std::optional<llvm::sys::fs::TempFile>
+optimizeAndCodegen(llvm::Module &LLModule, llvm::StringRef CPU,
+                   llvm::StringRef Features, OptimizationLevel Level,
+                   llvm::StringRef ObjectModel, llvm::StringRef DumpPath,
+                   CompileReport *Report = nullptr) {
+  // tempfile
+  auto Object = llvm::sys::fs::TempFile::create(ObjectModel);
+  if (!Object) {
+    llvm::consumeError(Object.takeError());
+    return std::nullopt;
+  }
+  std::error_code EC;
+  auto OS = std::make_unique<llvm::raw_fd_ostream>(Object->TmpName, EC);
+  if (EC) {
+    llvm::consumeError(Object->discard());
+    return std::nullopt;
+  }
+
+  std::string Error;
+  std::string Triple = LLModule.getTargetTriple();
+  const llvm::Target *TheTarget =
+      llvm::TargetRegistry::lookupTarget(Triple, Error);
+  if (!TheTarget) {
+    llvm::errs() << "lookupTarget failed\n";
+    llvm::consumeError(Object->discard());
+    return std::nullopt;
+  }
 
-          llvm::TargetOptions Options;
-          llvm::Reloc::Model RM = llvm::Reloc::PIC_;
-          std::unique_ptr<llvm::TargetMachine> TM(
-              TheTarget->createTargetMachine(
-                  Triple, llvm::sys::getHostCPUName(),
-                  Context->SubtargetFeatures.getString(), Options, RM,
-                  llvm::None, llvm::CodeGenOpt::Level::Aggressive));
-          LLModule->setDataLayout(TM->createDataLayout());
+  llvm::TargetOptions Options;
+  llvm::Reloc::Model RM = llvm::Reloc::PIC_;
+  std::unique_ptr<llvm::TargetMachine> TM(TheTarget->createTargetMachine(
+      Triple, CPU, Features, Options, RM, llvm::None, toCodeGenLevel(Level)));
+  LLModule.setDataLayout(TM->createDataLayout());
 
 #if LLVM_VERSION_MAJOR >= 9
-          llvm::PassBuilder PB(TM.get(), llvm::PipelineTuningOptions(),
-                               llvm::None);
+  llvm::PassInstrumentationCallbacks PIC;
+#if LLVM_VERSION_MAJOR >= 12
+  PassTimer Timer;
+  if (Report) {
+    Timer.registerCallbacks(PIC);
+  }
+#endif
+  llvm::PassBuilder PB(TM.get(), llvm::PipelineTuningOptions(), llvm::None,
+                       &PIC);
 #else
-          llvm::PassBuilder PB(TM.get(), llvm::None);
+  llvm::PassBuilder PB(TM.get(), llvm::None);
 #endif
 
-          llvm::LoopAnalysisManager LAM(false);
-          llvm::FunctionAnalysisManager FAM(false);
-          llvm::CGSCCAnalysisManager CGAM(false);
-          llvm::ModuleAnalysisManager MAM(false);
+  llvm::LoopAnalysisManager LAM;
+  llvm::FunctionAnalysisManager FAM;
+  llvm::CGSCCAnalysisManager CGAM;
+  llvm::ModuleAnalysisManager MAM;
 
-          // Register the AA manager first so that our version is the one used.
-          FAM.registerPass([&] { return PB.buildDefaultAAPipeline(); });
+  // Register the AA manager first so that our version is the one used.
+  FAM.registerPass([&] { return PB.buildDefaultAAPipeline(); });
 
-          // Register the target library analysis directly and give it a
-          // customized preset TLI.
-          auto TLII = std::make_unique<llvm::TargetLibraryInfoImpl>(
-              llvm::Triple(LLModule->getTargetTriple()));
-          FAM.registerPass([&] { return llvm::TargetLibraryAnalysis(*TLII); });
+  // Register the target library analysis directly and give it a
+  // customized preset TLI.
+  auto TLII = std::make_unique<llvm::TargetLibraryInfoImpl>(
+      llvm::Triple(LLModule.getTargetTriple()));
+  FAM.registerPass([&] { return llvm::TargetLibraryAnalysis(*TLII); });
 #if LLVM_VERSION_MAJOR <= 9
-          MAM.registerPass([&] { return llvm::TargetLibraryAnalysis(*TLII); });
+  MAM.registerPass([&] { return llvm::TargetLibraryAnalysis(*TLII); });
 #endif
 
-          // Register all the basic analyses with the managers.
-          PB.registerModuleAnalyses(MAM);
-          PB.registerCGSCCAnalyses(CGAM);
-          PB.registerFunctionAnalyses(FAM);
-          PB.registerLoopAnalyses(LAM);
-          PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+  // Register all the basic analyses with the managers.
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
 
-          llvm::ModulePassManager MPM(false);
+  llvm::ModulePassManager MPM;
+#if LLVM_VERSION_MAJOR >= 14
+  using PassLevel = llvm::OptimizationLevel;
+#else
+  using PassLevel = llvm::PassBuilder::OptimizationLevel;
+#endif
 
-          MPM.addPass(PB.buildPerModuleDefaultPipeline(llvm::PassBuilder::Oz));
-          MPM.addPass(PB.buildPerModuleDefaultPipeline(llvm::PassBuilder::O3));
+  switch (Level) {
+  case OptimizationLevel::O0:
+    break;
+  case OptimizationLevel::O1:
+    MPM.addPass(PB.buildPerModuleDefaultPipeline(PassLevel::O1));
+    break;
+  case OptimizationLevel::O2:
+    MPM.addPass(PB.buildPerModuleDefaultPipeline(PassLevel::O2));
+    break;
+  case OptimizationLevel::O3:
+    MPM.addPass(PB.buildPerModuleDefaultPipeline(PassLevel::O3));
+    break;
+  case OptimizationLevel::Os:
+    MPM.addPass(PB.buildPerModuleDefaultPipeline(PassLevel::Os));
+    break;
+  case OptimizationLevel::Oz:
+    MPM.addPass(PB.buildPerModuleDefaultPipeline(PassLevel::Oz));
+    break;
+  }
 
-          llvm::legacy::PassManager CodeGenPasses;
-          CodeGenPasses.add(llvm::createTargetTransformInfoWrapperPass(
-              TM->getTargetIRAnalysis()));
+  llvm::legacy::PassManager CodeGenPasses;
+  CodeGenPasses.add(
+      llvm::createTargetTransformInfoWrapperPass(TM->getTargetIRAnalysis()));
 
-          // Add LibraryInfo.
-          CodeGenPasses.add(new llvm::TargetLibraryInfoWrapperPass(*TLII));
+  // Add LibraryInfo.
+  CodeGenPasses.add(new llvm::TargetLibraryInfoWrapperPass(*TLII));
 
-          if (TM->addPassesToEmitFile(CodeGenPasses, *OS, nullptr,
+  if (TM->addPassesToEmitFile(CodeGenPasses, *OS, nullptr,
 #if LLVM_VERSION_MAJOR >= 10
-                                      llvm::CGFT_ObjectFile,
+                              llvm::CGFT_ObjectFile,
 #else
-                                      llvm::TargetMachine::CGFT_ObjectFile,
+                              llvm::TargetMachine::CGFT_ObjectFile,
 #endif
-                                      false)) {
-            // TODO:return error
-            llvm::errs() << "addPassesToEmitFile failed\n";
-            llvm::consumeError(Object->discard());
-            return {};
-          }
+                              false)) {
+    llvm::errs() << "addPassesToEmitFile failed\n";
+    llvm::consumeError(Object->discard());
+    return std::nullopt;
+  }
 
-          MPM.run(*LLModule, MAM);
+  if (Report) {
+    Report->addInstrCounts(LLModule, false);
+  }
+  {
+    ScopedPhase Phase(Report, "optimization");
+    MPM.run(LLModule, MAM);
+  }
+  if (Report) {
+    Report->addInstrCounts(LLModule, true);
+#if LLVM_VERSION_MAJOR >= 12
+    Report->addPassTimes(Timer.getTimes());
+#endif
+  }
 
-          {
-            if (auto *Call = LLModule->getGlobalVariable("call")) {
-              Call->setInitializer(llvm::ConstantPointerNull::get(
-                  llvm::cast<llvm::PointerType>(Call->getValueType())));
-              Call->setConstant(false);
-            }
+  if (!DumpPath.empty()) {
+    int Fd;
+    llvm::sys::fs::openFileForWrite(DumpPath, Fd);
+    llvm::raw_fd_ostream DumpOS(Fd, true);
+    LLModule.print(DumpOS, nullptr);
+  }
+  {
+    ScopedPhase Phase(Report, "code generation");
+    CodeGenPasses.run(LLModule);
+  }
+  OS.reset();
+
+  return std::move(*Object);
+}
+
+/// Compile the registration table of a static archive. See
+/// "include/common/staticmodule.h".
+///
+/// The symbols are listed by the names used by the loader, and defined with
+/// the module prefix in the other objects.
+static std::optional<llvm::sys::fs::TempFile>
+compileRegistrationTable(llvm::StringRef Name, llvm::StringRef Prefix,
+                         llvm::ArrayRef<std::string> Symbols,
+                         llvm::StringRef ObjectModel) {
+  llvm::LLVMContext VMContext;
+  llvm::Module LLModule("wasm", VMContext);
+  LLModule.setTargetTriple(llvm::sys::getProcessTriple());
+  auto *Int8Ty = llvm::Type::getInt8Ty(VMContext);
+  auto *Int8PtrTy = llvm::Type::getInt8PtrTy(VMContext);
+  auto *Int32Ty = llvm::Type::getInt32Ty(VMContext);
+
+  auto *SymbolTy = llvm::StructType::create({Int8PtrTy, Int8PtrTy},
+                                            "ssvm.static.symbol");
+  std::vector<llvm::Constant *> Entries;
+  Entries.reserve(Symbols.size());
+  for (const auto &Symbol : Symbols) {
+    auto *Init = llvm::ConstantDataArray::getString(VMContext, Symbol);
+    auto *String = new llvm::GlobalVariable(
+        LLModule, Init->getType(), true, llvm::GlobalValue::PrivateLinkage,
+        Init, "ssvm.static.name");
+    auto *Address = new llvm::GlobalVariable(
+        LLModule, Int8Ty, true, llvm::GlobalValue::ExternalLinkage, nullptr,
+        Prefix + Symbol);
+    Entries.push_back(llvm::ConstantStruct::get(
+        SymbolTy, {llvm::ConstantExpr::getBitCast(String, Int8PtrTy),
+                   Address}));
+  }
+  auto *ArrayTy = llvm::ArrayType::get(SymbolTy, Entries.size());
+  auto *Table = new llvm::GlobalVariable(
+      LLModule, ArrayTy, true, llvm::GlobalValue::PrivateLinkage,
+      llvm::ConstantArray::get(ArrayTy, Entries), "ssvm.static.symbols");
+
+  auto *NameInit = llvm::ConstantDataArray::getString(VMContext, Name);
+  auto *NameString = new llvm::GlobalVariable(
+      LLModule, NameInit->getType(), true, llvm::GlobalValue::PrivateLinkage,
+      NameInit, "ssvm.static.name");
+  auto *ModuleTy = llvm::StructType::create(
+      {Int8PtrTy, Int32Ty, SymbolTy->getPointerTo()}, "ssvm.static.module");
+  new llvm::GlobalVariable(
+      LLModule, ModuleTy, true, llvm::GlobalValue::ExternalLinkage,
+      llvm::ConstantStruct::get(
+          ModuleTy,
+          {llvm::ConstantExpr::getBitCast(NameString, Int8PtrTy),
+           llvm::ConstantInt::get(Int32Ty, Entries.size()),
+           llvm::ConstantExpr::getBitCast(Table, SymbolTy->getPointerTo())}),
+      "ssvm_module_" + Name);
+
+  return optimizeAndCodegen(LLModule, "", "", OptimizationLevel::O0,
+                            ObjectModel, "");
+}
+
+/// Copy the function into a new module with the declarations it references
+/// only, so that the unrelated parts of the module are not printed in its
+/// cache key or compiled with it.
+static std::unique_ptr<llvm::Module> extractFunction(llvm::Function &F) {
+  llvm::ValueToValueMapTy VMap;
+  auto Part = llvm::CloneModule(
+      *F.getParent(), VMap,
+      [&F](const llvm::GlobalValue *GV) { return GV == &F; });
+  Part->setModuleIdentifier("wasm");
+  Part->setSourceFileName("wasm");
+  std::vector<llvm::GlobalValue *> Unused;
+  for (auto &GV : Part->global_values()) {
+    GV.removeDeadConstantUsers();
+    if (GV.isDeclaration() && GV.use_empty()) {
+      Unused.push_back(&GV);
+    }
+  }
+  for (auto *GV : Unused) {
+    GV->eraseFromParent();
+  }
+  return Part;
+}
+
+/// Get the cache key of the function, the digest of the target settings and
+/// the unoptimized IR of the function with the signatures of the functions
+/// and globals it references.
+static std::string getCacheKey(llvm::Function &F, llvm::StringRef Settings) {
+  std::string IR;
+  {
+    llvm::raw_string_ostream OS(IR);
+    extractFunction(F)->print(OS, nullptr);
+  }
+  SSVM::Support::SHA256 Hasher;
+  Hasher.update(SSVM::Span<const uint8_t>(
+      reinterpret_cast<const uint8_t *>(Settings.data()), Settings.size()));
+  Hasher.update(SSVM::Span<const uint8_t>(
+      reinterpret_cast<const uint8_t *>(IR.data()), IR.size()));
+  return SSVM::Support::SHA256::toHexStr(Hasher.finalize());
+}
 
-            if (auto *MemGrow = LLModule->getGlobalVariable("memgrow")) {
-              MemGrow->setInitializer(llvm::ConstantPointerNull::get(
-                  llvm::cast<llvm::PointerType>(MemGrow->getValueType())));
-              MemGrow->setConstant(false);
+/// Compile the functions one by one with a cache of object files, and the
+/// rest of the module into a temporary object.
+///
+/// Each function is keyed by getCacheKey before the module-level globals are
+/// emitted, so cross function optimizations such as inlining are not applied
+/// to them. The failed step is reported to stderr.
+static Expect<void> compileWithCache(
+    llvm::Module &LLModule,
+    llvm::ArrayRef<std::pair<llvm::Function *, std::string>> Functions,
+    const std::filesystem::path &CacheDir, llvm::StringRef CPU,
+    llvm::StringRef Features, OptimizationLevel Level,
+    llvm::StringRef ObjectModel, std::vector<llvm::sys::fs::TempFile> &Objects,
+    std::vector<std::string> &CachedObjects, CompileReport *Report) {
+  std::error_code EC;
+  std::filesystem::create_directories(CacheDir, EC);
+  if (EC) {
+    llvm::errs() << "create cache directory " << CacheDir.u8string()
+                 << " failed: " << EC.message() << '\n';
+    return Unexpect(ErrCode::InvalidPath);
+  }
+
+  /// Definitions will be referenced across objects.
+  for (auto &GV : LLModule.global_values()) {
+    if (!GV.isDeclaration() && GV.hasLocalLinkage()) {
+      GV.setLinkage(llvm::GlobalValue::ExternalLinkage);
+      GV.setVisibility(llvm::GlobalValue::HiddenVisibility);
+    }
+  }
+
+  const std::string TempModel = (CacheDir / "%%%%%%%%%%.o.tmp").u8string();
+  llvm::SmallPtrSet<const llvm::GlobalValue *, 16> Cached;
+  for (const auto &[F, Key] : Functions) {
+    Cached.insert(F);
+    const auto Path = CacheDir / (Key + ".o");
+    if (!std::filesystem::exists(Path)) {
+      auto Part = extractFunction(*F);
+      auto Object =
+          optimizeAndCodegen(*Part, CPU, Features, Level, TempModel, "",
+                             Report);
+      if (!Object) {
+        llvm::errs() << "compile function " << F->getName() << " failed\n";
+        return Unexpect(ErrCode::CompileFailed);
+      }
+      /// Renaming is atomic, so concurrent builds never see partial objects.
+      if (auto Err = Object->keep(Path.u8string())) {
+        llvm::errs() << "write cache object " << Path.u8string()
+                     << " failed: " << llvm::toString(std::move(Err)) << '\n';
+        llvm::consumeError(Object->discard());
+        return Unexpect(ErrCode::InvalidPath);
+      }
+    }
+    CachedObjects.push_back(Path.u8string());
+  }
+
+  llvm::ValueToValueMapTy VMap;
+  auto Rest = llvm::CloneModule(
+      LLModule, VMap,
+      [&Cached](const llvm::GlobalValue *GV) { return !Cached.count(GV); });
+  auto Object =
+      optimizeAndCodegen(*Rest, CPU, Features, Level, ObjectModel, "", Report);
+  if (!Object) {
+    llvm::errs() << "compile uncached module part failed\n";
+    return Unexpect(ErrCode::CompileFailed);
+  }
+  Objects.push_back(std::move(*Object));
+  return {};
+}
+
+} // namespace
+
+namespace SSVM {
+namespace AOT {
+
+Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
+                               std::string_view OutputPath) {
+  namespace fs = std::filesystem;
+  using namespace std::literals;
+
+  LOG(INFO) << "compile start";
+  const fs::path Path(fs::u8path(OutputPath));
+  fs::path LLPath(Path);
+  LLPath.replace_extension("ll"sv);
+  std::filesystem::path OPath(Path);
+  OPath.replace_extension("%%%%%%%%%%.o"sv);
+
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+
+  /// The name section is optional, and dropped in loading if malformed.
+  const AST::NameSection *Names = Module.getNameSection();
+
+  std::vector<llvm::sys::fs::TempFile> Objects;
+  std::vector<std::string> CachedObjects;
+  /// Symbols listed in the registration table of static archive.
+  const std::string StaticPrefix =
+      StaticName.empty() ? "" : "ssvm." + StaticName + ".";
+  std::vector<std::string> StaticSymbols;
+  std::optional<CompileReport> ReportStorage;
+  if (TimeReport || Stats) {
+    ReportStorage.emplace();
+  }
+  CompileReport *const Report = ReportStorage ? &*ReportStorage : nullptr;
+  auto CompileVariant = [&](const std::string &CPUName,
+                            std::string_view Features, std::string_view Prefix,
+                            bool Shared) -> Expect<void> {
+    const auto IRGenStart = CompileReport::Clock::now();
+    llvm::LLVMContext VMContext;
+    auto LLModule = std::make_unique<llvm::Module>(LLPath.native(), VMContext);
+    LLModule->setTargetTriple(llvm::sys::getProcessTriple());
+    CompileContext NewContext(*LLModule, CPUName.empty());
+    struct RAIICleanup {
+      RAIICleanup(CompileContext *&Context, CompileContext &NewContext)
+          : Context(Context) {
+        Context = &NewContext;
+      }
+      ~RAIICleanup() { Context = nullptr; }
+      CompileContext *&Context;
+    };
+    RAIICleanup Cleanup(Context, NewContext);
+    NewContext.CostTable = CostTable;
+    NewContext.Interruptible = Interruptible;
+    NewContext.Bounds = Bounds;
+    NewContext.Names = Names;
+    NewContext.Profile = Profile;
+    NewContext.addFeatures(Features);
+    const std::string CPU =
+        CPUName.empty() ? llvm::sys::getHostCPUName().str() : CPUName;
+    /// Cache keys of the defined functions.
+    std::vector<std::pair<llvm::Function *, std::string>> CacheKeys;
+
+    {
+      /// Record the target settings, which are checked at load time.
+      const std::string Target =
+          getTargetString(CPU, NewContext.SubtargetFeatures, OptLevel);
+      auto *Init = llvm::ConstantDataArray::getString(VMContext, Target);
+      new llvm::GlobalVariable(*LLModule, Init->getType(), true,
+                               llvm::GlobalValue::ExternalLinkage, Init,
+                               "target");
+    }
+
+    return Expect<void>()
+        .and_then([&]() -> Expect<void> {
+          /// Compile Function Types
+          if (const AST::TypeSection *TypeSec = Module.getTypeSection()) {
+            return compile(*TypeSec);
+          }
+          return {};
+        })
+        .and_then([&]() -> Expect<void> {
+          /// Compile ImportSection
+          if (const AST::ImportSection *ImportSec = Module.getImportSection()) {
+            return compile(*ImportSec);
+          }
+          return {};
+        })
+        .and_then([&]() -> Expect<void> {
+          /// Compile GlobalSection
+          if (const AST::GlobalSection *GlobSec = Module.getGlobalSection()) {
+            return compile(*GlobSec);
+          }
+          return {};
+        })
+        .and_then([&]() -> Expect<void> {
+          /// Compile MemorySection (MemorySec, DataSec)
+          if (const AST::MemorySection *MemSec = Module.getMemorySection()) {
+            if (const AST::DataSection *DataSec = Module.getDataSection()) {
+              return compile(*MemSec, *DataSec);
             }
+            return compile(*MemSec, AST::DataSection());
+          }
+          return {};
+        })
+        .and_then([&]() -> Expect<void> {
+          /// Compile TableSection
+          if (const AST::TableSection *TabSec = Module.getTableSection()) {
+            if (const AST::ElementSection *ElemSec =
+                    Module.getElementSection()) {
+              return compile(*TabSec, *ElemSec);
+            }
+          }
+          return {};
+        })
+        .and_then([&]() -> Expect<void> {
+          /// compile Functions in module. (FuncionSec, CodeSec)
+          if (const AST::FunctionSection *FuncSec =
+                  Module.getFunctionSection()) {
+            if (const AST::CodeSection *CodeSec = Module.getCodeSection()) {
+              return compile(*FuncSec, *CodeSec);
+            }
+          }
+          return {};
+        })
+        .and_then([&]() -> Expect<void> {
+          /// Key the functions for the object cache before the module-level
+          /// globals are emitted. The prefixes rename the definitions later.
+          if (!CacheDir.empty()) {
+            const std::string Settings =
+                std::to_string(kVersion) + ';' + CPU + ';' +
+                NewContext.SubtargetFeatures.getString() + ';' +
+                toString(OptLevel) + ';' + std::string(Prefix) + ';' +
+                StaticPrefix + ';';
+            for (const auto &Function : NewContext.Functions) {
+              if (std::get<2>(Function)) {
+                auto *F = std::get<1>(Function);
+                CacheKeys.emplace_back(F, getCacheKey(*F, Settings));
+              }
+            }
+          }
+          return {};
+        })
+        .and_then([&]() -> Expect<void> {
+          /// Compile ExportSection
+          if (const AST::ExportSection *ExportSec = Module.getExportSection()) {
+            return compile(*ExportSec);
+          }
+          return {};
+        })
+        .and_then([&]() -> Expect<void> {
+          /// Compile StartSection (StartSec)
+          if (const AST::StartSection *StartSec = Module.getStartSection()) {
+            return compile(*StartSec);
+          }
+          return {};
+        })
+        .and_then([&]() -> Expect<void> {
+          /// Compile wrappers of the functions called from the runtime.
+          return compileWrapperTable();
+        })
+        .and_then([&]() -> Expect<void> {
+          if (Shared) {
+            /// create version, wasm.code and wasm.size
+            auto *Int32Ty = llvm::Type::getInt32Ty(VMContext);
+            new llvm::GlobalVariable(*LLModule, Int32Ty, true,
+                                     llvm::GlobalValue::ExternalLinkage,
+                                     llvm::ConstantInt::get(Int32Ty, kVersion),
+                                     "version");
+            /// The runtime reserves guard pages for the code relying on them.
+            auto *Int8Ty = llvm::Type::getInt8Ty(VMContext);
+            new llvm::GlobalVariable(
+                *LLModule, Int8Ty, true, llvm::GlobalValue::ExternalLinkage,
+                llvm::ConstantInt::get(
+                    Int8Ty, static_cast<uint8_t>(Context->getBoundsCheck())),
+                "bounds");
+            /// The runtime refuses unmetered code under a cost limit.
+            new llvm::GlobalVariable(
+                *LLModule, Int8Ty, true, llvm::GlobalValue::ExternalLinkage,
+                llvm::ConstantInt::get(Int8Ty, CostTable.empty() ? 0 : 1),
+                "metered");
+            auto *Content = llvm::ConstantDataArray::getString(
+                VMContext,
+                llvm::StringRef(reinterpret_cast<const char *>(Data.data()),
+                                Data.size()),
+                false);
+            new llvm::GlobalVariable(
+                *LLModule, Content->getType(), false,
+                llvm::GlobalValue::ExternalLinkage, Content, "wasm.code");
+            new llvm::GlobalVariable(
+                *LLModule, Int32Ty, false, llvm::GlobalValue::ExternalLinkage,
+                llvm::ConstantInt::get(Int32Ty, Data.size()), "wasm.size");
+            if (!Variants.empty()) {
+              new llvm::GlobalVariable(
+                  *LLModule, Int32Ty, true, llvm::GlobalValue::ExternalLinkage,
+                  llvm::ConstantInt::get(Int32Ty, Variants.size()), "variants");
+            }
+            /// Static archives are not mapped from file.
+            const AST::DataSection *DataSec = Module.getDataSection();
+            if (DataSec && StaticName.empty()) {
+              if (auto Res = compileDataImages(*DataSec); !Res) {
+                return Unexpect(Res);
+              }
+            }
+          }
 
-            if (auto *Mem = LLModule->getGlobalVariable("mem")) {
-              Mem->setInitializer(llvm::ConstantPointerNull::get(
-                  llvm::cast<llvm::PointerType>(Mem->getValueType())));
-              Mem->setConstant(false);
+          if (!Prefix.empty() || !StaticPrefix.empty()) {
+            /// Rename definitions of the variant to avoid conflicts at link
+            /// time, since the internal ones may be externalized by splitting.
+            /// In static archives, all definitions are also prefixed by the
+            /// module name, and the visible ones are registered.
+            for (auto &GV : LLModule->global_values()) {
+              if (GV.isDeclaration()) {
+                continue;
+              }
+              std::string Name = GV.getName().str();
+              if (!isSharedSymbol(Name)) {
+                Name = std::string(Prefix) + Name;
+              }
+              if (!StaticPrefix.empty()) {
+                if (!GV.hasLocalLinkage()) {
+                  StaticSymbols.push_back(Name);
+                }
+                Name = StaticPrefix + Name;
+              }
+              GV.setName(Name);
             }
           }
 
           if (DumpIR) {
             int Fd;
-            llvm::sys::fs::openFileForWrite("wasm-opt.ll", Fd);
+            llvm::sys::fs::openFileForWrite(
+                "wasm." + std::string(Prefix) + "ll", Fd);
             llvm::raw_fd_ostream OS(Fd, true);
             LLModule->print(OS, nullptr);
           }
-          LOG(INFO) << "codegen start";
-          CodeGenPasses.run(*LLModule);
-        }
 
+          if (Report) {
+            Report->addTime("IR generation",
+                            CompileReport::Clock::now() - IRGenStart);
+          }
+
+          LOG(INFO) << "verify start";
+          {
+            ScopedPhase Phase(Report, "verification");
+            llvm::verifyModule(*LLModule, &llvm::errs());
+          }
+          LOG(INFO) << "optimize start";
+
+          if (!CacheDir.empty()) {
+            if (auto Res = compileWithCache(
+                    *LLModule, CacheKeys, fs::u8path(CacheDir), CPU,
+                    Context->SubtargetFeatures.getString(), OptLevel,
+                    OPath.native(), Objects, CachedObjects, Report);
+                !Res) {
+              LOG(ERROR) << Res.error();
+              return Unexpect(Res);
+            }
+            return {};
+          }
+
+          /// Imported functions are only declared, so the partitions are
+          /// counted by the defined ones.
+          const auto DefinedNum = std::count_if(
+              Context->Functions.begin(), Context->Functions.end(),
+              [](const auto &Function) {
+                return std::get<2>(Function) != nullptr;
+              });
+          const uint32_t PartitionNum = std::max<uint32_t>(
+              1, std::min<uint32_t>(Jobs, DefinedNum));
+          if (PartitionNum <= 1) {
+            // optimize + codegen
+            const std::string DumpPath =
+                DumpIR ? "wasm-opt." + std::string(Prefix) + "ll" : "";
+            auto Object = optimizeAndCodegen(
+                *LLModule, CPU, Context->SubtargetFeatures.getString(),
+                OptLevel, OPath.native(), DumpPath, Report);
+            if (!Object) {
+              LOG(ERROR) << ErrCode::CompileFailed;
+              return Unexpect(ErrCode::CompileFailed);
+            }
+            Objects.push_back(std::move(*Object));
+          } else {
+            /// Each partition is optimized and compiled in its own LLVMContext,
+            /// so they are serialized into bitcode and reloaded by the workers.
+            std::vector<llvm::SmallString<0>> Bitcodes;
+            LOG(INFO) << "split start";
+            auto WritePartition =
+                [&Bitcodes](std::unique_ptr<llvm::Module> MPart) {
+                  llvm::raw_svector_ostream OS(Bitcodes.emplace_back());
+                  llvm::WriteBitcodeToFile(*MPart, OS);
+                };
+            {
+              ScopedPhase Phase(Report, "splitting");
+#if LLVM_VERSION_MAJOR >= 13
+              llvm::SplitModule(*LLModule, PartitionNum, WritePartition);
+#else
+              llvm::SplitModule(std::move(LLModule), PartitionNum,
+                                WritePartition);
+#endif
+            }
+
+            std::vector<std::optional<llvm::sys::fs::TempFile>> Results(
+                Bitcodes.size());
+            const std::string Features = Context->SubtargetFeatures.getString();
+            auto Worker = [&](size_t Index) {
+              llvm::LLVMContext PartContext;
+              auto PartModule = llvm::parseBitcodeFile(
+                  llvm::MemoryBufferRef(
+                      llvm::StringRef(Bitcodes[Index].data(),
+                                      Bitcodes[Index].size()),
+                      "wasm"),
+                  PartContext);
+              if (!PartModule) {
+                llvm::errs() << "parse partition " << Index << " failed\n";
+                llvm::consumeError(PartModule.takeError());
+                return;
+              }
+              std::string DumpPath;
+              if (DumpIR) {
+                DumpPath = "wasm-opt." + std::string(Prefix) +
+                           std::to_string(Index) + ".ll";
+              }
+              Results[Index] =
+                  optimizeAndCodegen(**PartModule, CPU, Features, OptLevel,
+                                     OPath.native(), DumpPath, Report);
+            };
+            std::vector<std::thread> Threads;
+            Threads.reserve(Bitcodes.size());
+            for (size_t I = 0; I < Bitcodes.size(); ++I) {
+              Threads.emplace_back(Worker, I);
+            }
+            for (auto &Thread : Threads) {
+              Thread.join();
+            }
+
+            /// Keep the succeeded objects, which will be discarded together
+            /// on failure.
+            bool Failed = false;
+            for (auto &Result : Results) {
+              if (Result) {
+                Objects.push_back(std::move(*Result));
+              } else {
+                Failed = true;
+              }
+            }
+            if (Failed) {
+              LOG(ERROR) << ErrCode::CompileFailed;
+              return Unexpect(ErrCode::CompileFailed);
+            }
+          }
+          return {};
+        });
+  };
+
+  Expect<void> Result;
+  if (Variants.empty()) {
+    Result = CompileVariant(TargetCPU, TargetFeatures, "", true);
+  } else {
+    for (size_t I = 0; I < Variants.size() && Result; ++I) {
+      LOG(INFO) << "compile variant " << I;
+      const auto &[CPUName, Features] = Variants[I];
+      Result = CompileVariant(CPUName, Features,
+                              "v" + std::to_string(I) + ".", I == 0);
+    }
+  }
+  if (Result && !StaticName.empty()) {
+    if (auto Object = compileRegistrationTable(StaticName, StaticPrefix,
+                                               StaticSymbols, OPath.native())) {
+      Objects.push_back(std::move(*Object));
+    } else {
+      Result = Unexpect(ErrCode::InvalidPath);
+    }
+  }
+  if (!Result) {
+    for (auto &Object : Objects) {
+      llvm::consumeError(Object.discard());
+    }
+    return Unexpect(Result);
+  }
+
+  if (Report && Stats) {
+    for (const auto &Object : Objects) {
+      Report->addCodeSizes(Object.TmpName);
+    }
+    for (const auto &Object : CachedObjects) {
+      Report->addCodeSizes(Object);
+    }
+  }
+
+  if (!StaticName.empty()) {
+    /// Archive the objects for linking into the host binary.
+    std::vector<std::string> ObjectPaths;
+    for (const auto &Object : Objects) {
+      ObjectPaths.push_back(Object.TmpName);
+    }
+    ObjectPaths.insert(ObjectPaths.end(), CachedObjects.begin(),
+                       CachedObjects.end());
+    auto WriteArchive = [&]() -> llvm::Error {
+      ScopedPhase Phase(Report, "archive");
+      std::vector<llvm::NewArchiveMember> Members;
+      for (const auto &ObjectPath : ObjectPaths) {
+        auto Member = llvm::NewArchiveMember::getFile(ObjectPath, true);
+        if (!Member) {
+          return Member.takeError();
+        }
+        Members.push_back(std::move(*Member));
+      }
+      return llvm::writeArchive(Path.u8string(), Members, true,
+#ifdef __APPLE__
+                                llvm::object::Archive::K_DARWIN,
+#else
+                                llvm::object::Archive::K_GNU,
+#endif
+                                true, false);
+    };
+    llvm::Error Err = WriteArchive();
+    for (auto &Object : Objects) {
+      llvm::consumeError(Object.discard());
+    }
+    if (Err) {
+      llvm::consumeError(std::move(Err));
+      LOG(ERROR) << ErrCode::InvalidPath;
+      return Unexpect(ErrCode::InvalidPath);
+    }
+  } else {
     // link
+    std::vector<const char *> LinkArgs = {"lld", "--shared", "--gc-sections"};
+    for (const auto &Object : Objects) {
+      LinkArgs.push_back(Object.TmpName.c_str());
+    }
+    for (const auto &Object : CachedObjects) {
+      LinkArgs.push_back(Object.c_str());
+    }
+    const std::string OutputName = Path.u8string();
+    LinkArgs.push_back("-o");
+    LinkArgs.push_back(OutputName.c_str());
+    {
+      ScopedPhase Phase(Report, "link");
 #ifdef __APPLE__
-        lld::mach_o::link(
+      lld::mach_o::link(
 #else
-        lld::elf::link(
+      lld::elf::link(
 #endif
-            std::array{"lld", "--shared", "--gc-sections",
-                       Object->TmpName.c_str(), "-o", Path.u8string().c_str()},
-            false,
-#if LLVM_VERSION_MAJOR >= 10
-            llvm::outs(), llvm::errs()
+#if LLVM_VERSION_MAJOR >= 14
+          LinkArgs, llvm::outs(), llvm::errs(), false, false
+#elif LLVM_VERSION_MAJOR >= 10
+          LinkArgs, false, llvm::outs(), llvm::errs()
 #else
-            llvm::errs()
+          LinkArgs, false,
+          llvm::errs()
 #endif
-        );
+      );
+    }
 
-        llvm::consumeError(Object->discard());
-        LOG(INFO) << "compile done";
-        return {};
-      });
+    for (auto &Object : Objects) {
+      llvm::consumeError(Object.discard());
+    }
+  }
+
+  if (Report && TimeReport) {
+    Report->printTimes(llvm::errs());
+  }
+  if (Report && Stats) {
+    Report->printStats(llvm::errs());
+  }
+  LOG(INFO) << "compile done";
+  return {};
 }
 
 Expect<void> Compiler::compile(const AST::TypeSection &TypeSection) {
@@ -2008,7 +3390,7 @@ Expect<void> Compiler::compile(const AST::ImportSection &ImportSec) {
       }
       const auto &FuncType = *Context->FunctionTypes[*TypeIdx];
 
-      llvm::FunctionType *FTy = toLLVMType(VMContext, FuncType);
+      llvm::FunctionType *FTy = toLLVMType(Context->ExecCtxPtrTy, FuncType);
       auto *RTy = FTy->getReturnType();
       auto *F = llvm::Function::Create(FTy, llvm::Function::InternalLinkage,
                                        FullName, Context->Module);
@@ -2017,7 +3399,7 @@ Expect<void> Compiler::compile(const AST::ImportSection &ImportSec) {
       llvm::BasicBlock *Entry = llvm::BasicBlock::Create(VMContext, "entry", F);
       llvm::IRBuilder<> Builder(Entry);
       Builder.setIsFPConstrained(true);
-      Builder.setDefaultConstrainedRounding(RoundingMode::rmToNearest);
+      Builder.setDefaultConstrainedRounding(kRoundToNearest);
       Builder.setDefaultConstrainedExcept(ExceptionBehavior::ebIgnore);
 
       const auto ArgSize = FuncType.getParamTypes().size();
@@ -2040,31 +3422,69 @@ Expect<void> Compiler::compile(const AST::ImportSection &ImportSec) {
                                     Builder.getInt64(RetSize * 8));
       }
 
+      llvm::Argument *ExecCtx = F->arg_begin();
       for (unsigned I = 0; I < ArgSize; ++I) {
-        llvm::Argument *Arg = F->arg_begin() + I;
-        llvm::Value *Ptr = Builder.CreateConstInBoundsGEP1_64(Args, I * 8);
+        llvm::Argument *Arg = F->arg_begin() + 1 + I;
+        llvm::Value *Ptr = createConstInBoundsGEP1_64(Builder, Args, I * 8);
         Builder.CreateStore(
             Arg, Builder.CreateBitCast(Ptr, Arg->getType()->getPointerTo()));
       }
 
-      Builder.CreateCall(Builder.CreateLoad(Context->Call),
-                         {Builder.getInt32(FuncIndex), Args, Rets});
+      {
+        /// Call the bound host function directly if any, or fall back to the
+        /// call trampoline.
+        auto *CheckBB = llvm::BasicBlock::Create(VMContext, "check", F);
+        auto *DirectBB = llvm::BasicBlock::Create(VMContext, "host", F);
+        auto *ProxyBB = llvm::BasicBlock::Create(VMContext, "proxy", F);
+        auto *EndBB = llvm::BasicBlock::Create(VMContext, "end", F);
+        auto *HostFuncs = createLoad(
+            Builder, Context->getExecCtxField(
+                         Builder, ExecCtx, ExecutionContext::Field::HostFuncs));
+        Builder.CreateCondBr(Builder.CreateIsNull(HostFuncs), ProxyBB,
+                             CheckBB);
+
+        Builder.SetInsertPoint(CheckBB);
+        auto *Binding =
+            createConstInBoundsGEP1_64(Builder, HostFuncs, FuncIndex);
+        auto *HostCall = createLoad(
+            Builder, Builder.CreateStructGEP(Context->HostBindingTy, Binding,
+                                             0));
+        Builder.CreateCondBr(Builder.CreateIsNotNull(HostCall), DirectBB,
+                             ProxyBB, Context->Likely);
+
+        Builder.SetInsertPoint(DirectBB);
+        auto *HostFunc = createLoad(
+            Builder, Builder.CreateStructGEP(Context->HostBindingTy, Binding,
+                                             1));
+        createCall(Builder, HostCall, {ExecCtx, HostFunc, Args, Rets});
+        Builder.CreateBr(EndBB);
+
+        Builder.SetInsertPoint(ProxyBB);
+        auto *Call = createLoad(Builder, Context->getExecCtxField(
+                                             Builder, ExecCtx,
+                                             ExecutionContext::Field::Call));
+        createCall(Builder, Call,
+                   {ExecCtx, Builder.getInt32(FuncIndex), Args, Rets});
+        Builder.CreateBr(EndBB);
+
+        Builder.SetInsertPoint(EndBB);
+      }
 
       if (RetSize == 0) {
         Builder.CreateRetVoid();
       } else if (RetSize == 1) {
-        llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(Rets, 0);
+        llvm::Value *VPtr = createConstInBoundsGEP1_64(Builder, Rets, 0);
         llvm::Value *Ptr =
             Builder.CreateBitCast(VPtr, F->getReturnType()->getPointerTo());
-        Builder.CreateRet(Builder.CreateLoad(Ptr));
+        Builder.CreateRet(createLoad(Builder, Ptr));
       } else {
         std::vector<llvm::Value *> Ret;
         Ret.reserve(RetSize);
         for (unsigned I = 0; I < RetSize; ++I) {
-          llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(Rets, I);
+          llvm::Value *VPtr = createConstInBoundsGEP1_64(Builder, Rets, I);
           llvm::Value *Ptr = Builder.CreateBitCast(
               VPtr, RTy->getStructElementType(I)->getPointerTo());
-          Ret.push_back(Builder.CreateLoad(Ptr));
+          Ret.push_back(createLoad(Builder, Ptr));
         }
         Builder.CreateAggregateRet(Ret.data(), RetSize);
       }
@@ -2079,12 +3499,27 @@ Expect<void> Compiler::compile(const AST::ImportSection &ImportSec) {
     }
     case ExternalType::Memory: /// Memory type
     {
-      // XXX: unimplemented
+      /// The memory is accessed through the execution context. The limits
+      /// are only used for choosing the bounds checks.
+      if (auto Res = ImpDesc->getExternalContent<AST::MemoryType>()) {
+        const auto &Limit = *(*Res)->getLimit();
+        Context->HasMemory = true;
+        Context->MemMin = Limit.getMin();
+        Context->MemMax = Limit.hasMax() ? Limit.getMax() : 65536;
+      } else {
+        return Unexpect(ErrCode::InvalidMemoryIdx);
+      }
       break;
     }
     case ExternalType::Global: /// Global type
     {
-      // XXX: unimplemented
+      /// Imported globals are accessed through the execution context.
+      if (auto Res = ImpDesc->getExternalContent<AST::GlobalType>()) {
+        Context->Globals.push_back(
+            toLLVMType(VMContext, (*Res)->getValueType()));
+      } else {
+        return Unexpect(ErrCode::InvalidGlobalIdx);
+      }
       break;
     }
     default:
@@ -2094,72 +3529,81 @@ Expect<void> Compiler::compile(const AST::ImportSection &ImportSec) {
   return {};
 }
 
+/// Create a wrapper calling F with the arguments and returns in buffers of
+/// ValVariant, which is the calling convention of the runtime.
+static llvm::Function *createWrapper(Compiler::CompileContext &Context,
+                                     llvm::Function *F,
+                                     llvm::GlobalValue::LinkageTypes Linkage,
+                                     const llvm::Twine &Name) {
+  auto &VMContext = Context.Context;
+  auto *Wrapper = llvm::Function::Create(
+      llvm::FunctionType::get(llvm::Type::getVoidTy(VMContext),
+                              {Context.ExecCtxPtrTy,
+                               llvm::Type::getInt8PtrTy(VMContext),
+                               llvm::Type::getInt8PtrTy(VMContext)},
+                              false),
+      Linkage, Name, Context.Module);
+  Wrapper->addFnAttr(llvm::Attribute::StrictFP);
+  llvm::Argument *ExecCtx = Wrapper->arg_begin();
+  llvm::Argument *RawArgs = Wrapper->arg_begin() + 1;
+  llvm::Argument *RawRets = Wrapper->arg_begin() + 2;
+  llvm::IRBuilder<> Builder(
+      llvm::BasicBlock::Create(Wrapper->getContext(), "entry", Wrapper));
+  Builder.setIsFPConstrained(true);
+  Builder.setDefaultConstrainedRounding(kRoundToNearest);
+  Builder.setDefaultConstrainedExcept(ExceptionBehavior::ebIgnore);
+
+  auto *RTy = F->getReturnType();
+  const size_t ArgCount = F->arg_size() - 1;
+  const size_t RetCount =
+      RTy->isVoidTy() ? 0
+                      : (RTy->isStructTy() ? RTy->getStructNumElements() : 1);
+  std::vector<llvm::Value *> Args;
+  Args.reserve(F->arg_size());
+  Args.push_back(ExecCtx);
+  for (size_t I = 0; I < ArgCount; ++I) {
+    llvm::Argument *Arg = F->arg_begin() + 1 + I;
+    llvm::Value *VPtr = createConstInBoundsGEP1_64(Builder, RawArgs, I * 8);
+    llvm::Value *Ptr =
+        Builder.CreateBitCast(VPtr, Arg->getType()->getPointerTo());
+    Args.push_back(createLoad(Builder, Ptr));
+  }
+
+  auto Ret = Builder.CreateCall(F, Args);
+  if (RTy->isVoidTy()) {
+    // nothing to do
+  } else if (RTy->isStructTy()) {
+    auto Rets = unpackStruct(Builder, Ret);
+    for (size_t I = 0; I < RetCount; ++I) {
+      llvm::Value *VPtr = createConstInBoundsGEP1_64(Builder, RawRets, I * 8);
+      llvm::Value *Ptr =
+          Builder.CreateBitCast(VPtr, Rets[I]->getType()->getPointerTo());
+      Builder.CreateStore(Rets[I], Ptr);
+    }
+  } else {
+    llvm::Value *VPtr = createConstInBoundsGEP1_64(Builder, RawRets, 0);
+    llvm::Value *Ptr =
+        Builder.CreateBitCast(VPtr, Ret->getType()->getPointerTo());
+    Builder.CreateStore(Ret, Ptr);
+  }
+  Builder.CreateRetVoid();
+  return Wrapper;
+}
+
 Expect<void> Compiler::compile(const AST::ExportSection &ExportSec) {
-  auto &VMContext = Context->Context;
   for (const auto &ExpDesc : ExportSec.getContent()) {
     switch (ExpDesc->getExternalType()) {
     case ExternalType::Function: {
-      auto *Wrapper = llvm::Function::Create(
-          llvm::FunctionType::get(llvm::Type::getVoidTy(VMContext),
-                                  {llvm::Type::getInt8PtrTy(VMContext),
-                                   llvm::Type::getInt8PtrTy(VMContext)},
-                                  false),
+      const auto FuncIdx = ExpDesc->getExternalIndex();
+      auto *Wrapper = createWrapper(
+          *Context, std::get<1>(Context->Functions[FuncIdx]),
           llvm::GlobalValue::ExternalLinkage,
-          AST::Module::toExportName(ExpDesc->getExternalName()),
-          Context->Module);
-      Wrapper->addFnAttr(llvm::Attribute::StrictFP);
-      llvm::Argument *RawArgs = Wrapper->arg_begin();
-      llvm::Argument *RawRets = Wrapper->arg_begin() + 1;
-      llvm::IRBuilder<> Builder(
-          llvm::BasicBlock::Create(Wrapper->getContext(), "entry", Wrapper));
-      Builder.setIsFPConstrained(true);
-      Builder.setDefaultConstrainedRounding(RoundingMode::rmToNearest);
-      Builder.setDefaultConstrainedExcept(ExceptionBehavior::ebIgnore);
-      llvm::Function *F =
-          std::get<1>(Context->Functions[ExpDesc->getExternalIndex()]);
-
-      auto *RTy = F->getReturnType();
-      const size_t ArgCount = F->arg_size();
-      const size_t RetCount =
-          RTy->isVoidTy()
-              ? 0
-              : (RTy->isStructTy() ? RTy->getStructNumElements() : 1);
-      std::vector<llvm::Value *> Args;
-      Args.reserve(F->arg_size());
-      for (size_t I = 0; I < ArgCount; ++I) {
-        llvm::Argument *Arg = F->arg_begin() + I;
-        llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(RawArgs, I * 8);
-        llvm::Value *Ptr =
-            Builder.CreateBitCast(VPtr, Arg->getType()->getPointerTo());
-        Args.push_back(Builder.CreateLoad(Ptr));
-      }
-
-      auto Ret = Builder.CreateCall(F, Args);
-      if (RTy->isVoidTy()) {
-        // nothing to do
-      } else if (RTy->isStructTy()) {
-        auto Rets = unpackStruct(Builder, Ret);
-        for (size_t I = 0; I < RetCount; ++I) {
-          llvm::Value *VPtr =
-              Builder.CreateConstInBoundsGEP1_64(RawRets, I * 8);
-          llvm::Value *Ptr =
-              Builder.CreateBitCast(VPtr, Rets[I]->getType()->getPointerTo());
-          Builder.CreateStore(Rets[I], Ptr);
-        }
-      } else {
-        llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(RawRets, 0);
-        llvm::Value *Ptr =
-            Builder.CreateBitCast(VPtr, Ret->getType()->getPointerTo());
-        Builder.CreateStore(Ret, Ptr);
-      }
-      Builder.CreateRetVoid();
-
+          AST::Module::toExportName(ExpDesc->getExternalName()));
+      Context->Wrappers.emplace(FuncIdx, Wrapper);
       break;
     }
     case ExternalType::Global: {
-      llvm::GlobalVariable *G = Context->Globals[ExpDesc->getExternalIndex()];
-      G->setLinkage(llvm::GlobalValue::ExternalLinkage);
-      G->setName(AST::Module::toExportName(ExpDesc->getExternalName()));
+      /// Globals are owned by the instances.
       break;
     }
     case ExternalType::Memory: {
@@ -2177,19 +3621,60 @@ Expect<void> Compiler::compile(const AST::ExportSection &ExportSec) {
   return {};
 }
 
-Expect<void> Compiler::compile(const AST::GlobalSection &GlobalSec) {
-  for (size_t I = 0; I < GlobalSec.getContent().size(); ++I) {
-    auto Temp = FunctionCompiler::evaluate(
-        GlobalSec.getContent()[I]->getInstrs(), *Context);
-    if (!Temp) {
-      return Unexpect(Temp);
+Expect<void> Compiler::compile(const AST::StartSection &StartSec) {
+  const auto FuncIdx = StartSec.getContent();
+  if (FuncIdx >= Context->Functions.size()) {
+    return Unexpect(ErrCode::InvalidFuncIdx);
+  }
+  if (Context->Wrappers.count(FuncIdx) == 0) {
+    Context->Wrappers.emplace(
+        FuncIdx,
+        createWrapper(*Context, std::get<1>(Context->Functions[FuncIdx]),
+                      llvm::GlobalValue::InternalLinkage, "start"));
+  }
+  return {};
+}
+
+Expect<void> Compiler::compileWrapperTable() {
+  /// The wrappers are indexed by the code segments, so that the loader can
+  /// set the compiled functions without decoding the function bodies. Every
+  /// defined function has one: besides the exports and the start function,
+  /// the runtime reaches the functions in element segments through the table
+  /// instance, even an imported one, and the instantiation refuses functions
+  /// with neither a body nor a wrapper.
+  auto *Int8PtrTy = llvm::Type::getInt8PtrTy(Context->Context);
+  std::vector<llvm::Constant *> Entries;
+  for (uint32_t FuncIdx = 0; FuncIdx < Context->Functions.size(); ++FuncIdx) {
+    if (std::get<2>(Context->Functions[FuncIdx]) == nullptr) {
+      /// Imported function.
+      continue;
     }
-    const auto &ValType =
-        GlobalSec.getContent()[I]->getGlobalType()->getValueType();
-    auto *G = new llvm::GlobalVariable(
-        Context->Module, toLLVMType(Context->Context, ValType), false,
-        llvm::GlobalValue::InternalLinkage, *Temp, "g." + std::to_string(I));
-    Context->Globals.push_back(G);
+    auto It = Context->Wrappers.find(FuncIdx);
+    if (It == Context->Wrappers.end()) {
+      It = Context->Wrappers
+               .emplace(FuncIdx, createWrapper(
+                                     *Context,
+                                     std::get<1>(Context->Functions[FuncIdx]),
+                                     llvm::GlobalValue::InternalLinkage,
+                                     "wrapper"))
+               .first;
+    }
+    Entries.push_back(llvm::ConstantExpr::getBitCast(It->second, Int8PtrTy));
+  }
+  auto *ArrayTy = llvm::ArrayType::get(Int8PtrTy, Entries.size());
+  new llvm::GlobalVariable(Context->Module, ArrayTy, true,
+                           llvm::GlobalValue::ExternalLinkage,
+                           llvm::ConstantArray::get(ArrayTy, Entries),
+                           "wrappers");
+  return {};
+}
+
+Expect<void> Compiler::compile(const AST::GlobalSection &GlobalSec) {
+  /// Globals are initialized by the runtime and accessed through the
+  /// execution context, so only record the value types here.
+  for (const auto &GlobSeg : GlobalSec.getContent()) {
+    const auto &ValType = GlobSeg->getGlobalType()->getValueType();
+    Context->Globals.push_back(toLLVMType(Context->Context, ValType));
   }
   return {};
 }
@@ -2200,11 +3685,63 @@ Expect<void> Compiler::compile(const AST::MemorySection &MemorySection,
     return Unexpect(ErrCode::MultiMemories);
   }
   const auto &Limit = *MemorySection.getContent().front()->getLimit();
+  Context->HasMemory = true;
   Context->MemMin = Limit.getMin();
   Context->MemMax = Limit.hasMax() ? Limit.getMax() : 65536;
   return {};
 }
 
+Expect<void> Compiler::compileDataImages(const AST::DataSection &DataSec) {
+  /// The image of a data segment is page aligned, and padded so that it has
+  /// the same offset in page as the destination. The loader can map the pages
+  /// inside the destination into the memory instance, so only the segments
+  /// with at least one whole page are emitted.
+  auto &LLContext = Context->Context;
+  auto *Int8Ty = llvm::Type::getInt8Ty(LLContext);
+  const auto &DataSegs = DataSec.getContent();
+  for (size_t I = 0; I < DataSegs.size(); ++I) {
+    if (DataSegs[I]->isPassive()) {
+      /// Passive segments are only copied by memory.init.
+      continue;
+    }
+    /// Only the offsets of a single `i32.const` are known here. The others,
+    /// such as `global.get` of an imported global, are resolved in the
+    /// instantiation, and the segment is copied as usual.
+    const auto &Instrs = DataSegs[I]->getInstrs();
+    if (Instrs.size() != 1 || Instrs[0]->getOpCode() != OpCode::I32__const) {
+      continue;
+    }
+    const auto &Const = *static_cast<AST::ConstInstruction *>(Instrs[0].get());
+    const auto Data = DataSegs[I]->getData();
+    const uint64_t Begin = std::get<uint32_t>(Const.getConstValue());
+    const uint64_t End = Begin + Data.size();
+    const uint64_t Pad = Begin % kDataImageAlign;
+    if ((Begin + kDataImageAlign - 1) / kDataImageAlign >=
+        End / kDataImageAlign) {
+      continue;
+    }
+
+    std::string Content(Pad, '\0');
+    Content.append(reinterpret_cast<const char *>(Data.data()), Data.size());
+    auto *Init = llvm::ConstantDataArray::getString(LLContext, Content, false);
+    auto *Image = new llvm::GlobalVariable(
+        Context->Module, Init->getType(), true,
+        llvm::GlobalValue::PrivateLinkage, Init, "wasm.image");
+    Image->setAlignment(Align(kDataImageAlign));
+    llvm::GlobalAlias::create(
+        Int8Ty, 0, llvm::GlobalValue::ExternalLinkage,
+        "wasm.data." + std::to_string(I),
+        llvm::ConstantExpr::getInBoundsGetElementPtr(
+            Init->getType(), Image,
+            llvm::ArrayRef<llvm::Constant *>{
+                llvm::ConstantInt::get(llvm::Type::getInt64Ty(LLContext), 0),
+                llvm::ConstantInt::get(llvm::Type::getInt64Ty(LLContext),
+                                       Pad)}),
+        &Context->Module);
+  }
+  return {};
+}
+
 Expect<void> Compiler::compile(const AST::TableSection &TableSection,
                                const AST::ElementSection &ElementSection) {
   if (TableSection.getContent().size() != 1) {
@@ -2220,7 +3757,7 @@ Expect<void> Compiler::compile(const AST::TableSection &TableSection,
         llvm::cast<llvm::ConstantInt>(*Temp)->getZExtValue();
     const auto &FuncIdxes = Element->getFuncIdxes();
     if (Elements.size() < Offset + FuncIdxes.size()) {
-      Elements.resize(Offset + FuncIdxes.size());
+      Elements.resize(Offset + FuncIdxes.size(), NullElement);
     }
     std::copy(FuncIdxes.begin(), FuncIdxes.end(), Elements.begin() + Offset);
   }
@@ -2240,11 +3777,30 @@ Expect<void> Compiler::compile(const AST::FunctionSection &FuncSec,
     }
     const auto &FuncType = *Context->FunctionTypes[TypeIdx];
     const auto FuncID = Context->Functions.size();
-    auto *FTy = toLLVMType(Context->Context, FuncType);
-    auto *F =
-        llvm::Function::Create(FTy, llvm::Function::InternalLinkage,
-                               "f" + std::to_string(FuncID), Context->Module);
+    auto *FTy = toLLVMType(Context->ExecCtxPtrTy, FuncType);
+    /// Append the name from the name section, so that profilers and
+    /// debuggers can tell the functions apart. The index prefix keeps the
+    /// symbol apart from the runtime and libc ones.
+    std::string Name = "f" + std::to_string(FuncID);
+    if (Context->Names) {
+      const auto FuncName = Context->Names->getFunctionName(FuncID);
+      if (!FuncName.empty()) {
+        Name += '.';
+        /// Tools split the symbol lines by spaces and newlines, so only keep
+        /// the printable ASCII characters.
+        for (const char C : FuncName) {
+          Name += (C > ' ' && C < '\x7f') ? C : '_';
+        }
+      }
+    }
+    auto *F = llvm::Function::Create(FTy, llvm::Function::InternalLinkage,
+                                     Name, Context->Module);
     F->addFnAttr(llvm::Attribute::StrictFP);
+    if (Context->Profile && !Code->getInstrs().empty()) {
+      const uint32_t Offset = Code->getInstrs().front()->getOffset();
+      Context->ProfileFunctions.emplace(Offset, FuncID);
+      F->setEntryCount(Context->Profile->getEntryCount(Offset));
+    }
 
     Context->Functions.emplace_back(TypeIdx, F, Code.get());
   }
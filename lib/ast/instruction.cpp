@@ -8,7 +8,9 @@ namespace AST {
 /// Copy construtor. See "include/common/ast/instruction.h".
 BlockControlInstruction::BlockControlInstruction(
     const BlockControlInstruction &Instr)
-    : Instruction(Instr.Code, Instr.Offset), ResType(Instr.ResType) {
+    : Instruction(Instr.Code, Instr.Offset), ResType(Instr.ResType),
+      BlockParamNum(Instr.BlockParamNum), BlockResultNum(Instr.BlockResultNum),
+      IsArityResolved(Instr.IsArityResolved) {
   for (auto &It : Instr.Body) {
     if (auto Res = makeInstructionNode(*It.get())) {
       Body.push_back(std::move(*Res));
@@ -86,7 +88,9 @@ Expect<void> BlockControlInstruction::loadBinary(FileMgr &Mgr) {
 /// Copy construtor. See "include/common/ast/instruction.h".
 IfElseControlInstruction::IfElseControlInstruction(
     const IfElseControlInstruction &Instr)
-    : Instruction(Instr.Code, Instr.Offset), ResType(Instr.ResType) {
+    : Instruction(Instr.Code, Instr.Offset), ResType(Instr.ResType),
+      BlockParamNum(Instr.BlockParamNum), BlockResultNum(Instr.BlockResultNum),
+      IsArityResolved(Instr.IsArityResolved) {
   for (auto &It : Instr.IfStatement) {
     if (auto Res = makeInstructionNode(*It.get())) {
       IfStatement.push_back(std::move(*Res));
@@ -273,12 +277,10 @@ Expect<void> VariableInstruction::loadBinary(FileMgr &Mgr) {
 
 /// Load binary of memory instructions. See "include/common/ast/instruction.h".
 Expect<void> MemoryInstruction::loadBinary(FileMgr &Mgr) {
-  /// Read the 0x00 checking code in memory.grow and memory.size cases.
-  if (Code == OpCode::Memory__grow || Code == OpCode::Memory__size) {
+  /// Read the 0x00 checking code of the reserved memory index.
+  auto ReadZero = [&Mgr]() -> Expect<void> {
     if (auto Res = Mgr.readByte()) {
-      if (*Res == 0x00) {
-        return {};
-      } else {
+      if (*Res != 0x00) {
         LOG(ERROR) << ErrCode::InvalidGrammar;
         LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset() - 1);
         LOG(ERROR) << ErrInfo::InfoAST(ASTNodeAttr::Instruction);
@@ -290,6 +292,35 @@ Expect<void> MemoryInstruction::loadBinary(FileMgr &Mgr) {
       LOG(ERROR) << ErrInfo::InfoAST(ASTNodeAttr::Instruction);
       return Unexpect(Res);
     }
+    return {};
+  };
+  /// Read the data segment index.
+  auto ReadDataIdx = [this, &Mgr]() -> Expect<void> {
+    if (auto Res = Mgr.readU32()) {
+      DataIdx = *Res;
+    } else {
+      LOG(ERROR) << Res.error();
+      LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+      LOG(ERROR) << ErrInfo::InfoAST(ASTNodeAttr::Instruction);
+      return Unexpect(Res);
+    }
+    return {};
+  };
+
+  switch (Code) {
+  case OpCode::Memory__grow:
+  case OpCode::Memory__size:
+  case OpCode::Memory__fill:
+    return ReadZero();
+  case OpCode::Memory__copy:
+    /// Destination and source memory indices.
+    return ReadZero().and_then(ReadZero);
+  case OpCode::Memory__init:
+    return ReadDataIdx().and_then(ReadZero);
+  case OpCode::Data__drop:
+    return ReadDataIdx();
+  default:
+    break;
   }
 
   /// Read memory arguments.
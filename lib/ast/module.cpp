@@ -2,9 +2,18 @@
 #include "common/ast/module.h"
 #include "support/log.h"
 
+#include <unistd.h>
+
 namespace SSVM {
 namespace AST {
 
+/// Destructor of Module node. See "include/ast/module.h".
+Module::~Module() {
+  if (ImageFD >= 0) {
+    close(ImageFD);
+  }
+}
+
 /// Load binary to construct Module node. See "include/ast/module.h".
 Expect<void> Module::loadBinary(FileMgr &Mgr) {
   /// Read Magic and Version sequences.
@@ -57,15 +66,15 @@ Expect<void> Module::loadBinary(FileMgr &Mgr) {
     }
 
     switch (NewSectionId) {
-    case 0x00:
-      if (CustomSec == nullptr) {
-        CustomSec = std::make_unique<CustomSection>();
-      }
-      if (auto Res = CustomSec->loadBinary(Mgr); !Res) {
+    case 0x00: {
+      auto NewCustomSec = std::make_unique<CustomSection>();
+      if (auto Res = NewCustomSec->loadBinary(Mgr); !Res) {
         LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
         return Unexpect(Res);
       }
+      CustomSecs.push_back(std::move(NewCustomSec));
       break;
+    }
     case 0x01:
       if (TypeSec == nullptr) {
         TypeSec = std::make_unique<TypeSection>();
@@ -151,6 +160,7 @@ Expect<void> Module::loadBinary(FileMgr &Mgr) {
       if (CodeSec == nullptr) {
         CodeSec = std::make_unique<CodeSection>();
       }
+      CodeSec->setSkipBody(IsSkipFunctionBody);
       if (auto Res = CodeSec->loadBinary(Mgr); !Res) {
         LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
         return Unexpect(Res);
@@ -165,6 +175,15 @@ Expect<void> Module::loadBinary(FileMgr &Mgr) {
         return Unexpect(Res);
       }
       break;
+    case 0x0C:
+      if (DataCountSec == nullptr) {
+        DataCountSec = std::make_unique<DataCountSection>();
+      }
+      if (auto Res = DataCountSec->loadBinary(Mgr); !Res) {
+        LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+        return Unexpect(Res);
+      }
+      break;
     default:
       LOG(ERROR) << ErrCode::InvalidGrammar;
       LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset() - 1);
@@ -172,43 +191,63 @@ Expect<void> Module::loadBinary(FileMgr &Mgr) {
       return Unexpect(ErrCode::InvalidGrammar);
     }
   }
+
+  /// Data count section must match the count of data segments.
+  if (DataCountSec) {
+    const size_t DataCnt = DataSec ? DataSec->getContent().size() : 0;
+    if (DataCountSec->getContent() != DataCnt) {
+      LOG(ERROR) << ErrCode::InvalidGrammar;
+      LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+      LOG(ERROR) << ErrInfo::InfoAST(ASTNodeAttr::Sec_DataCount);
+      return Unexpect(ErrCode::InvalidGrammar);
+    }
+  }
   return {};
 }
 
 /// Load compiled function from loadable manager. See "include/ast/module.h".
 Expect<void> Module::loadCompiled(LDMgr &Mgr) {
-  if (ExportSec) {
-    for (auto &ExpDesc : ExportSec->getContent()) {
-      const std::string Name = toExportName(ExpDesc->getExternalName());
-      switch (ExpDesc->getExternalType()) {
-      case ExternalType::Function:
-      case ExternalType::Global:
-        if (void *Symbol = Mgr.getRawSymbol(Name.c_str())) {
-          ExpDesc->setSymbol(Symbol);
-        } else {
-          LOG(ERROR) << ErrCode::InvalidGlobalIdx;
-          LOG(ERROR) << ErrInfo::InfoAST(ASTNodeAttr::Desc_Export);
-          LOG(ERROR) << ErrInfo::InfoAST(ASTNodeAttr::Sec_Export);
-          LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
-          return Unexpect(ErrCode::InvalidGlobalIdx);
+  /// Binaries without the strategy rely on guard pages.
+  Bounds = BoundsCheck::GuardPage;
+  if (const auto *Strategy = Mgr.getSharedSymbol<uint8_t>("bounds")) {
+    if (*Strategy > static_cast<uint8_t>(BoundsCheck::Mask)) {
+      LOG(ERROR) << ErrCode::InvalidGrammar;
+      LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+      return Unexpect(ErrCode::InvalidGrammar);
+    }
+    Bounds = static_cast<BoundsCheck>(*Strategy);
+  }
+  if (CodeSec) {
+    /// Wrappers of the functions, indexed by the code segments.
+    auto *const *Wrappers = Mgr.getSymbol<void *const>("wrappers");
+    if (Wrappers == nullptr) {
+      LOG(ERROR) << ErrCode::InvalidGrammar;
+      LOG(ERROR) << ErrInfo::InfoAST(ASTNodeAttr::Sec_Code);
+      LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+      return Unexpect(ErrCode::InvalidGrammar);
+    }
+    const auto CodeSegs = CodeSec->getContent();
+    for (size_t I = 0; I < CodeSegs.size(); ++I) {
+      CodeSegs[I]->setSymbol(Wrappers[I]);
+    }
+  }
+  if (DataSec && Mgr.getFD() >= 0) {
+    /// Page aligned images of the data segments are optional. The file
+    /// descriptor of the loadable manager is closed when loading the next
+    /// binary, so the module maps the images through its own duplicate.
+    const auto DataSegs = DataSec->getContent();
+    for (size_t I = 0; I < DataSegs.size(); ++I) {
+      const std::string Name = "wasm.data." + std::to_string(I);
+      if (const auto *Image = Mgr.getSharedSymbol<const Byte>(Name.c_str())) {
+        if (auto Offset = Mgr.getFileOffset(Image)) {
+          if (ImageFD < 0 && (ImageFD = dup(Mgr.getFD())) < 0) {
+            break;
+          }
+          DataSegs[I]->setImage(ImageFD, *Offset);
         }
-        break;
-      case ExternalType::Table:
-      case ExternalType::Memory:
-        break;
-      default:
-        LOG(ERROR) << ErrCode::InvalidMemoryIdx;
-        LOG(ERROR) << ErrInfo::InfoAST(ASTNodeAttr::Desc_Export);
-        LOG(ERROR) << ErrInfo::InfoAST(ASTNodeAttr::Sec_Export);
-        LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
-        return Unexpect(ErrCode::InvalidMemoryIdx);
       }
     }
   }
-  if (MemorySec) {
-    auto &MemType = MemorySec->getContent().front();
-    MemType->setSymbol(Mgr.getRawSymbol("mem"));
-  }
   return {};
 }
 
@@ -29,15 +29,146 @@ Expect<void> Section::loadSize(FileMgr &Mgr) {
 
 /// Load content of custom section. See "include/ast/section.h".
 Expect<void> CustomSection::loadContent(FileMgr &Mgr) {
-  /// Read all raw bytes.
-  if (auto Res = Mgr.readBytes(ContentSize)) {
-    Content = *Res;
+  if (ContentSize == 0) {
+    ContentOffset = Mgr.getOffset();
+    return {};
+  }
+  const uint32_t StartOffset = Mgr.getOffset();
+  /// Read name of custom section.
+  if (auto Res = Mgr.readName()) {
+    Name = std::move(*Res);
   } else {
     LOG(ERROR) << Res.error();
     LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
     LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
     return Unexpect(Res);
   }
+  ContentOffset = Mgr.getOffset();
+  if (ContentOffset - StartOffset > ContentSize) {
+    LOG(ERROR) << ErrCode::InvalidGrammar;
+    LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+    LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
+  ContentLength = ContentSize - (ContentOffset - StartOffset);
+
+  if (Name == "name") {
+    /// Decode the name section now. Errors in its content do not invalidate
+    /// the module, so the names are dropped if malformed.
+    if (auto Res = Mgr.readBytes(ContentLength)) {
+      FileMgrVector NameMgr;
+      auto NameSec = std::make_unique<NameSection>();
+      if (NameMgr.setCode(std::move(*Res)) && NameSec->loadBinary(NameMgr)) {
+        Names = std::move(NameSec);
+      }
+      return {};
+    } else {
+      LOG(ERROR) << Res.error();
+      LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+      LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+      return Unexpect(Res);
+    }
+  }
+
+  /// Skip the raw bytes. Content will be fetched on demand.
+  if (auto Res = Mgr.skipBytes(ContentLength); !Res) {
+    LOG(ERROR) << Res.error();
+    LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+    LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+/// Load subsections of name section. See "include/ast/section.h".
+Expect<void> NameSection::loadBinary(FileMgr &Mgr) {
+  while (true) {
+    uint8_t SubSecId = 0x00;
+    uint32_t SubSecSize = 0;
+    /// If not read subsection ID, seems the end of content and break.
+    if (auto Res = Mgr.readByte()) {
+      SubSecId = *Res;
+    } else if (Res.error() == ErrCode::EndOfFile) {
+      break;
+    } else {
+      LOG(ERROR) << Res.error();
+      LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+      LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+      return Unexpect(Res);
+    }
+    if (auto Res = Mgr.readU32()) {
+      SubSecSize = *Res;
+    } else {
+      LOG(ERROR) << Res.error();
+      LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+      LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+      return Unexpect(Res);
+    }
+    const uint32_t StartOffset = Mgr.getOffset();
+
+    switch (SubSecId) {
+    case 0x00:
+      /// Module name subsection.
+      if (auto Res = Mgr.readName()) {
+        ModuleName = std::move(*Res);
+      } else {
+        LOG(ERROR) << Res.error();
+        LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+        LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+        return Unexpect(Res);
+      }
+      break;
+    case 0x01: {
+      /// Function names subsection.
+      uint32_t VecCnt = 0;
+      if (auto Res = Mgr.readU32()) {
+        VecCnt = *Res;
+      } else {
+        LOG(ERROR) << Res.error();
+        LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+        LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+        return Unexpect(Res);
+      }
+      for (uint32_t i = 0; i < VecCnt; ++i) {
+        uint32_t FuncIdx = 0;
+        if (auto Res = Mgr.readU32()) {
+          FuncIdx = *Res;
+        } else {
+          LOG(ERROR) << Res.error();
+          LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+          LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+          return Unexpect(Res);
+        }
+        if (auto Res = Mgr.readName()) {
+          FunctionNames.insert_or_assign(FuncIdx, std::move(*Res));
+        } else {
+          LOG(ERROR) << Res.error();
+          LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+          LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+          return Unexpect(Res);
+        }
+      }
+      break;
+    }
+    default:
+      /// Other subsections are not used.
+      if (auto Res = Mgr.skipBytes(SubSecSize); !Res) {
+        LOG(ERROR) << Res.error();
+        LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+        LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+        return Unexpect(Res);
+      }
+      break;
+    }
+
+    /// Subsection size should match the read content.
+    if (Mgr.getOffset() - StartOffset != SubSecSize) {
+      LOG(ERROR) << ErrCode::InvalidGrammar;
+      LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+      LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+      return Unexpect(ErrCode::InvalidGrammar);
+    }
+  }
   return {};
 }
 
@@ -109,6 +240,19 @@ Expect<void> StartSection::loadContent(FileMgr &Mgr) {
   return {};
 }
 
+/// Load content of data count section. See "include/ast/section.h".
+Expect<void> DataCountSection::loadContent(FileMgr &Mgr) {
+  if (auto Res = Mgr.readU32()) {
+    Content = *Res;
+  } else {
+    LOG(ERROR) << Res.error();
+    LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+    LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+    return Unexpect(Res);
+  }
+  return {};
+}
+
 /// Load vector of element section. See "include/ast/section.h".
 Expect<void> ElementSection::loadContent(FileMgr &Mgr) {
   return Section::loadToVector(Mgr, Content);
@@ -116,7 +260,28 @@ Expect<void> ElementSection::loadContent(FileMgr &Mgr) {
 
 /// Load vector of code section. See "include/ast/section.h".
 Expect<void> CodeSection::loadContent(FileMgr &Mgr) {
-  return Section::loadToVector(Mgr, Content);
+  if (!IsSkipBody) {
+    return Section::loadToVector(Mgr, Content);
+  }
+  uint32_t VecCnt = 0;
+  if (auto Res = Mgr.readU32()) {
+    VecCnt = *Res;
+  } else {
+    LOG(ERROR) << Res.error();
+    LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+    LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+    return Unexpect(Res);
+  }
+  for (uint32_t i = 0; i < VecCnt; ++i) {
+    auto NewContent = std::make_unique<CodeSegment>();
+    if (auto Res = NewContent->skipBinary(Mgr)) {
+      Content.push_back(std::move(NewContent));
+    } else {
+      LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+      return Unexpect(Res);
+    }
+  }
+  return {};
 }
 
 /// Load vector of data section. See "include/ast/section.h".
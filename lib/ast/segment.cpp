@@ -112,6 +112,7 @@ Expect<void> CodeSegment::loadBinary(FileMgr &Mgr) {
       LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
       return Unexpect(Res);
     }
+    LocalNum += LocalCnt;
     Locals.push_back(std::make_pair(LocalCnt, LocalType));
   }
 
@@ -124,22 +125,74 @@ Expect<void> CodeSegment::loadBinary(FileMgr &Mgr) {
   return {};
 }
 
+/// Skip binary of CodeSegment node. See "include/common/ast/segment.h".
+Expect<void> CodeSegment::skipBinary(FileMgr &Mgr) {
+  /// Read the code segment size.
+  if (auto Res = Mgr.readU32()) {
+    SegSize = *Res;
+  } else {
+    LOG(ERROR) << Res.error();
+    LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+    LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+    return Unexpect(Res);
+  }
+
+  /// Skip the locals and function body.
+  if (auto Res = Mgr.skipBytes(SegSize); !Res) {
+    LOG(ERROR) << Res.error();
+    LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+    LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+    return Unexpect(Res);
+  }
+  Expr = std::make_unique<Expression>();
+  IsBodySkipped = true;
+  return {};
+}
+
 /// Load binary of DataSegment node. See "include/common/ast/segment.h".
 Expect<void> DataSegment::loadBinary(FileMgr &Mgr) {
-  /// Read target memory index.
+  /// Read the segment flags: 0 for active segments of memory 0, 1 for passive
+  /// segments, and 2 for active segments with the memory index.
+  uint32_t Flags = 0;
   if (auto Res = Mgr.readU32()) {
-    MemoryIdx = *Res;
+    Flags = *Res;
   } else {
     LOG(ERROR) << Res.error();
     LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
     LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
     return Unexpect(Res);
   }
+  switch (Flags) {
+  case 0x00:
+    MemoryIdx = 0;
+    break;
+  case 0x01:
+    IsPassive = true;
+    break;
+  case 0x02:
+    /// Read target memory index.
+    if (auto Res = Mgr.readU32()) {
+      MemoryIdx = *Res;
+    } else {
+      LOG(ERROR) << Res.error();
+      LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset());
+      LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+      return Unexpect(Res);
+    }
+    break;
+  default:
+    LOG(ERROR) << ErrCode::InvalidGrammar;
+    LOG(ERROR) << ErrInfo::InfoLoading(Mgr.getOffset() - 1);
+    LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
 
   /// Read the offset expression.
-  if (auto Res = Segment::loadExpression(Mgr); !Res) {
-    LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
-    return Unexpect(Res);
+  if (!IsPassive) {
+    if (auto Res = Segment::loadExpression(Mgr); !Res) {
+      LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
+      return Unexpect(Res);
+    }
   }
 
   /// Read initialization data.
@@ -12,7 +12,11 @@ Interpreter::runBlockOp(Runtime::StoreManager &StoreMgr,
                         const AST::BlockControlInstruction &Instr) {
   /// Get result type for arity.
   uint32_t Locals = 0, Arity = 0;
-  if (std::holds_alternative<ValType>(Instr.getBlockType())) {
+  if (Instr.isArityResolved()) {
+    /// Arity resolved in validation.
+    Locals = Instr.getBlockParamNum();
+    Arity = Instr.getBlockResultNum();
+  } else if (std::holds_alternative<ValType>(Instr.getBlockType())) {
     Arity = (std::get<ValType>(Instr.getBlockType()) == ValType::None) ? 0 : 1;
   } else {
     /// Get function type at index x.
@@ -31,7 +35,10 @@ Expect<void> Interpreter::runLoopOp(Runtime::StoreManager &StoreMgr,
                                     const AST::BlockControlInstruction &Instr) {
   /// Get result type for arity.
   uint32_t Arity = 0;
-  if (std::holds_alternative<uint32_t>(Instr.getBlockType())) {
+  if (Instr.isArityResolved()) {
+    /// Arity resolved in validation.
+    Arity = Instr.getBlockParamNum();
+  } else if (std::holds_alternative<uint32_t>(Instr.getBlockType())) {
     /// Get function type at index x.
     const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
     const auto *FuncType =
@@ -51,7 +58,11 @@ Interpreter::runIfElseOp(Runtime::StoreManager &StoreMgr,
 
   /// Get result type for arity.
   uint32_t Locals = 0, Arity = 0;
-  if (std::holds_alternative<ValType>(Instr.getBlockType())) {
+  if (Instr.isArityResolved()) {
+    /// Arity resolved in validation.
+    Locals = Instr.getBlockParamNum();
+    Arity = Instr.getBlockResultNum();
+  } else if (std::holds_alternative<ValType>(Instr.getBlockType())) {
     Arity = (std::get<ValType>(Instr.getBlockType()) == ValType::None) ? 0 : 1;
   } else {
     /// Get function type at index x.
@@ -62,6 +73,10 @@ Interpreter::runIfElseOp(Runtime::StoreManager &StoreMgr,
     Arity = FuncType->Returns.size();
   }
 
+  if (Profile) {
+    Profile->addBranch(Instr.getOffset(), retrieveValue<uint32_t>(Cond) != 0);
+  }
+
   /// If non-zero, run if-statement; else, run else-statement.
   if (retrieveValue<uint32_t>(Cond) != 0) {
     const auto &IfStatement = Instr.getIfStatement();
@@ -85,6 +100,9 @@ Expect<void> Interpreter::runBrOp(Runtime::StoreManager &StoreMgr,
 Expect<void> Interpreter::runBrIfOp(Runtime::StoreManager &StoreMgr,
                                     const AST::BrControlInstruction &Instr) {
   ValVariant Cond = StackMgr.pop();
+  if (Profile) {
+    Profile->addBranch(Instr.getOffset(), retrieveValue<uint32_t>(Cond) != 0);
+  }
   if (retrieveValue<uint32_t>(Cond) != 0) {
     return runBrOp(StoreMgr, Instr);
   }
@@ -154,6 +172,14 @@ Interpreter::runCallIndirectOp(Runtime::StoreManager &StoreMgr,
                                         FuncType.Params, FuncType.Returns);
     return Unexpect(ErrCode::IndirectCallTypeMismatch);
   }
+
+  /// Record the target if it is a function of the same module.
+  if (Profile && !FuncInst->isHostFunction() &&
+      FuncInst->getModuleAddr() == StackMgr.getModuleAddr() &&
+      !FuncInst->getInstrs().empty()) {
+    Profile->addIndirectCall(Instr.getOffset(),
+                             FuncInst->getInstrs().front()->getOffset());
+  }
   return enterFunction(StoreMgr, *FuncInst);
 }
 
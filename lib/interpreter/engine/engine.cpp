@@ -8,16 +8,67 @@
 #include "support/measure.h"
 #include "support/time.h"
 
+#include <algorithm>
+#include <array>
+#include <utility>
+
 namespace SSVM {
 namespace Interpreter {
 
-Interpreter *Interpreter::This = nullptr;
-uint32_t Interpreter::TrapCodeProxy = 0;
-std::jmp_buf *Interpreter::TrapJump = nullptr;
+namespace {
+/// Signals raised by traps in compiled code.
+constexpr std::array<int, 4> TrapSignals = {SIGILL, SIGABRT, SIGFPE, SIGSEGV};
+/// Signal actions before installing the trap handlers.
+std::array<struct sigaction, TrapSignals.size()> PrevActions;
+} // namespace
+
+thread_local sigjmp_buf *Interpreter::TrapJump = nullptr;
+thread_local ExecutionContext *Interpreter::CurrentExecCtx = nullptr;
+thread_local sigjmp_buf *Interpreter::AccessJump = nullptr;
 
 using TimerTag = Support::TimerTag;
 
-void Interpreter::signalHandler(int Signal, siginfo_t *Siginfo, void *) {
+void Interpreter::installSignalHandlers() {
+  [[maybe_unused]] static const bool Installed = []() {
+    struct sigaction Action {};
+    Action.sa_sigaction = &signalHandler;
+    /// The signal is not blocked in the handler, so that the jump buffers
+    /// do not need to save and restore the signal mask.
+    Action.sa_flags = SA_SIGINFO | SA_NODEFER;
+    for (size_t I = 0; I < TrapSignals.size(); ++I) {
+      sigaction(TrapSignals[I], &Action, &PrevActions[I]);
+    }
+    return true;
+  }();
+}
+
+void Interpreter::signalHandler(int Signal, siginfo_t *Siginfo,
+                                void *Context) {
+  if (Signal == SIGSEGV && AccessJump != nullptr) {
+    /// Memory access out of bounds in interpreter.
+    siglongjmp(*std::exchange(AccessJump, nullptr), 1);
+  }
+  if (TrapJump == nullptr) {
+    /// Not in compiled code: forward to the previous action.
+    for (size_t I = 0; I < TrapSignals.size(); ++I) {
+      if (TrapSignals[I] != Signal) {
+        continue;
+      }
+      const auto &Prev = PrevActions[I];
+      if (Prev.sa_flags & SA_SIGINFO) {
+        Prev.sa_sigaction(Signal, Siginfo, Context);
+      } else if (Prev.sa_handler == SIG_DFL) {
+        /// Restore the default action, and it takes effect when the faulting
+        /// instruction or abort() raises the signal again.
+        sigaction(Signal, &Prev, nullptr);
+      } else if (Prev.sa_handler != SIG_IGN) {
+        Prev.sa_handler(Signal);
+      }
+      return;
+    }
+    return;
+  }
+
   int Status;
   switch (Signal) {
   case SIGSEGV:
@@ -29,40 +80,61 @@ void Interpreter::signalHandler(int Signal, siginfo_t *Siginfo, void *) {
     break;
   case SIGILL:
   case SIGABRT:
-    Status = TrapCodeProxy;
+    Status = CurrentExecCtx->TrapCode;
     break;
   }
-  siglongjmp(*This->TrapJump, Status);
+  siglongjmp(*TrapJump, Status);
 }
 
-void Interpreter::callProxy(const uint32_t FuncIndex, const ValVariant *Args,
+void Interpreter::callProxy(ExecutionContext *ExecCtx,
+                            const uint32_t FuncIndex, const ValVariant *Args,
                             ValVariant *Rets) {
-  {
-    std::signal(SIGILL, SIG_DFL);
-    std::signal(SIGABRT, SIG_DFL);
-    std::signal(SIGFPE, SIG_DFL);
-    std::signal(SIGSEGV, SIG_DFL);
-  }
-  auto SavedTrapJump = TrapJump;
-  This->call(FuncIndex, Args, Rets);
+  static_cast<Interpreter *>(ExecCtx->Host)->call(FuncIndex, Args, Rets);
+}
+
+void Interpreter::hostFuncProxy(ExecutionContext *ExecCtx, void *Func,
+                                ValVariant *Args, ValVariant *Rets) {
+  auto *This = static_cast<Interpreter *>(ExecCtx->Host);
+  /// Signals raised in host functions are not traps of the caller.
+  sigjmp_buf *SavedTrapJump = std::exchange(TrapJump, nullptr);
+  auto Res = This->callHost(*static_cast<Runtime::HostFunctionBase *>(Func),
+                            Args, Rets);
   TrapJump = SavedTrapJump;
-  {
-    struct sigaction Action {};
-    Action.sa_sigaction = &signalHandler;
-    Action.sa_flags = SA_SIGINFO;
-    sigaction(SIGILL, &Action, nullptr);
-    sigaction(SIGABRT, &Action, nullptr);
-    sigaction(SIGFPE, &Action, nullptr);
-    sigaction(SIGSEGV, &Action, nullptr);
+  if (!Res) {
+    siglongjmp(*TrapJump, uint32_t(Res.error()));
+  }
+}
+
+uint32_t Interpreter::memGrowProxy(ExecutionContext *ExecCtx,
+                                   const uint32_t NewSize) {
+  return static_cast<Interpreter *>(ExecCtx->Host)->memGrow(NewSize);
+}
+
+void Interpreter::memInitProxy(ExecutionContext *ExecCtx,
+                               const uint32_t DataIdx, const uint32_t Dst,
+                               const uint32_t Src, const uint32_t Length) {
+  auto *This = static_cast<Interpreter *>(ExecCtx->Host);
+  if (auto Res = This->memInit(DataIdx, Dst, Src, Length); !Res) {
+    siglongjmp(*TrapJump, uint32_t(Res.error()));
   }
 }
 
-uint32_t Interpreter::memGrowProxy(const uint32_t NewSize) {
-  return This->memGrow(NewSize);
+void Interpreter::dataDropProxy(ExecutionContext *ExecCtx,
+                                const uint32_t DataIdx) {
+  auto *This = static_cast<Interpreter *>(ExecCtx->Host);
+  if (auto Res = This->dataDrop(DataIdx); !Res) {
+    siglongjmp(*TrapJump, uint32_t(Res.error()));
+  }
 }
 
 void Interpreter::call(const uint32_t FuncIndex, const ValVariant *Args,
                        ValVariant *Rets) {
+  /// The costs of compiled code are accumulated in the execution context.
+  ExecutionContext *ExecCtx = CurrentExecCtx;
+  if (Measure) {
+    Measure->getCostSum() = ExecCtx->CostSum;
+  }
+
   const auto *ModInst = *CurrentStore->getModule(StackMgr.getModuleAddr());
   const uint32_t FuncAddr = *ModInst->getFuncAddr(FuncIndex);
   const auto *FuncInst = *CurrentStore->getFunction(FuncAddr);
@@ -73,25 +145,96 @@ void Interpreter::call(const uint32_t FuncIndex, const ValVariant *Args,
   for (unsigned I = 0; I < ParamsSize; ++I) {
     StackMgr.push(Args[I]);
   }
-  if (auto Res = enterFunction(*CurrentStore, *FuncInst); !Res) {
+  /// Signals raised outside compiled code are not traps of the caller.
+  sigjmp_buf *SavedTrapJump = std::exchange(TrapJump, nullptr);
+  auto Res = enterFunction(*CurrentStore, *FuncInst);
+  TrapJump = SavedTrapJump;
+  if (Measure) {
+    ExecCtx->CostSum = Measure->getCostSum();
+  }
+  if (!Res) {
     siglongjmp(*TrapJump, uint32_t(Res.error()));
     return;
   }
   for (unsigned I = 0; I < ReturnsSize; ++I) {
     Rets[ReturnsSize - 1 - I] = StackMgr.pop();
   }
+  /// The callee may have grown and moved the memory.
+  if (auto *MemInst = getMemInstByIdx(*CurrentStore, 0)) {
+    ExecCtx->Memory = MemInst->getDataPtr();
+  }
+}
+
+Expect<void> Interpreter::callHost(Runtime::HostFunctionBase &HostFunc,
+                                   ValVariant *Args, ValVariant *Rets) {
+  /// The costs of compiled code are accumulated in the execution context.
+  ExecutionContext *ExecCtx = CurrentExecCtx;
+  auto *MemoryInst = getMemInstByIdx(*CurrentStore, 0);
+
+  if (Measure) {
+    /// Check host function cost.
+    ExecCtx->CostSum += HostFunc.getCost();
+    if (ExecCtx->CostSum > ExecCtx->CostLimit) {
+      ExecCtx->CostSum = ExecCtx->CostLimit;
+      LOG(ERROR) << ErrCode::CostLimitExceeded;
+      return Unexpect(ErrCode::CostLimitExceeded);
+    }
+    /// Start recording time of running host function.
+    Measure->getTimeRecorder().stopRecord(TimerTag::Execution);
+    Measure->getTimeRecorder().startRecord(TimerTag::HostFunc);
+  }
+
+  /// Run host function with the argument buffers of compiled code.
+  auto Ret = HostFunc.call(MemoryInst, Args, Rets);
+
+  /// The host function may grow and move the memory.
+  if (MemoryInst) {
+    ExecCtx->Memory = MemoryInst->getDataPtr();
+  }
+
+  if (Measure) {
+    /// Stop recording time of running host function.
+    Measure->getTimeRecorder().stopRecord(TimerTag::HostFunc);
+    Measure->getTimeRecorder().startRecord(TimerTag::Execution);
+  }
+
+  if (!Ret && Ret.error() == ErrCode::ExecutionFailed) {
+    LOG(ERROR) << Ret.error();
+  }
+  return Ret;
 }
 
 uint32_t Interpreter::memGrow(const uint32_t NewSize) {
   auto &MemInst = *getMemInstByIdx(*CurrentStore, 0);
   const uint32_t CurrPageSize = MemInst.getDataPageSize();
   if (MemInst.growPage(NewSize)) {
+    /// Memories without guard pages and maximum size may be moved.
+    CurrentExecCtx->Memory = MemInst.getDataPtr();
     return CurrPageSize;
   } else {
     return -1;
   }
 }
 
+Expect<void> Interpreter::memInit(const uint32_t DataIdx, const uint32_t Dst,
+                                  const uint32_t Src, const uint32_t Length) {
+  auto &MemInst = *getMemInstByIdx(*CurrentStore, 0);
+  const auto *ModInst = *CurrentStore->getModule(StackMgr.getModuleAddr());
+  const auto Data = *ModInst->getDataSeg(DataIdx);
+  if (static_cast<uint64_t>(Src) + static_cast<uint64_t>(Length) >
+      Data.size()) {
+    LOG(ERROR) << ErrCode::MemoryOutOfBounds;
+    LOG(ERROR) << ErrInfo::InfoBoundary(Src, Length, Data.size());
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  return MemInst.setBytes(Data.subspan(Src, Length), Dst, 0, Length);
+}
+
+Expect<void> Interpreter::dataDrop(const uint32_t DataIdx) {
+  auto *ModInst = *CurrentStore->getModule(StackMgr.getModuleAddr());
+  return ModInst->dropDataSeg(DataIdx);
+}
+
 Expect<void> Interpreter::runExpression(Runtime::StoreManager &StoreMgr,
                                         const AST::InstrVec &Instrs) {
   /// Set instruction vector to instruction provider.
@@ -309,7 +452,14 @@ Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
 
 Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
                                   const AST::MemoryInstruction &Instr) {
+  /// Data drop needs no memory instance.
+  if (Instr.getOpCode() == OpCode::Data__drop) {
+    return runDataDropOp(StoreMgr, Instr);
+  }
   auto *MemInst = getMemInstByIdx(StoreMgr, 0);
+  if (MemoryFastPath && MemInst->hasGuardPages()) {
+    return executeUnchecked(StoreMgr, *MemInst, Instr);
+  }
   switch (Instr.getOpCode()) {
   case OpCode::I32__load:
     return runLoadOp<uint32_t>(*MemInst, Instr);
@@ -361,6 +511,81 @@ Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
     return runMemoryGrowOp(*MemInst);
   case OpCode::Memory__size:
     return runMemorySizeOp(*MemInst);
+  case OpCode::Memory__init:
+    return runMemoryInitOp(StoreMgr, *MemInst, Instr);
+  case OpCode::Memory__copy:
+    return runMemoryCopyOp(*MemInst, Instr);
+  case OpCode::Memory__fill:
+    return runMemoryFillOp(*MemInst, Instr);
+  default:
+    LOG(ERROR) << ErrCode::InstrTypeMismatch;
+    LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
+                                           Instr.getOffset());
+    return Unexpect(ErrCode::InstrTypeMismatch);
+  }
+}
+
+Expect<void>
+Interpreter::executeUnchecked(Runtime::StoreManager &StoreMgr,
+                              Runtime::Instance::MemoryInstance &MemInst,
+                              const AST::MemoryInstruction &Instr) {
+  switch (Instr.getOpCode()) {
+  case OpCode::I32__load:
+    return runLoadUncheckedOp<uint32_t, uint32_t>(MemInst, Instr);
+  case OpCode::I64__load:
+    return runLoadUncheckedOp<uint64_t, uint64_t>(MemInst, Instr);
+  case OpCode::F32__load:
+    return runLoadUncheckedOp<float, float>(MemInst, Instr);
+  case OpCode::F64__load:
+    return runLoadUncheckedOp<double, double>(MemInst, Instr);
+  case OpCode::I32__load8_s:
+    return runLoadUncheckedOp<int32_t, int8_t>(MemInst, Instr);
+  case OpCode::I32__load8_u:
+    return runLoadUncheckedOp<uint32_t, uint8_t>(MemInst, Instr);
+  case OpCode::I32__load16_s:
+    return runLoadUncheckedOp<int32_t, int16_t>(MemInst, Instr);
+  case OpCode::I32__load16_u:
+    return runLoadUncheckedOp<uint32_t, uint16_t>(MemInst, Instr);
+  case OpCode::I64__load8_s:
+    return runLoadUncheckedOp<int64_t, int8_t>(MemInst, Instr);
+  case OpCode::I64__load8_u:
+    return runLoadUncheckedOp<uint64_t, uint8_t>(MemInst, Instr);
+  case OpCode::I64__load16_s:
+    return runLoadUncheckedOp<int64_t, int16_t>(MemInst, Instr);
+  case OpCode::I64__load16_u:
+    return runLoadUncheckedOp<uint64_t, uint16_t>(MemInst, Instr);
+  case OpCode::I64__load32_s:
+    return runLoadUncheckedOp<int64_t, int32_t>(MemInst, Instr);
+  case OpCode::I64__load32_u:
+    return runLoadUncheckedOp<uint64_t, uint32_t>(MemInst, Instr);
+  case OpCode::I32__store:
+    return runStoreUncheckedOp<uint32_t, uint32_t>(MemInst, Instr);
+  case OpCode::I64__store:
+    return runStoreUncheckedOp<uint64_t, uint64_t>(MemInst, Instr);
+  case OpCode::F32__store:
+    return runStoreUncheckedOp<float, float>(MemInst, Instr);
+  case OpCode::F64__store:
+    return runStoreUncheckedOp<double, double>(MemInst, Instr);
+  case OpCode::I32__store8:
+    return runStoreUncheckedOp<uint32_t, uint8_t>(MemInst, Instr);
+  case OpCode::I32__store16:
+    return runStoreUncheckedOp<uint32_t, uint16_t>(MemInst, Instr);
+  case OpCode::I64__store8:
+    return runStoreUncheckedOp<uint64_t, uint8_t>(MemInst, Instr);
+  case OpCode::I64__store16:
+    return runStoreUncheckedOp<uint64_t, uint16_t>(MemInst, Instr);
+  case OpCode::I64__store32:
+    return runStoreUncheckedOp<uint64_t, uint32_t>(MemInst, Instr);
+  case OpCode::Memory__grow:
+    return runMemoryGrowOp(MemInst);
+  case OpCode::Memory__size:
+    return runMemorySizeOp(MemInst);
+  case OpCode::Memory__init:
+    return runMemoryInitOp(StoreMgr, MemInst, Instr);
+  case OpCode::Memory__copy:
+    return runMemoryCopyOp(MemInst, Instr);
+  case OpCode::Memory__fill:
+    return runMemoryFillOp(MemInst, Instr);
   default:
     LOG(ERROR) << ErrCode::InstrTypeMismatch;
     LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
@@ -674,6 +899,26 @@ Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
 }
 
 Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr) {
+  if (!MemoryFastPath) {
+    return executeInstrs(StoreMgr);
+  }
+  /// The faults of memory accesses without bounds checks jump back here. The
+  /// outer buffer is restored when leaving, since the instructions may be run
+  /// recursively from compiled code.
+  sigjmp_buf JumpBuffer;
+  sigjmp_buf *const SavedAccessBuffer = AccessBuffer;
+  if (sigsetjmp(JumpBuffer, false) != 0) {
+    AccessBuffer = SavedAccessBuffer;
+    LOG(ERROR) << ErrCode::MemoryOutOfBounds;
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  AccessBuffer = &JumpBuffer;
+  auto Res = executeInstrs(StoreMgr);
+  AccessBuffer = SavedAccessBuffer;
+  return Res;
+}
+
+Expect<void> Interpreter::executeInstrs(Runtime::StoreManager &StoreMgr) {
   /// Run instructions until end.
   while (InstrPdr.getScopeSize() > 0) {
     const AST::Instruction *Instr = InstrPdr.getNextInstr();
@@ -799,6 +1044,11 @@ Interpreter::enterFunction(Runtime::StoreManager &StoreMgr,
     const size_t ArgsN = FuncType.Params.size();
     const size_t RetsN = FuncType.Returns.size();
 
+    /// Check stack limits for the new frame.
+    if (unlikely(!StackMgr.reserveFrame(RetsN))) {
+      LOG(ERROR) << ErrCode::CallStackExhausted;
+      return Unexpect(ErrCode::CallStackExhausted);
+    }
     StackMgr.pushFrame(Func.getModuleAddr(), /// Module address
                        ArgsN,                /// Arguments num
                        RetsN                 /// Returns num
@@ -807,34 +1057,51 @@ Interpreter::enterFunction(Runtime::StoreManager &StoreMgr,
     Span<ValVariant> Args = StackMgr.getTopSpan(ArgsN);
     std::vector<ValVariant> Rets(RetsN);
 
+    auto *ModInst = *StoreMgr.getModule(Func.getModuleAddr());
+    ExecutionContext *ExecCtx = &ModInst->getExecutionContext();
+    /// The memory may have been grown and moved by other instances or by the
+    /// interpreter since the last entry.
+    if (auto *MemInst = getMemInstByIdx(StoreMgr, 0)) {
+      ExecCtx->Memory = MemInst->getDataPtr();
+    }
+    ExecutionContext *SavedExecCtx = CurrentExecCtx;
+
     sigjmp_buf JumpBuffer;
+    sigjmp_buf *SavedTrapJump = TrapJump;
     CurrentStore = &StoreMgr;
+    CurrentExecCtx = ExecCtx;
     TrapJump = &JumpBuffer;
+    ExecCtx->EpochDeadline = EpochDeadline;
+    /// Continue the call depth of the interpreter frames, or of the compiled
+    /// caller when entered from an imported function call.
+    const uint32_t SavedCallDepth = ExecCtx->CallDepth;
+    ExecCtx->CallDepth = StackMgr.getFrameNum();
+    if (SavedExecCtx) {
+      ExecCtx->CallDepth =
+          std::max(ExecCtx->CallDepth, SavedExecCtx->CallDepth);
+    }
+    ExecCtx->CallDepthLimit = StackMgr.getFrameLimit();
+    if (Measure) {
+      ExecCtx->CostSum = Measure->getCostSum();
+      ExecCtx->CostLimit = Measure->getCostLimit();
+    }
 
-    const int Status = sigsetjmp(*TrapJump, true);
+    /// The signal handlers are installed once, and the signal mask is not
+    /// changed by them, so no system call is needed here.
+    const int Status = sigsetjmp(*TrapJump, false);
     if (Status == 0) {
-      {
-        struct sigaction Action {};
-        Action.sa_sigaction = &signalHandler;
-        Action.sa_flags = SA_SIGINFO;
-        sigaction(SIGILL, &Action, nullptr);
-        sigaction(SIGABRT, &Action, nullptr);
-        sigaction(SIGFPE, &Action, nullptr);
-        sigaction(SIGSEGV, &Action, nullptr);
-      }
-
-      CompiledFunc(Args.data(), Rets.data());
+      CompiledFunc(ExecCtx, Args.data(), Rets.data());
     }
 
-    {
-      std::signal(SIGILL, SIG_DFL);
-      std::signal(SIGABRT, SIG_DFL);
-      std::signal(SIGFPE, SIG_DFL);
-      std::signal(SIGSEGV, SIG_DFL);
+    TrapJump = SavedTrapJump;
+    CurrentExecCtx = SavedExecCtx;
+    ExecCtx->CallDepth = SavedCallDepth;
+    if (Measure) {
+      Measure->getCostSum() = (Status == int(ErrCode::CostLimitExceeded))
+                                  ? ExecCtx->CostLimit
+                                  : ExecCtx->CostSum;
     }
 
-    TrapJump = nullptr;
-
     if (Status != 0) {
       return Unexpect(ErrCode(Status));
     }
@@ -846,7 +1113,23 @@ Interpreter::enterFunction(Runtime::StoreManager &StoreMgr,
     StackMgr.popFrame();
     return {};
   } else {
-    /// Native function case: Push frame with locals and args.
+    /// Native function case: Check the epoch deadline on function entry.
+    if (auto Res = checkInterrupted(); !Res) {
+      return Unexpect(Res);
+    }
+    if (Profile && !Func.getInstrs().empty()) {
+      Profile->addEntry(Func.getInstrs().front()->getOffset());
+    }
+
+    /// Check stack limits for locals and operands once, and the value stack
+    /// will not be reallocated in this frame.
+    if (unlikely(!StackMgr.reserveFrame(Func.getLocalNum() +
+                                        Func.getMaxStackHeight()))) {
+      LOG(ERROR) << ErrCode::CallStackExhausted;
+      return Unexpect(ErrCode::CallStackExhausted);
+    }
+
+    /// Push frame with locals and args.
     StackMgr.pushFrame(Func.getModuleAddr(),   /// Module address
                        FuncType.Params.size(), /// Arguments num
                        FuncType.Returns.size() /// Returns num
@@ -893,6 +1176,10 @@ Expect<void> Interpreter::branchToLabel(Runtime::StoreManager &StoreMgr,
 
   /// Jump to the continuation of Label
   if (ContInstr != nullptr) {
+    /// Backward branch to a loop: check the epoch deadline.
+    if (auto Res = checkInterrupted(); !Res) {
+      return Unexpect(Res);
+    }
     return runLoopOp(StoreMgr, *ContInstr);
   }
   return {};
@@ -1,6 +1,10 @@
 // SPDX-License-Identifier: Apache-2.0
+#include "common/ast/instruction.h"
 #include "common/value.h"
 #include "interpreter/interpreter.h"
+#include "runtime/instance/memory.h"
+#include "runtime/instance/module.h"
+#include "support/log.h"
 
 namespace SSVM {
 namespace Interpreter {
@@ -27,5 +31,74 @@ Interpreter::runMemoryGrowOp(Runtime::Instance::MemoryInstance &MemInst) {
   return {};
 }
 
+Expect<void>
+Interpreter::runMemoryInitOp(Runtime::StoreManager &StoreMgr,
+                             Runtime::Instance::MemoryInstance &MemInst,
+                             const AST::MemoryInstruction &Instr) {
+  /// Pop the length, source, and destination from the stack.
+  const uint32_t N = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint32_t S = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint32_t D = retrieveValue<uint32_t>(StackMgr.pop());
+
+  /// Get the data segment in the module instance.
+  const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
+  const auto Data = *ModInst->getDataSeg(Instr.getDataIndex());
+
+  /// Check data segment boundary.
+  if (static_cast<uint64_t>(S) + static_cast<uint64_t>(N) > Data.size()) {
+    LOG(ERROR) << ErrCode::MemoryOutOfBounds;
+    LOG(ERROR) << ErrInfo::InfoBoundary(S, N, Data.size());
+    LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
+                                           Instr.getOffset());
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+
+  /// Copy the data to memory. Memory boundary is checked in setBytes.
+  if (auto Res = MemInst.setBytes(Data.subspan(S, N), D, 0, N); !Res) {
+    LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
+                                           Instr.getOffset());
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+Expect<void> Interpreter::runDataDropOp(Runtime::StoreManager &StoreMgr,
+                                        const AST::MemoryInstruction &Instr) {
+  auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
+  return ModInst->dropDataSeg(Instr.getDataIndex());
+}
+
+Expect<void>
+Interpreter::runMemoryCopyOp(Runtime::Instance::MemoryInstance &MemInst,
+                             const AST::MemoryInstruction &Instr) {
+  /// Pop the length, source, and destination from the stack.
+  const uint32_t N = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint32_t S = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint32_t D = retrieveValue<uint32_t>(StackMgr.pop());
+
+  if (auto Res = MemInst.copyBytes(D, S, N); !Res) {
+    LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
+                                           Instr.getOffset());
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+Expect<void>
+Interpreter::runMemoryFillOp(Runtime::Instance::MemoryInstance &MemInst,
+                             const AST::MemoryInstruction &Instr) {
+  /// Pop the length, value, and destination from the stack.
+  const uint32_t N = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint32_t Val = retrieveValue<uint32_t>(StackMgr.pop());
+  const uint32_t D = retrieveValue<uint32_t>(StackMgr.pop());
+
+  if (auto Res = MemInst.fillBytes(D, static_cast<Byte>(Val), N); !Res) {
+    LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
+                                           Instr.getOffset());
+    return Unexpect(Res);
+  }
+  return {};
+}
+
 } // namespace Interpreter
 } // namespace SSVM
@@ -5,6 +5,8 @@
 #include "runtime/instance/module.h"
 #include "support/log.h"
 
+#include <unistd.h>
+
 namespace SSVM {
 namespace Interpreter {
 
@@ -16,6 +18,12 @@ Interpreter::resolveExpression(Runtime::StoreManager &StoreMgr,
   std::vector<uint32_t> Offsets;
   /// Iterate and evaluate offsets.
   for (const auto &DataSeg : DataSec.getContent()) {
+    /// Passive data segment has no offset to evaluate.
+    if (DataSeg->isPassive()) {
+      Offsets.push_back(0);
+      continue;
+    }
+
     /// Run initialize expression.
     if (auto Res = runExpression(StoreMgr, DataSeg->getInstrs()); !Res) {
       LOG(ERROR) << ErrInfo::InfoAST(ASTNodeAttr::Expression);
@@ -51,12 +59,43 @@ Expect<void> Interpreter::instantiate(
   auto ItDataSeg = DataSec.getContent().begin();
   auto ItOffset = Offsets.begin();
   while (ItOffset != Offsets.end()) {
+    /// Record data segment for memory.init. Active ones are dropped after
+    /// instantiation, and passive ones are not copied into memory.
+    if ((*ItDataSeg)->isPassive()) {
+      ModInst.addDataSeg((*ItDataSeg)->getData());
+      ++ItDataSeg;
+      ++ItOffset;
+      continue;
+    }
+    ModInst.addDataSeg({});
+
     /// Get memory instance.
     uint32_t MemAddr = *ModInst.getMemAddr((*ItDataSeg)->getIdx());
     auto *MemInst = *StoreMgr.getMemory(MemAddr);
 
     /// Copy data to memory instance. Boundary checked in resolving expression.
     const auto &Data = (*ItDataSeg)->getData();
+    if (const int FD = (*ItDataSeg)->getImageFD(); FD >= 0) {
+      /// Map the whole pages from the compiled binary, and copy the rest.
+      const uint64_t PageSize = static_cast<uint64_t>(getpagesize());
+      const uint64_t Start = *ItOffset;
+      const uint64_t Stop = Start + Data.size();
+      const uint64_t Begin = (Start + PageSize - 1) / PageSize * PageSize;
+      const uint64_t End = Stop / PageSize * PageSize;
+      if (Begin < End &&
+          MemInst->mapBytes(FD, (*ItDataSeg)->getImageOffset() + Begin - Start,
+                            Begin, End - Begin)) {
+        if (Begin > Start) {
+          MemInst->setBytes(Data, Start, 0, Begin - Start);
+        }
+        if (Stop > End) {
+          MemInst->setBytes(Data, End, End - Start, Stop - End);
+        }
+        ++ItDataSeg;
+        ++ItOffset;
+        continue;
+      }
+    }
     MemInst->setBytes(Data, *ItOffset, 0, Data.size());
 
     ++ItDataSeg;
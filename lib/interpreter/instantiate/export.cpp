@@ -22,41 +22,20 @@ Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
     const auto ExtType = ExpDesc->getExternalType();
     std::string_view ExtName = ExpDesc->getExternalName();
     const uint32_t ExtIdx = ExpDesc->getExternalIndex();
-    void *Symbol = ExpDesc->getSymbol();
 
     /// Add the name of instances module.
     switch (ExtType) {
     case ExternalType::Function:
       ModInst.exportFuncion(ExtName, ExtIdx);
-      if (Symbol) {
-        uint32_t Addr = *ModInst.getFuncAddr(ExtIdx);
-        auto *Inst = *StoreMgr.getFunction(Addr);
-        Inst->setSymbol(Symbol);
-      }
       break;
     case ExternalType::Global:
       ModInst.exportGlobal(ExtName, ExtIdx);
-      if (Symbol) {
-        uint32_t Addr = *ModInst.getGlobalAddr(ExtIdx);
-        auto *Inst = *StoreMgr.getGlobal(Addr);
-        Inst->setSymbol(Symbol);
-      }
       break;
     case ExternalType::Memory:
       ModInst.exportMemory(ExtName, ExtIdx);
-      if (Symbol) {
-        uint32_t Addr = *ModInst.getMemAddr(ExtIdx);
-        auto *Inst = *StoreMgr.getMemory(Addr);
-        Inst->setSymbol(Symbol);
-      }
       break;
     case ExternalType::Table:
       ModInst.exportTable(ExtName, ExtIdx);
-      if (Symbol) {
-        uint32_t Addr = *ModInst.getTableAddr(ExtIdx);
-        auto *Inst = *StoreMgr.getTable(Addr);
-        Inst->setSymbol(Symbol);
-      }
       break;
     default:
       break;
@@ -3,6 +3,7 @@
 #include "common/ast/section.h"
 #include "interpreter/interpreter.h"
 #include "runtime/instance/module.h"
+#include "support/log.h"
 
 namespace SSVM {
 namespace Interpreter {
@@ -22,7 +23,15 @@ Expect<void> Interpreter::instantiate(
     auto *FuncType = *ModInst.getFuncType(TypeIdxs[I]);
     auto NewFuncInst = std::make_unique<Runtime::Instance::FunctionInstance>(
         ModInst.Addr, *FuncType, CodeSegs[I]->getLocals(),
+        CodeSegs[I]->getLocalNum(), CodeSegs[I]->getMaxStackHeight(),
         CodeSegs[I]->getInstrs());
+    if (void *Symbol = CodeSegs[I]->getSymbol()) {
+      NewFuncInst->setSymbol(Symbol);
+    } else if (CodeSegs[I]->isBodySkipped()) {
+      /// The body is not decoded and cannot be interpreted.
+      LOG(ERROR) << ErrCode::MissingCompiledFunc;
+      return Unexpect(ErrCode::MissingCompiledFunc);
+    }
 
     /// Insert function instance to store manager.
     uint32_t NewFuncInstAddr;
@@ -3,6 +3,7 @@
 #include "common/ast/section.h"
 #include "interpreter/interpreter.h"
 #include "runtime/instance/module.h"
+#include "support/log.h"
 
 namespace SSVM {
 namespace Interpreter {
@@ -11,14 +12,16 @@ namespace Interpreter {
 Expect<void>
 Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
                          Runtime::Instance::ModuleInstance &ModInst,
-                         const AST::MemorySection &MemSec) {
+                         const AST::MemorySection &MemSec,
+                         const bool GuardPages) {
   /// Iterate and istantiate memory types.
   for (const auto &MemType : MemSec.getContent()) {
     /// Make a new memory instance.
     auto NewMemInst = std::make_unique<Runtime::Instance::MemoryInstance>(
-        *MemType->getLimit());
-    if (auto Symbol = MemType->getSymbol()) {
-      NewMemInst->setSymbol(Symbol);
+        *MemType->getLimit(), GuardPages);
+    if (NewMemInst->getDataPtr() == nullptr) {
+      LOG(ERROR) << ErrCode::MemoryReserveFailed;
+      return Unexpect(ErrCode::MemoryReserveFailed);
     }
 
     /// Insert memory instance to store manager.
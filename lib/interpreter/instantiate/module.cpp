@@ -55,6 +55,18 @@ Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
     }
   }
 
+  /// Compiled code without bounds checks relies on the guard pages of the
+  /// memory.
+  const bool NeedGuardPages = Mod.getBoundsCheck() == BoundsCheck::GuardPage;
+  if (NeedGuardPages && ModInst->getMemNum() > 0) {
+    auto *MemInst = *StoreMgr.getMemory(*ModInst->getMemAddr(0));
+    if (!MemInst->hasGuardPages()) {
+      LOG(ERROR) << ErrCode::IncompatibleImportType;
+      LOG(ERROR) << ErrInfo::InfoAST(Mod.NodeAttr);
+      return Unexpect(ErrCode::IncompatibleImportType);
+    }
+  }
+
   /// Instantiate Functions in module. (FuncionSec, CodeSec)
   const AST::FunctionSection *FuncSec = Mod.getFunctionSection();
   const AST::CodeSection *CodeSec = Mod.getCodeSection();
@@ -89,7 +101,10 @@ Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
   /// Instantiate MemorySection (MemorySec)
   const AST::MemorySection *MemSec = Mod.getMemorySection();
   if (MemSec != nullptr) {
-    if (auto Res = instantiate(StoreMgr, *ModInst, *MemSec); !Res) {
+    if (auto Res =
+            instantiate(StoreMgr, *ModInst, *MemSec,
+                        NeedGuardPages || Bounds == BoundsCheck::GuardPage);
+        !Res) {
       LOG(ERROR) << ErrInfo::InfoAST(MemSec->NodeAttr);
       LOG(ERROR) << ErrInfo::InfoAST(Mod.NodeAttr);
       return Unexpect(Res);
@@ -161,10 +176,40 @@ Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
     }
   }
 
-  /// Setup callbacks for compiled module
-  Mod.setTrapCodeProxy(&Interpreter::TrapCodeProxy);
-  Mod.setCallProxy(&Interpreter::callProxy);
-  Mod.setMemGrowProxy(&Interpreter::memGrowProxy);
+  /// Setup execution context for compiled functions.
+  {
+    auto &ExecCtx = ModInst->getExecutionContext();
+    if (ModInst->getMemNum() > 0) {
+      auto *MemInst = *StoreMgr.getMemory(*ModInst->getMemAddr(0));
+      ExecCtx.Memory = MemInst->getDataPtr();
+      ExecCtx.MemoryPages = MemInst->getDataPageSizeAddr();
+    }
+    std::vector<ValVariant *> GlobalPtrs;
+    GlobalPtrs.reserve(ModInst->getGlobalNum());
+    for (uint32_t I = 0; I < ModInst->getGlobalNum(); ++I) {
+      auto *GlobInst = *StoreMgr.getGlobal(*ModInst->getGlobalAddr(I));
+      GlobalPtrs.push_back(&GlobInst->getValue());
+    }
+    ModInst->setGlobalPtrs(std::move(GlobalPtrs));
+    /// Imported host functions are called directly by compiled code.
+    std::vector<ExecutionContext::HostBinding> HostBindings(
+        ModInst->getFuncNum());
+    for (uint32_t I = 0; I < ModInst->getFuncNum(); ++I) {
+      auto *FuncInst = *StoreMgr.getFunction(*ModInst->getFuncAddr(I));
+      if (FuncInst->isHostFunction()) {
+        HostBindings[I].Call = &Interpreter::hostFuncProxy;
+        HostBindings[I].Func = &FuncInst->getHostFunc();
+      }
+    }
+    ModInst->setHostBindings(std::move(HostBindings));
+    ExecCtx.Call = &Interpreter::callProxy;
+    ExecCtx.MemGrow = &Interpreter::memGrowProxy;
+    ExecCtx.MemInit = &Interpreter::memInitProxy;
+    ExecCtx.DataDrop = &Interpreter::dataDropProxy;
+    ExecCtx.Host = this;
+    static_assert(sizeof(Epoch) == sizeof(uint64_t));
+    ExecCtx.Epoch = reinterpret_cast<const uint64_t *>(&Epoch);
+  }
 
   /// Instantiate StartSection (StartSec)
   const AST::StartSection *StartSec = Mod.getStartSection();
@@ -23,6 +23,12 @@ Expect<void> FileMgrFStream::setPath(std::string_view FilePath) {
     Status = ErrCode::InvalidPath;
   }
   Fin.open(std::filesystem::u8path(FilePath), std::ios::in | std::ios::binary);
+  if (!Fin.fail()) {
+    /// Record the file size for checking the skipped and read bytes.
+    Fin.seekg(0, std::ios::end);
+    Size = Fin.tellg();
+    Fin.seekg(0, std::ios::beg);
+  }
   if (!Fin.fail()) {
     Status = ErrCode::Success;
   }
@@ -53,6 +59,11 @@ Expect<std::vector<Byte>> FileMgrFStream::readBytes(size_t SizeToRead) {
   }
   std::vector<Byte> Buf;
   if (SizeToRead > 0) {
+    if (static_cast<uint64_t>(Fin.tellg()) + SizeToRead > Size) {
+      Fin.setstate(std::ios::failbit | std::ios::eofbit);
+      Status = ErrCode::EndOfFile;
+      return Unexpect(Status);
+    }
     std::istreambuf_iterator<char> Iter(Fin);
     // TODO: error handling
     std::copy_n(Iter, SizeToRead, std::back_inserter(Buf));
@@ -65,6 +76,27 @@ Expect<std::vector<Byte>> FileMgrFStream::readBytes(size_t SizeToRead) {
   return Buf;
 }
 
+/// Skip number of bytes. See "include/loader/filemgr.h".
+Expect<void> FileMgrFStream::skipBytes(size_t SizeToSkip) {
+  if (Status != ErrCode::Success) {
+    return Unexpect(Status);
+  }
+  if (SizeToSkip > 0) {
+    const uint64_t Curr = Fin.tellg();
+    if (Curr + SizeToSkip > Size) {
+      Fin.setstate(std::ios::failbit | std::ios::eofbit);
+      Status = ErrCode::EndOfFile;
+      return Unexpect(Status);
+    }
+    Fin.seekg(static_cast<std::streamoff>(SizeToSkip), std::ios::cur);
+  }
+  if (Fin.fail()) {
+    Status = Fin.eof() ? ErrCode::EndOfFile : ErrCode::ReadError;
+    return Unexpect(Status);
+  }
+  return {};
+}
+
 /// Decode and read an unsigned int. See "include/loader/filemgr.h".
 Expect<uint32_t> FileMgrFStream::readU32() {
   if (Status != ErrCode::Success) {
@@ -216,7 +248,12 @@ Expect<std::string> FileMgrFStream::readName() {
 
 /// Set code data. See "include/loader/filemgr.h".
 Expect<void> FileMgrVector::setCode(Span<const Byte> CodeData) {
-  Code.assign(CodeData.begin(), CodeData.end());
+  return setCode(std::vector<Byte>(CodeData.begin(), CodeData.end()));
+}
+
+/// Take binary data to file manager. See "include/loader/filemgr.h".
+Expect<void> FileMgrVector::setCode(std::vector<Byte> &&CodeData) {
+  Code = std::move(CodeData);
   Pos = 0;
   if (Code.size() == 0) {
     Status = ErrCode::EndOfFile;
@@ -250,6 +287,17 @@ Expect<std::vector<Byte>> FileMgrVector::readBytes(size_t SizeToRead) {
   return Buf;
 }
 
+/// Skip number of bytes. See "include/loader/filemgr.h".
+Expect<void> FileMgrVector::skipBytes(size_t SizeToSkip) {
+  if (Pos + SizeToSkip > Code.size()) {
+    Pos = Code.size();
+    Status = ErrCode::EndOfFile;
+    return Unexpect(Status);
+  }
+  Pos += SizeToSkip;
+  return {};
+}
+
 /// Decode and read an unsigned int. See "include/loader/filemgr.h".
 Expect<uint32_t> FileMgrVector::readU32() {
   uint32_t Result = 0;
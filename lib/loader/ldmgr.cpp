@@ -5,17 +5,110 @@
 #endif
 
 #include "loader/ldmgr.h"
+#include "common/cpufeature.h"
 #include "support/log.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <dlfcn.h>
+#include <fcntl.h>
+#include <optional>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+#if defined(__linux__)
+#include <elf.h>
+#include <link.h>
+#endif
 
 namespace SSVM {
 
+namespace {
+/// Check the host CPU supports the feature. Features the loader cannot check
+/// on x86 are refused, and the features of other architectures are assumed
+/// to be supported.
+static bool isHostFeatureSupported(std::string_view Feature) {
+#if defined(__i386__) || defined(__x86_64__)
+  static const auto Supported = []() {
+    std::array<bool, kCPUFeatures.size()> Result{};
+    uint64_t XCR0 = 0;
+    unsigned int EAX = 0, EBX = 0, ECX = 0, EDX = 0;
+    if (__get_cpuid(1, &EAX, &EBX, &ECX, &EDX) && (ECX & bit_OSXSAVE)) {
+      uint32_t Low = 0, High = 0;
+      asm volatile("xgetbv" : "=a"(Low), "=d"(High) : "c"(0));
+      XCR0 = (static_cast<uint64_t>(High) << 32) | Low;
+    }
+    for (size_t I = 0; I < kCPUFeatures.size(); ++I) {
+      const auto &Feature = kCPUFeatures[I];
+      std::array<unsigned int, 4> Regs{};
+      if (!__get_cpuid_count(Feature.Leaf, Feature.SubLeaf, &Regs[0],
+                             &Regs[1], &Regs[2], &Regs[3])) {
+        continue;
+      }
+      Result[I] = ((Regs[Feature.Reg] >> Feature.Bit) & 1U) &&
+                  (XCR0 & Feature.XCR0) == Feature.XCR0;
+    }
+    return Result;
+  }();
+  for (size_t I = 0; I < kCPUFeatures.size(); ++I) {
+    if (kCPUFeatures[I].Name == Feature) {
+      return Supported[I];
+    }
+  }
+  return false;
+#else
+  static_cast<void>(Feature);
+  return true;
+#endif
+}
+
+/// Count the features enabled in the target settings.
+static uint32_t countTargetFeatures(std::string_view Target) {
+  uint32_t Count = 0;
+  for (auto Pos = Target.find('+'); Pos != std::string_view::npos;
+       Pos = Target.find('+', Pos + 1)) {
+    ++Count;
+  }
+  return Count;
+}
+} // namespace
+
+/// Check the target settings is supported. See "include/loader/ldmgr.h".
+bool LDMgr::isTargetSupported(std::string_view Target) {
+  for (int I = 0; I < 2; ++I) {
+    const auto Pos = Target.find(';');
+    if (Pos == std::string_view::npos) {
+      return false;
+    }
+    Target.remove_prefix(Pos + 1);
+  }
+  while (!Target.empty()) {
+    const auto Pos = std::min(Target.find(','), Target.size());
+    const auto Feature = Target.substr(0, Pos);
+    if (!Feature.empty() && Feature.front() == '+' &&
+        !isHostFeatureSupported(Feature.substr(1))) {
+      return false;
+    }
+    Target.remove_prefix(std::min(Pos + 1, Target.size()));
+  }
+  return true;
+}
+
 /// Destructor of loadable manager. See "include/loader/ldmgr.h".
 LDMgr::~LDMgr() noexcept {
   if (Handler != nullptr) {
     dlclose(Handler);
   }
+  if (FD >= 0) {
+    close(FD);
+  }
 }
 
 /// Set path to loadable manager. See "include/loader/ldmgr.h".
@@ -23,21 +116,114 @@ Expect<void> LDMgr::setPath(std::string_view FilePath) {
   if (Handler != nullptr) {
     dlclose(Handler);
   }
-  Handler = dlopen(std::string(FilePath).c_str(), RTLD_LAZY | RTLD_LOCAL);
+  if (FD >= 0) {
+    close(FD);
+  }
+  Static = nullptr;
+  const std::string Path(FilePath);
+  Handler = dlopen(Path.c_str(), RTLD_LAZY | RTLD_LOCAL);
   if (Handler == nullptr) {
+    FD = -1;
     LOG(ERROR) << ErrCode::InvalidPath;
     return Unexpect(ErrCode::InvalidPath);
   }
+  /// Only for mapping the data segments, which are copied if failed.
+  FD = open(Path.c_str(), O_RDONLY | O_CLOEXEC);
+  selectVariant();
+  return {};
+}
+
+/// Set static module to loadable manager. See "include/loader/ldmgr.h".
+Expect<void> LDMgr::setStatic(const StaticModule &Module) {
+  if (Handler != nullptr) {
+    dlclose(Handler);
+    Handler = nullptr;
+  }
+  if (FD >= 0) {
+    close(FD);
+    FD = -1;
+  }
+  Static = &Module;
+  selectVariant();
   return {};
 }
 
+void LDMgr::selectVariant() {
+  /// Select the supported variant enabling the most features, which is the
+  /// superset when the variants follow the x86-64 levels. Ties go to the
+  /// later variant. Fall back to the first one, and the target check reports
+  /// the error.
+  Prefix.clear();
+  if (const auto *Variants = getSharedSymbol<uint32_t>("variants")) {
+    Prefix = "v0.";
+    std::optional<uint32_t> Best;
+    for (uint32_t I = 0; I < *Variants; ++I) {
+      const std::string Name = "v" + std::to_string(I) + ".target";
+      const auto *Target = getSharedSymbol<char>(Name.c_str());
+      if (Target == nullptr || !isTargetSupported(Target)) {
+        continue;
+      }
+      const uint32_t Count = countTargetFeatures(Target);
+      if (!Best || Count >= *Best) {
+        Best = Count;
+        Prefix = "v" + std::to_string(I) + ".";
+      }
+    }
+  }
+}
+
+/// Get file offset of address. See "include/loader/ldmgr.h".
+Expect<uint64_t> LDMgr::getFileOffset(const void *Ptr) {
+#if defined(__linux__)
+  struct link_map *LinkMap = nullptr;
+  if (Handler == nullptr || dlinfo(Handler, RTLD_DI_LINKMAP, &LinkMap) != 0 ||
+      LinkMap == nullptr) {
+    LOG(ERROR) << ErrCode::InvalidPath;
+    return Unexpect(ErrCode::InvalidPath);
+  }
+
+  /// Find the loadable segment containing the address in the program headers
+  /// of the loaded binary.
+  struct Query {
+    ElfW(Addr) Base;
+    ElfW(Addr) Addr;
+    std::optional<uint64_t> Offset;
+  } Q{LinkMap->l_addr, reinterpret_cast<ElfW(Addr)>(Ptr), std::nullopt};
+  dl_iterate_phdr(
+      [](struct dl_phdr_info *Info, size_t, void *Data) -> int {
+        auto &Q = *static_cast<Query *>(Data);
+        if (Info->dlpi_addr != Q.Base) {
+          return 0;
+        }
+        for (ElfW(Half) I = 0; I < Info->dlpi_phnum; ++I) {
+          const auto &Header = Info->dlpi_phdr[I];
+          const ElfW(Addr) Start = Info->dlpi_addr + Header.p_vaddr;
+          if (Header.p_type == PT_LOAD && Start <= Q.Addr &&
+              Q.Addr - Start < Header.p_filesz) {
+            Q.Offset = Q.Addr - Start + Header.p_offset;
+            return 1;
+          }
+        }
+        return 0;
+      },
+      &Q);
+  if (Q.Offset) {
+    return *Q.Offset;
+  }
+#else
+  static_cast<void>(Ptr);
+#endif
+  LOG(ERROR) << ErrCode::InvalidPath;
+  return Unexpect(ErrCode::InvalidPath);
+}
+
 Expect<std::vector<Byte>> LDMgr::getWasm() {
-  const auto *const Size = getSymbol<uint32_t>("wasm.size");
+  const auto *const Size = getSharedSymbol<uint32_t>("wasm.size");
   if (Size == nullptr) {
     LOG(ERROR) << ErrCode::InvalidGrammar;
     return Unexpect(ErrCode::InvalidGrammar);
   }
-  const auto *const Code = getSymbol<uint8_t>("wasm.code");
+  const auto *const Code = getSharedSymbol<uint8_t>("wasm.code");
   if (Code == nullptr) {
     LOG(ERROR) << ErrCode::InvalidGrammar;
     return Unexpect(ErrCode::InvalidGrammar);
@@ -47,7 +233,7 @@ Expect<std::vector<Byte>> LDMgr::getWasm() {
 }
 
 Expect<uint32_t> LDMgr::getVersion() {
-  const auto *const Version = getSymbol<uint32_t>("version");
+  const auto *const Version = getSharedSymbol<uint32_t>("version");
   if (Version == nullptr) {
     LOG(ERROR) << ErrCode::InvalidGrammar;
     return Unexpect(ErrCode::InvalidGrammar);
@@ -55,7 +241,36 @@ Expect<uint32_t> LDMgr::getVersion() {
   return *Version;
 }
 
+Expect<std::string_view> LDMgr::getTarget() {
+  const auto *const Target = getSymbol<char>("target");
+  if (Target == nullptr) {
+    LOG(ERROR) << ErrCode::InvalidGrammar;
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
+  return std::string_view(Target);
+}
+
+bool LDMgr::isMetered() {
+  const auto *const Metered = getSharedSymbol<uint8_t>("metered");
+  return Metered != nullptr && *Metered != 0;
+}
+
 void *LDMgr::getRawSymbol(const char *Name) {
+  if (Prefix.empty()) {
+    return getRawSharedSymbol(Name);
+  }
+  return getRawSharedSymbol((Prefix + Name).c_str());
+}
+
+void *LDMgr::getRawSharedSymbol(const char *Name) {
+  if (Static != nullptr) {
+    for (uint32_t I = 0; I < Static->SymbolCount; ++I) {
+      if (std::strcmp(Static->Symbols[I].Name, Name) == 0) {
+        return const_cast<void *>(Static->Symbols[I].Address);
+      }
+    }
+    return nullptr;
+  }
   if (Handler == nullptr) {
     return nullptr;
   }
@@ -59,40 +59,24 @@ Loader::parseModule(std::string_view FilePath) {
       LOG(ERROR) << ErrInfo::InfoFile(FilePath);
       return Unexpect(Res);
     }
-    if (auto Res = LMgr.getVersion()) {
-      if (*Res != kVersion) {
-        LOG(ERROR) << ErrInfo::InfoMismatch(kVersion, *Res);
-        return Unexpect(ErrCode::InvalidVersion);
+    return loadCompiled(FilePath);
+  } else if (IsHashing) {
+    /// The whole binary is needed for the digest, so read the file once into
+    /// the buffer and parse from it.
+    if (auto Code = loadFile(FilePath)) {
+      if (auto Res = FVMgr.setCode(std::move(*Code)); !Res) {
+        LOG(ERROR) << ErrInfo::InfoFile(FilePath);
+        return Unexpect(Res);
       }
-    } else {
-      LOG(ERROR) << ErrInfo::InfoFile(FilePath);
-      return Unexpect(Res);
-    }
-
-    std::unique_ptr<AST::Module> Mod;
-    if (auto Code = LMgr.getWasm()) {
-      if (auto Res = parseModule(*Code)) {
-        Mod = std::move(*Res);
+      if (auto Res = loadBuffer()) {
+        return std::move(*Res);
       } else {
         LOG(ERROR) << ErrInfo::InfoFile(FilePath);
         return Unexpect(Res);
       }
     } else {
-      LOG(ERROR) << ErrInfo::InfoFile(FilePath);
       return Unexpect(Code);
     }
-    if (auto Res = Mod->loadCompiled(LMgr)) {
-      Mod->setTrapCodeProxySymbol(
-          static_cast<AST::Module::TrapCodeProxy *>(LMgr.getRawSymbol("code")));
-      Mod->setCallProxySymbol(
-          static_cast<AST::Module::CallProxy *>(LMgr.getRawSymbol("call")));
-      Mod->setMemGrowProxySymbol(static_cast<AST::Module::MemGrowProxy *>(
-          LMgr.getRawSymbol("memgrow")));
-      return Mod;
-    } else {
-      LOG(ERROR) << ErrInfo::InfoFile(FilePath);
-      return Unexpect(Res);
-    }
   } else {
     auto Mod = std::make_unique<AST::Module>();
     if (auto Res = FSMgr.setPath(FilePath); !Res) {
@@ -108,18 +92,91 @@ Loader::parseModule(std::string_view FilePath) {
   }
 }
 
+/// Parse module from registration table. See "include/loader/loader.h".
+Expect<std::unique_ptr<AST::Module>>
+Loader::parseModule(const StaticModule &Module) {
+  const std::string_view Name = Module.Name ? Module.Name : "";
+  if (auto Res = LMgr.setStatic(Module); !Res) {
+    LOG(ERROR) << ErrInfo::InfoFile(Name);
+    return Unexpect(Res);
+  }
+  return loadCompiled(Name);
+}
+
+/// Load compiled module from loadable manager. See "include/loader/loader.h".
+Expect<std::unique_ptr<AST::Module>>
+Loader::loadCompiled(std::string_view Name) {
+  if (auto Res = LMgr.getVersion()) {
+    if (*Res != kVersion) {
+      LOG(ERROR) << ErrInfo::InfoMismatch(kVersion, *Res);
+      return Unexpect(ErrCode::InvalidVersion);
+    }
+  } else {
+    LOG(ERROR) << ErrInfo::InfoFile(Name);
+    return Unexpect(Res);
+  }
+  if (auto Res = LMgr.getTarget()) {
+    if (!LDMgr::isTargetSupported(*Res)) {
+      LOG(ERROR) << ErrCode::InvalidTarget;
+      LOG(ERROR) << ErrInfo::InfoFile(Name);
+      return Unexpect(ErrCode::InvalidTarget);
+    }
+  } else {
+    LOG(ERROR) << ErrInfo::InfoFile(Name);
+    return Unexpect(Res);
+  }
+  /// Compiled code without metering will not count the cost.
+  if (Measure && Measure->getCostLimit() != UINT64_MAX && !LMgr.isMetered()) {
+    LOG(ERROR) << ErrCode::InvalidMetering;
+    LOG(ERROR) << ErrInfo::InfoFile(Name);
+    return Unexpect(ErrCode::InvalidMetering);
+  }
+  /// The function bodies are compiled, so only the declarations are
+  /// decoded. Not hashed, since the validation results of the skipped
+  /// bodies are not available.
+  auto Mod = std::make_unique<AST::Module>();
+  Mod->setSkipFunctionBody(true);
+  if (auto Code = LMgr.getWasm()) {
+    if (auto Res = FVMgr.setCode(*Code); !Res) {
+      LOG(ERROR) << ErrInfo::InfoFile(Name);
+      return Unexpect(Res);
+    }
+    if (auto Res = Mod->loadBinary(FVMgr); !Res) {
+      LOG(ERROR) << ErrInfo::InfoFile(Name);
+      return Unexpect(Res);
+    }
+  } else {
+    LOG(ERROR) << ErrInfo::InfoFile(Name);
+    return Unexpect(Code);
+  }
+  if (auto Res = Mod->loadCompiled(LMgr)) {
+    return Mod;
+  } else {
+    LOG(ERROR) << ErrInfo::InfoFile(Name);
+    return Unexpect(Res);
+  }
+}
+
 /// Parse module from byte code. See "include/loader/loader.h".
 Expect<std::unique_ptr<AST::Module>>
 Loader::parseModule(Span<const uint8_t> Code) {
-  auto Mod = std::make_unique<AST::Module>();
   if (auto Res = FVMgr.setCode(Code); !Res) {
     return Unexpect(Res);
   }
-  if (auto Res = Mod->loadBinary(FVMgr)) {
-    return Mod;
-  } else {
+  return loadBuffer();
+}
+
+/// Parse module from the buffer. See "include/loader/loader.h".
+Expect<std::unique_ptr<AST::Module>> Loader::loadBuffer() {
+  auto Mod = std::make_unique<AST::Module>();
+  if (auto Res = Mod->loadBinary(FVMgr); !Res) {
     return Unexpect(Res);
   }
+  if (IsHashing) {
+    /// Hash the buffer held by the file manager.
+    Mod->setContentHash(Support::SHA256::hash(FVMgr.getCode()));
+  }
+  return Mod;
 }
 
 } // namespace Loader
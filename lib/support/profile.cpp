@@ -0,0 +1,115 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "support/profile.h"
+#include "support/log.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace SSVM {
+namespace Support {
+
+namespace {
+/// Header line of profile files.
+static inline constexpr std::string_view Magic = "ssvm-profile 1";
+
+/// Get the keys of a map in ascending order.
+template <typename MapT> std::vector<uint32_t> sortedKeys(const MapT &Map) {
+  std::vector<uint32_t> Keys;
+  Keys.reserve(Map.size());
+  for (const auto &Pair : Map) {
+    Keys.push_back(Pair.first);
+  }
+  std::sort(Keys.begin(), Keys.end());
+  return Keys;
+}
+} // namespace
+
+/// Read profile from file. See "include/support/profile.h".
+///
+/// Each line after the header is one of:
+///   entry <function offset> <count>
+///   branch <offset> <taken> <not taken>
+///   indirect <offset> <target function offset> <count>
+Expect<void> Profile::load(std::string_view Path) {
+  std::ifstream Fin(std::string(Path), std::ios::in);
+  if (!Fin) {
+    LOG(ERROR) << ErrCode::InvalidPath;
+    return Unexpect(ErrCode::InvalidPath);
+  }
+  std::string Line;
+  if (!std::getline(Fin, Line) || Line != Magic) {
+    LOG(ERROR) << ErrCode::InvalidGrammar;
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
+  while (std::getline(Fin, Line)) {
+    if (Line.empty()) {
+      continue;
+    }
+    std::istringstream LineIn(Line);
+    std::string Kind;
+    uint32_t Offset = 0;
+    LineIn >> Kind >> Offset;
+    /// No trailing tokens are allowed after the counts.
+    auto AtEnd = [&LineIn]() { return (LineIn >> std::ws).eof(); };
+    if (Kind == "entry") {
+      uint64_t Count = 0;
+      if (LineIn >> Count && AtEnd()) {
+        Entries[Offset] += Count;
+        continue;
+      }
+    } else if (Kind == "branch") {
+      uint64_t Taken = 0, NotTaken = 0;
+      if (LineIn >> Taken >> NotTaken && AtEnd()) {
+        auto &Count = Branches[Offset];
+        Count.Taken += Taken;
+        Count.NotTaken += NotTaken;
+        continue;
+      }
+    } else if (Kind == "indirect") {
+      uint32_t Target = 0;
+      uint64_t Count = 0;
+      if (LineIn >> Target >> Count && AtEnd()) {
+        IndirectCalls[Offset][Target] += Count;
+        continue;
+      }
+    }
+    LOG(ERROR) << ErrCode::InvalidGrammar;
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
+  return {};
+}
+
+/// Write profile into file. See "include/support/profile.h".
+Expect<void> Profile::save(std::string_view Path) const {
+  std::ofstream Fout(std::string(Path), std::ios::out | std::ios::trunc);
+  if (!Fout) {
+    LOG(ERROR) << ErrCode::InvalidPath;
+    return Unexpect(ErrCode::InvalidPath);
+  }
+  Fout << Magic << '\n';
+  for (const auto Offset : sortedKeys(Entries)) {
+    Fout << "entry " << Offset << ' ' << Entries.at(Offset) << '\n';
+  }
+  for (const auto Offset : sortedKeys(Branches)) {
+    const auto &Count = Branches.at(Offset);
+    Fout << "branch " << Offset << ' ' << Count.Taken << ' ' << Count.NotTaken
+         << '\n';
+  }
+  for (const auto Offset : sortedKeys(IndirectCalls)) {
+    for (const auto &[Target, Count] : IndirectCalls.at(Offset)) {
+      Fout << "indirect " << Offset << ' ' << Target << ' ' << Count << '\n';
+    }
+  }
+  Fout.close();
+  if (!Fout) {
+    LOG(ERROR) << ErrCode::InvalidPath;
+    return Unexpect(ErrCode::InvalidPath);
+  }
+  return {};
+}
+
+} // namespace Support
+} // namespace SSVM
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "support/sha256.h"
+#include "support/hexstr.h"
+
+#include <cstring>
+
+namespace SSVM {
+namespace Support {
+
+namespace {
+static inline constexpr std::array<uint32_t, 64> K = {
+    0x428a2f98U, 0x71374491U, 0xb5c0fbcfU, 0xe9b5dba5U, 0x3956c25bU,
+    0x59f111f1U, 0x923f82a4U, 0xab1c5ed5U, 0xd807aa98U, 0x12835b01U,
+    0x243185beU, 0x550c7dc3U, 0x72be5d74U, 0x80deb1feU, 0x9bdc06a7U,
+    0xc19bf174U, 0xe49b69c1U, 0xefbe4786U, 0x0fc19dc6U, 0x240ca1ccU,
+    0x2de92c6fU, 0x4a7484aaU, 0x5cb0a9dcU, 0x76f988daU, 0x983e5152U,
+    0xa831c66dU, 0xb00327c8U, 0xbf597fc7U, 0xc6e00bf3U, 0xd5a79147U,
+    0x06ca6351U, 0x14292967U, 0x27b70a85U, 0x2e1b2138U, 0x4d2c6dfcU,
+    0x53380d13U, 0x650a7354U, 0x766a0abbU, 0x81c2c92eU, 0x92722c85U,
+    0xa2bfe8a1U, 0xa81a664bU, 0xc24b8b70U, 0xc76c51a3U, 0xd192e819U,
+    0xd6990624U, 0xf40e3585U, 0x106aa070U, 0x19a4c116U, 0x1e376c08U,
+    0x2748774cU, 0x34b0bcb5U, 0x391c0cb3U, 0x4ed8aa4aU, 0x5b9cca4fU,
+    0x682e6ff3U, 0x748f82eeU, 0x78a5636fU, 0x84c87814U, 0x8cc70208U,
+    0x90befffaU, 0xa4506cebU, 0xbef9a3f7U, 0xc67178f2U};
+
+static inline constexpr uint32_t rotr(uint32_t X, uint32_t N) {
+  return (X >> N) | (X << (32 - N));
+}
+} // namespace
+
+/// Reset state. See "include/support/sha256.h".
+void SHA256::reset() {
+  State = {0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU,
+           0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U};
+  Length = 0;
+  BufferSize = 0;
+}
+
+/// Append bytes. See "include/support/sha256.h".
+void SHA256::update(Span<const uint8_t> Data) {
+  const uint8_t *Ptr = Data.data();
+  size_t Size = Data.size();
+  Length += Size;
+  if (BufferSize > 0) {
+    const size_t Fill = std::min<size_t>(Size, 64 - BufferSize);
+    std::memcpy(Buffer.data() + BufferSize, Ptr, Fill);
+    BufferSize += Fill;
+    Ptr += Fill;
+    Size -= Fill;
+    if (BufferSize < 64) {
+      return;
+    }
+    processBlock(Buffer.data());
+    BufferSize = 0;
+  }
+  while (Size >= 64) {
+    processBlock(Ptr);
+    Ptr += 64;
+    Size -= 64;
+  }
+  if (Size > 0) {
+    std::memcpy(Buffer.data(), Ptr, Size);
+    BufferSize = Size;
+  }
+}
+
+/// Finish and get digest. See "include/support/sha256.h".
+SHA256::Digest SHA256::finalize() {
+  const uint64_t BitLength = Length * 8;
+  std::array<uint8_t, 72> Padding{};
+  Padding[0] = 0x80U;
+  const uint32_t PadSize =
+      (BufferSize < 56) ? (56 - BufferSize) : (120 - BufferSize);
+  for (uint32_t I = 0; I < 8; ++I) {
+    Padding[PadSize + I] = static_cast<uint8_t>(BitLength >> (56 - I * 8));
+  }
+  update(Span<const uint8_t>(Padding.data(), PadSize + 8));
+
+  Digest Result;
+  for (uint32_t I = 0; I < 8; ++I) {
+    Result[I * 4] = static_cast<uint8_t>(State[I] >> 24);
+    Result[I * 4 + 1] = static_cast<uint8_t>(State[I] >> 16);
+    Result[I * 4 + 2] = static_cast<uint8_t>(State[I] >> 8);
+    Result[I * 4 + 3] = static_cast<uint8_t>(State[I]);
+  }
+  reset();
+  return Result;
+}
+
+/// Convert digest to hex string. See "include/support/sha256.h".
+std::string SHA256::toHexStr(const Digest &D) {
+  std::string Str;
+  convertBytesToHexStr(D, Str);
+  return Str;
+}
+
+/// Process one 64 bytes block. See "include/support/sha256.h".
+void SHA256::processBlock(const uint8_t *Block) {
+  std::array<uint32_t, 64> W;
+  for (uint32_t I = 0; I < 16; ++I) {
+    W[I] = (static_cast<uint32_t>(Block[I * 4]) << 24) |
+           (static_cast<uint32_t>(Block[I * 4 + 1]) << 16) |
+           (static_cast<uint32_t>(Block[I * 4 + 2]) << 8) |
+           static_cast<uint32_t>(Block[I * 4 + 3]);
+  }
+  for (uint32_t I = 16; I < 64; ++I) {
+    const uint32_t S0 =
+        rotr(W[I - 15], 7) ^ rotr(W[I - 15], 18) ^ (W[I - 15] >> 3);
+    const uint32_t S1 =
+        rotr(W[I - 2], 17) ^ rotr(W[I - 2], 19) ^ (W[I - 2] >> 10);
+    W[I] = W[I - 16] + S0 + W[I - 7] + S1;
+  }
+
+  uint32_t A = State[0], B = State[1], C = State[2], D = State[3];
+  uint32_t E = State[4], F = State[5], G = State[6], H = State[7];
+  for (uint32_t I = 0; I < 64; ++I) {
+    const uint32_t S1 = rotr(E, 6) ^ rotr(E, 11) ^ rotr(E, 25);
+    const uint32_t Ch = (E & F) ^ (~E & G);
+    const uint32_t T1 = H + S1 + Ch + K[I] + W[I];
+    const uint32_t S0 = rotr(A, 2) ^ rotr(A, 13) ^ rotr(A, 22);
+    const uint32_t Maj = (A & B) ^ (A & C) ^ (B & C);
+    const uint32_t T2 = S0 + Maj;
+    H = G;
+    G = F;
+    F = E;
+    E = D + T1;
+    D = C;
+    C = B;
+    B = A;
+    A = T1 + T2;
+  }
+  State[0] += A;
+  State[1] += B;
+  State[2] += C;
+  State[3] += D;
+  State[4] += E;
+  State[5] += F;
+  State[6] += G;
+  State[7] += H;
+}
+
+} // namespace Support
+} // namespace SSVM
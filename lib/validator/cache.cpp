@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "validator/cache.h"
+
+namespace SSVM {
+namespace Validator {
+
+/// Get the process-wide instance. See "include/validator/cache.h".
+ValidationCache &ValidationCache::getInstance() {
+  static ValidationCache Instance;
+  return Instance;
+}
+
+/// Find cache entry. See "include/validator/cache.h".
+std::optional<ValidationCache::Entry>
+ValidationCache::find(const Digest &Hash) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  if (auto It = Entries.find(Hash); It != Entries.end()) {
+    return It->second;
+  }
+  return std::nullopt;
+}
+
+/// Insert cache entry. See "include/validator/cache.h".
+void ValidationCache::insert(const Digest &Hash, Entry E) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  if (Capacity == 0) {
+    return;
+  }
+  if (auto It = Entries.find(Hash); It != Entries.end()) {
+    It->second = std::move(E);
+    return;
+  }
+  Entries.emplace(Hash, std::move(E));
+  InsertOrder.push_back(Hash);
+  evict();
+}
+
+/// Clear cache. See "include/validator/cache.h".
+void ValidationCache::clear() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  Entries.clear();
+  InsertOrder.clear();
+}
+
+/// Setter of capacity. See "include/validator/cache.h".
+void ValidationCache::setCapacity(uint32_t Cap) {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  Capacity = Cap;
+  evict();
+}
+
+/// Getter of capacity. See "include/validator/cache.h".
+uint32_t ValidationCache::getCapacity() {
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return Capacity;
+}
+
+/// Evict the oldest entries. See "include/validator/cache.h".
+void ValidationCache::evict() {
+  while (InsertOrder.size() > Capacity) {
+    Entries.erase(InsertOrder.front());
+    InsertOrder.pop_front();
+  }
+}
+
+} // namespace Validator
+} // namespace SSVM
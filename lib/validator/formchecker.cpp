@@ -2,11 +2,20 @@
 #include "validator/formchecker.h"
 #include "common/ast/module.h"
 
+#include <algorithm>
+#include <array>
+
 namespace {
 template <typename... Ts> struct overloaded : Ts... {
   using Ts::operator()...;
 };
 template <typename... Ts> overloaded(Ts...) -> overloaded<Ts...>;
+
+/// Single value types for block result types, indexed by VType.
+static constexpr std::array<SSVM::Validator::VType, 5> SingleVTypes = {
+    SSVM::Validator::VType::Unknown, SSVM::Validator::VType::I32,
+    SSVM::Validator::VType::I64, SSVM::Validator::VType::F32,
+    SSVM::Validator::VType::F64};
 } // namespace
 
 namespace SSVM {
@@ -14,6 +23,7 @@ namespace Validator {
 
 void FormChecker::reset(bool CleanGlobal) {
   ValStack.clear();
+  MaxValStackHeight = 0;
   CtrlStack.clear();
   Locals.clear();
   Returns.clear();
@@ -26,10 +36,11 @@ void FormChecker::reset(bool CleanGlobal) {
     Globals.clear();
     NumImportFuncs = 0;
     NumImportGlobals = 0;
+    NumDatas.reset();
   }
 }
 
-Expect<void> FormChecker::validate(const AST::InstrVec &Instrs,
+Expect<void> FormChecker::validate(AST::InstrVec &Instrs,
                                    Span<const ValType> RetVals) {
   for (ValType Val : RetVals) {
     Returns.push_back(ASTToVType(Val));
@@ -37,7 +48,7 @@ Expect<void> FormChecker::validate(const AST::InstrVec &Instrs,
   return checkExpr(Instrs);
 }
 
-Expect<void> FormChecker::validate(const AST::InstrVec &Instrs,
+Expect<void> FormChecker::validate(AST::InstrVec &Instrs,
                                    Span<const VType> RetVals) {
   for (VType Val : RetVals) {
     Returns.push_back(Val);
@@ -120,7 +131,7 @@ ValType FormChecker::VTypeToAST(const VType &V) {
   }
 }
 
-Expect<void> FormChecker::checkExpr(const AST::InstrVec &Instrs) {
+Expect<void> FormChecker::checkExpr(AST::InstrVec &Instrs) {
   /// Push ctrl frame ([] -> [Returns])
   pushCtrl({}, Returns);
   if (auto Res = checkInstrs(Instrs); !Res) {
@@ -133,7 +144,7 @@ Expect<void> FormChecker::checkExpr(const AST::InstrVec &Instrs) {
   return {};
 }
 
-Expect<void> FormChecker::checkInstrs(const AST::InstrVec &Instrs) {
+Expect<void> FormChecker::checkInstrs(AST::InstrVec &Instrs) {
   /// Validate instructions
   for (auto &Instr : Instrs) {
     if (auto Res = AST::dispatchInstruction(
@@ -183,16 +194,16 @@ Expect<void> FormChecker::checkInstr(const AST::ControlInstruction &Instr) {
   return Unexpect(ErrCode::InvalidOpCode);
 }
 
-Expect<void>
-FormChecker::checkInstr(const AST::BlockControlInstruction &Instr) {
+Expect<void> FormChecker::checkInstr(AST::BlockControlInstruction &Instr) {
   /// Get blocktype [t1*] -> [t2*]
-  std::vector<VType> Buffer;
   Span<const VType> T1, T2;
-  if (auto Res = resolveBlockType(Buffer, Instr.getBlockType())) {
+  if (auto Res = resolveBlockType(Instr.getBlockType())) {
     std::tie(T1, T2) = std::move(*Res);
   } else {
     return Unexpect(Res);
   }
+  /// Record the block arity for execution.
+  Instr.setBlockArity(T1.size(), T2.size());
 
   /// Check type transformation
   switch (Instr.getOpCode()) {
@@ -224,18 +235,18 @@ FormChecker::checkInstr(const AST::BlockControlInstruction &Instr) {
   return {};
 }
 
-Expect<void>
-FormChecker::checkInstr(const AST::IfElseControlInstruction &Instr) {
+Expect<void> FormChecker::checkInstr(AST::IfElseControlInstruction &Instr) {
   switch (Instr.getOpCode()) {
   case OpCode::If: {
     /// Get blocktype [t1*] -> [t2*]
-    std::vector<VType> Buffer;
     Span<const VType> T1, T2;
-    if (auto Res = resolveBlockType(Buffer, Instr.getBlockType())) {
+    if (auto Res = resolveBlockType(Instr.getBlockType())) {
       std::tie(T1, T2) = std::move(*Res);
     } else {
       return Unexpect(Res);
     }
+    /// Record the block arity for execution.
+    Instr.setBlockArity(T1.size(), T2.size());
 
     /// Pop I32
     if (auto Res = popType(VType::I32); !Res) {
@@ -507,6 +518,21 @@ Expect<void> FormChecker::checkInstr(const AST::VariableInstruction &Instr) {
 }
 
 Expect<void> FormChecker::checkInstr(const AST::MemoryInstruction &Instr) {
+  /// Data segment index must exist, which requires data count section.
+  if (Instr.getOpCode() == OpCode::Memory__init ||
+      Instr.getOpCode() == OpCode::Data__drop) {
+    const uint32_t DataCnt = NumDatas.value_or(0);
+    if (Instr.getDataIndex() >= DataCnt) {
+      LOG(ERROR) << ErrCode::InvalidDataIdx;
+      LOG(ERROR) << ErrInfo::InfoForbidIndex(ErrInfo::IndexCategory::Data,
+                                             Instr.getDataIndex(), DataCnt);
+      return Unexpect(ErrCode::InvalidDataIdx);
+    }
+    if (Instr.getOpCode() == OpCode::Data__drop) {
+      return {};
+    }
+  }
+
   /// Memory[0] must exist
   if (Mems.size() == 0) {
     LOG(ERROR) << ErrCode::InvalidMemoryIdx;
@@ -566,6 +592,9 @@ Expect<void> FormChecker::checkInstr(const AST::MemoryInstruction &Instr) {
     break;
   case OpCode::Memory__size:
   case OpCode::Memory__grow:
+  case OpCode::Memory__init:
+  case OpCode::Memory__copy:
+  case OpCode::Memory__fill:
     break;
   default:
     LOG(ERROR) << ErrCode::InvalidOpCode;
@@ -608,6 +637,10 @@ Expect<void> FormChecker::checkInstr(const AST::MemoryInstruction &Instr) {
     return StackTrans({}, std::array{VType::I32});
   case OpCode::Memory__grow:
     return StackTrans(std::array{VType::I32}, std::array{VType::I32});
+  case OpCode::Memory__init:
+  case OpCode::Memory__copy:
+  case OpCode::Memory__fill:
+    return StackTrans(std::array{VType::I32, VType::I32, VType::I32}, {});
   default:
     break;
   }
@@ -832,7 +865,11 @@ FormChecker::checkInstr(const AST::BinaryNumericInstruction &Instr) {
   return Unexpect(ErrCode::InvalidOpCode);
 }
 
-void FormChecker::pushType(VType V) { ValStack.emplace_back(V); }
+void FormChecker::pushType(VType V) {
+  ValStack.emplace_back(V);
+  MaxValStackHeight =
+      std::max(MaxValStackHeight, static_cast<uint32_t>(ValStack.size()));
+}
 
 void FormChecker::pushTypes(Span<const VType> Input) {
   for (auto Val : Input) {
@@ -938,18 +975,18 @@ Expect<void> FormChecker::StackTrans(Span<const VType> Take,
 }
 
 Expect<std::pair<Span<const VType>, Span<const VType>>>
-FormChecker::resolveBlockType(std::vector<VType> &Buffer, BlockType Type) {
+FormChecker::resolveBlockType(BlockType Type) {
   using ReturnType = std::pair<Span<const VType>, Span<const VType>>;
   return std::visit(
       overloaded{
-          [this, &Buffer](ValType RetType) -> Expect<ReturnType> {
+          [this](ValType RetType) -> Expect<ReturnType> {
             /// ValType case. t2* = valtype | none
             if (RetType != ValType::None) {
-              Buffer.clear();
-              Buffer.reserve(1);
-              Buffer.push_back(ASTToVType(RetType));
+              const auto Index = static_cast<uint32_t>(ASTToVType(RetType));
+              return ReturnType{{},
+                                Span<const VType>(&SingleVTypes[Index], 1)};
             }
-            return ReturnType{{}, Buffer};
+            return ReturnType{{}, {}};
           },
           [this](uint32_t TypeIdx) -> Expect<ReturnType> {
             /// Type index case. t2* = type[index].returns
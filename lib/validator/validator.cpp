@@ -1,5 +1,6 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "validator/validator.h"
+#include "validator/cache.h"
 #include "common/ast/module.h"
 #include "support/log.h"
 
@@ -9,9 +10,52 @@
 namespace SSVM {
 namespace Validator {
 
+namespace {
+
+/// Visit the block, loop, and if instructions in pre-order. Stop and return
+/// false if the visitor returns false.
+template <typename VisitorT>
+bool visitBlocks(AST::InstrVec &Instrs, VisitorT &&Visitor) {
+  for (auto &Instr : Instrs) {
+    switch (Instr->getOpCode()) {
+    case OpCode::Block:
+    case OpCode::Loop: {
+      auto &Block = *static_cast<AST::BlockControlInstruction *>(Instr.get());
+      if (!Visitor(Block) || !visitBlocks(Block.getBody(), Visitor)) {
+        return false;
+      }
+      break;
+    }
+    case OpCode::If: {
+      auto &IfElse = *static_cast<AST::IfElseControlInstruction *>(Instr.get());
+      if (!Visitor(IfElse) || !visitBlocks(IfElse.getIfStatement(), Visitor) ||
+          !visitBlocks(IfElse.getElseStatement(), Visitor)) {
+        return false;
+      }
+      break;
+    }
+    default:
+      break;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
 /// Validate Module. See "include/validator/validator.h".
-Expect<void> Validator::validate(const AST::Module &Mod) {
+Expect<void> Validator::validate(AST::Module &Mod) {
   /// https://webassembly.github.io/spec/core/valid/modules.html
+  const auto &Hash = Mod.getContentHash();
+  if (IsCaching && Hash) {
+    /// The same binary had been validated. Restore the results into AST.
+    if (auto Entry = ValidationCache::getInstance().find(*Hash)) {
+      if (restoreResults(Mod, *Entry)) {
+        return {};
+      }
+    }
+  }
+
   Checker.reset(true);
 
   /// Register type definitions into FormChecker.
@@ -75,6 +119,11 @@ Expect<void> Validator::validate(const AST::Module &Mod) {
     }
   }
 
+  /// Data count section is needed by memory.init and data.drop in code.
+  if (Mod.getDataCountSection() != nullptr) {
+    Checker.setDataCount(Mod.getDataCountSection()->getContent());
+  }
+
   /// Validate code section and expressions.
   if (Mod.getCodeSection() != nullptr) {
     if (auto Res = validate(*Mod.getCodeSection()); !Res) {
@@ -126,9 +175,54 @@ Expect<void> Validator::validate(const AST::Module &Mod) {
     LOG(ERROR) << ErrInfo::InfoAST(Mod.NodeAttr);
     return Unexpect(ErrCode::MultiMemories);
   }
+
+  /// Memorize the validation results of this binary.
+  if (IsCaching && Hash) {
+    ValidationCache::Entry Entry;
+    if (Mod.getCodeSection() != nullptr) {
+      for (const auto &CodeSeg : Mod.getCodeSection()->getContent()) {
+        Entry.MaxStackHeights.push_back(CodeSeg->getMaxStackHeight());
+        visitBlocks(CodeSeg->getInstrs(), [&Entry](const auto &Block) {
+          Entry.BlockArities.emplace_back(Block.getBlockParamNum(),
+                                          Block.getBlockResultNum());
+          return true;
+        });
+      }
+    }
+    ValidationCache::getInstance().insert(*Hash, std::move(Entry));
+  }
   return {};
 }
 
+/// Restore cached results. See "include/validator/validator.h".
+bool Validator::restoreResults(AST::Module &Mod,
+                               const ValidationCache::Entry &Entry) {
+  if (Mod.getCodeSection() == nullptr) {
+    return Entry.MaxStackHeights.empty() && Entry.BlockArities.empty();
+  }
+  const auto &CodeVec = Mod.getCodeSection()->getContent();
+  if (CodeVec.size() != Entry.MaxStackHeights.size()) {
+    return false;
+  }
+  size_t BlockId = 0;
+  for (size_t Id = 0; Id < CodeVec.size(); ++Id) {
+    CodeVec[Id]->setMaxStackHeight(Entry.MaxStackHeights[Id]);
+    if (!visitBlocks(CodeVec[Id]->getInstrs(),
+                     [&Entry, &BlockId](auto &Block) {
+                       if (BlockId >= Entry.BlockArities.size()) {
+                         return false;
+                       }
+                       const auto &[ParamNum, ResultNum] =
+                           Entry.BlockArities[BlockId++];
+                       Block.setBlockArity(ParamNum, ResultNum);
+                       return true;
+                     })) {
+      return false;
+    }
+  }
+  return BlockId == Entry.BlockArities.size();
+}
+
 /// Validate Limit type. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::Limit &Lim) {
   if (Lim.hasMax() && Lim.getMin() > Lim.getMax()) {
@@ -213,7 +307,7 @@ Expect<void> Validator::validate(const AST::ElementSegment &ElemSeg) {
 }
 
 /// Validate Code segment. See "include/validator/validator.h".
-Expect<void> Validator::validate(const AST::CodeSegment &CodeSeg,
+Expect<void> Validator::validate(AST::CodeSegment &CodeSeg,
                                  const uint32_t TypeIdx) {
   /// Reset stack in FormChecker.
   Checker.reset();
@@ -234,11 +328,17 @@ Expect<void> Validator::validate(const AST::CodeSegment &CodeSeg,
     LOG(ERROR) << ErrInfo::InfoAST(ASTNodeAttr::Expression);
     return Unexpect(Res);
   }
+  /// Record the maximum operand stack height for execution.
+  CodeSeg.setMaxStackHeight(Checker.getMaxStackHeight());
   return {};
 }
 
 /// Validate Data segment. See "include/validator/validator.h".
 Expect<void> Validator::validate(const AST::DataSegment &DataSeg) {
+  /// Passive data segment has no memory index and offset.
+  if (DataSeg.isPassive()) {
+    return {};
+  }
   /// Check memory index in context.
   const auto &MemVec = Checker.getMemories();
   if (DataSeg.getIdx() >= MemVec.size()) {
@@ -441,7 +541,7 @@ Expect<void> Validator::validate(const AST::ElementSection &ElemSec) {
 }
 
 /// Validate Code section. See "include/validator/validator.h".
-Expect<void> Validator::validate(const AST::CodeSection &CodeSec) {
+Expect<void> Validator::validate(AST::CodeSection &CodeSec) {
   const auto &CodeVec = CodeSec.getContent();
   const auto &FuncVec = Checker.getFunctions();
 
@@ -455,6 +555,10 @@ Expect<void> Validator::validate(const AST::CodeSection &CodeSec) {
                                              TId, FuncVec.size());
       return Unexpect(ErrCode::InvalidFuncIdx);
     }
+    /// The skipped bodies are compiled, and validated by the compiler.
+    if (CodeVec[Id]->isBodySkipped()) {
+      continue;
+    }
     if (auto Res = validate(*CodeVec[Id].get(), FuncVec[TId]); !Res) {
       LOG(ERROR) << ErrInfo::InfoAST(CodeVec[Id]->NodeAttr);
       return Unexpect(Res);
@@ -521,7 +625,7 @@ Expect<void> Validator::validate(const AST::ExportSection &ExportSec) {
 }
 
 /// Validate constant expression. See "include/validator/validator.h".
-Expect<void> Validator::validateConstExpr(const AST::InstrVec &Instrs,
+Expect<void> Validator::validateConstExpr(AST::InstrVec &Instrs,
                                           Span<const ValType> Returns) {
   for (auto &Instr : Instrs) {
     /// Only these 5 instructions are constant.
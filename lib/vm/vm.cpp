@@ -9,18 +9,27 @@ namespace VM {
 
 VM::VM(Configure &InputConfig)
     : Config(InputConfig), Stage(VMStage::Inited),
-      InterpreterEngine(&Measure, &Stat),
+      LoaderEngine(&Measure), InterpreterEngine(&Measure, &Stat),
       Store(std::make_unique<Runtime::StoreManager>()), StoreRef(*Store.get()) {
   initVM();
 }
 
 VM::VM(Configure &InputConfig, Runtime::StoreManager &S)
     : Config(InputConfig), Stage(VMStage::Inited),
-      InterpreterEngine(&Measure, &Stat), StoreRef(S) {
+      LoaderEngine(&Measure), InterpreterEngine(&Measure, &Stat),
+      StoreRef(S) {
   initVM();
 }
 
 void VM::initVM() {
+  /// Set the execution stack limits.
+  InterpreterEngine.setStackLimit(Config.getMaxStackValues(),
+                                  Config.getMaxCallDepth());
+  InterpreterEngine.setBoundsCheck(Config.getBoundsCheck());
+  InterpreterEngine.setMemoryFastPath(Config.isMemoryFastPath());
+  /// Share validation results of the same binaries across VMs.
+  LoaderEngine.setModuleHashing(Config.isValidationCache());
+  ValidatorEngine.setCaching(Config.isValidationCache());
   /// Set cost table and create import modules from configure.
   CostTab.setCostTable(Configure::VMType::Wasm);
   Measure.setCostTable(CostTab.getCostTable(Configure::VMType::Wasm));
@@ -73,6 +82,21 @@ Expect<void> VM::registerModule(std::string_view Name, Span<const Byte> Code) {
   }
 }
 
+Expect<void> VM::registerModule(std::string_view Name,
+                                const StaticModule &Module) {
+  if (Stage == VMStage::Instantiated) {
+    /// When registering module, instantiated module in store will be reset.
+    /// Therefore the instantiation should restart.
+    Stage = VMStage::Validated;
+  }
+  /// Load module.
+  if (auto Res = LoaderEngine.parseModule(Module)) {
+    return registerModule(Name, *(*Res).get());
+  } else {
+    return Unexpect(Res);
+  }
+}
+
 Expect<void> VM::registerModule(const Runtime::ImportObject &Obj) {
   if (Stage == VMStage::Instantiated) {
     /// When registering module, instantiated module in store will be reset.
@@ -82,8 +106,7 @@ Expect<void> VM::registerModule(const Runtime::ImportObject &Obj) {
   return InterpreterEngine.registerModule(StoreRef, Obj);
 }
 
-Expect<void> VM::registerModule(std::string_view Name,
-                                const AST::Module &Module) {
+Expect<void> VM::registerModule(std::string_view Name, AST::Module &Module) {
   /// Validate module.
   if (auto Res = ValidatorEngine.validate(Module); !Res) {
     return Unexpect(Res);
@@ -123,7 +146,7 @@ Expect<std::vector<ValVariant>> VM::runWasmFile(Span<const Byte> Code,
   }
 }
 
-Expect<std::vector<ValVariant>> VM::runWasmFile(const AST::Module &Module,
+Expect<std::vector<ValVariant>> VM::runWasmFile(AST::Module &Module,
                                                 std::string_view Func,
                                                 Span<const ValVariant> Params) {
   if (auto Res = ValidatorEngine.validate(Module); !Res) {
@@ -168,6 +191,17 @@ Expect<void> VM::loadWasm(Span<const Byte> Code) {
   return {};
 }
 
+Expect<void> VM::loadWasm(const StaticModule &Module) {
+  /// If not load successfully, the previous status will be reserved.
+  if (auto Res = LoaderEngine.parseModule(Module)) {
+    Mod = std::move(*Res);
+    Stage = VMStage::Loaded;
+  } else {
+    return Unexpect(Res);
+  }
+  return {};
+}
+
 Expect<void> VM::validate() {
   if (Stage < VMStage::Loaded) {
     /// When module is not loaded, not validate.
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/aot/AOTboundsCheckTest.cpp - Compiled bounds check tests ===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of importing memories into the code compiled
+/// with the bounds check strategies.
+///
+//===----------------------------------------------------------------------===//
+
+#include "aot/compiler.h"
+#include "common/ast/module.h"
+#include "loader/loader.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+/// (module (memory (export "mem") 1))
+std::vector<SSVM::Byte> EnvWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic, version.
+    0x05U, 0x03U, 0x01U, 0x00U, 0x01U, /// Memory section: 1 page.
+    0x07U, 0x07U, 0x01U, 0x03U, 0x6DU, 0x65U, 0x6DU, 0x02U,
+    0x00U /// Export section: "mem".
+};
+
+/// (module
+///   (import "env" "mem" (memory 1))
+///   (func (export "load") (param i32) (result i32)
+///     (i32.load8_u (local.get 0))))
+std::vector<SSVM::Byte> ImportWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic, version.
+    0x01U, 0x06U, 0x01U, 0x60U, 0x01U, 0x7FU, 0x01U, 0x7FU, /// Type section.
+    0x02U, 0x0CU, 0x01U, 0x03U, 0x65U, 0x6EU, 0x76U, 0x03U, 0x6DU, 0x65U,
+    0x6DU, 0x02U, 0x00U, 0x01U, /// Import section: "env" "mem".
+    0x03U, 0x02U, 0x01U, 0x00U, /// Function section.
+    0x07U, 0x08U, 0x01U, 0x04U, 0x6CU, 0x6FU, 0x61U, 0x64U, 0x00U,
+    0x00U,                             /// Export section: "load".
+    0x0AU, 0x09U, 0x01U, 0x07U, 0x00U, /// Code section, no locals.
+    0x20U, 0x00U,                      /// local.get 0
+    0x2DU, 0x00U, 0x00U,               /// i32.load8_u
+    0x0BU                              /// end
+};
+
+/// (module
+///   (memory 1)
+///   (func (export "grow") (param i32) (result i32)
+///     (memory.grow (local.get 0)))
+///   (func (export "store") (param i32 i32)
+///     (i32.store8 (local.get 0) (local.get 1)))
+///   (func (export "load") (param i32) (result i32)
+///     (i32.load8_u (local.get 0))))
+std::vector<SSVM::Byte> GrowWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic, version.
+    0x01U, 0x0BU, 0x02U, 0x60U, 0x01U, 0x7FU, 0x01U, 0x7FU, 0x60U, 0x02U,
+    0x7FU, 0x7FU, 0x00U, /// Type section: [i32] -> [i32], [i32 i32] -> [].
+    0x03U, 0x04U, 0x03U, 0x00U, 0x01U, 0x00U, /// Function section.
+    0x05U, 0x03U, 0x01U, 0x00U, 0x01U,        /// Memory section: 1 page.
+    0x07U, 0x17U, 0x03U, 0x04U, 0x67U, 0x72U, 0x6FU, 0x77U, 0x00U, 0x00U,
+    0x05U, 0x73U, 0x74U, 0x6FU, 0x72U, 0x65U, 0x00U, 0x01U, 0x04U, 0x6CU,
+    0x6FU, 0x61U, 0x64U, 0x00U, 0x02U, /// Export section.
+    0x0AU, 0x1AU, 0x03U,               /// Code section.
+    0x06U, 0x00U, 0x20U, 0x00U, 0x40U, 0x00U, 0x0BU, /// memory.grow
+    0x09U, 0x00U, 0x20U, 0x00U, 0x20U, 0x01U, 0x3AU, 0x00U, 0x00U,
+    0x0BU,                                                  /// i32.store8
+    0x07U, 0x00U, 0x20U, 0x00U, 0x2DU, 0x00U, 0x00U, 0x0BU /// i32.load8_u
+};
+
+void compileWasm(SSVM::BoundsCheck Bounds, std::string_view Path) {
+  SSVM::Loader::Loader Loader;
+  auto Module = Loader.parseModule(ImportWasm);
+  ASSERT_TRUE(Module);
+  SSVM::AOT::Compiler Compiler;
+  Compiler.setBoundsCheck(Bounds);
+  ASSERT_TRUE(Compiler.compile(ImportWasm, **Module, Path));
+}
+
+SSVM::Expect<void> instantiate(SSVM::BoundsCheck Runtime,
+                               std::string_view Path) {
+  SSVM::VM::Configure Conf;
+  Conf.setBoundsCheck(Runtime);
+  SSVM::VM::VM VM(Conf);
+  return VM.registerModule("env"sv, EnvWasm)
+      .and_then([&]() { return VM.loadWasm(Path); })
+      .and_then([&]() { return VM.validate(); })
+      .and_then([&]() { return VM.instantiate(); });
+}
+
+TEST(AOTBoundsCheckTest, GuardPageCodeRefusesMemoryWithoutGuardPages) {
+  compileWasm(SSVM::BoundsCheck::GuardPage, "./import-mem-guard.so"sv);
+  auto Res =
+      instantiate(SSVM::BoundsCheck::Explicit, "./import-mem-guard.so"sv);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::IncompatibleImportType);
+  EXPECT_TRUE(
+      instantiate(SSVM::BoundsCheck::GuardPage, "./import-mem-guard.so"sv));
+}
+
+TEST(AOTBoundsCheckTest, ExplicitCodeAcceptsMemoryWithoutGuardPages) {
+  compileWasm(SSVM::BoundsCheck::Explicit, "./import-mem-explicit.so"sv);
+  EXPECT_TRUE(
+      instantiate(SSVM::BoundsCheck::Explicit, "./import-mem-explicit.so"sv));
+}
+
+TEST(AOTBoundsCheckTest, ExplicitCodeFollowsMovedMemory) {
+  {
+    SSVM::Loader::Loader Loader;
+    auto Module = Loader.parseModule(GrowWasm);
+    ASSERT_TRUE(Module);
+    SSVM::AOT::Compiler Compiler;
+    Compiler.setBoundsCheck(SSVM::BoundsCheck::Explicit);
+    ASSERT_TRUE(Compiler.compile(GrowWasm, **Module, "./grow-explicit.so"sv));
+  }
+  SSVM::VM::Configure Conf;
+  Conf.setBoundsCheck(SSVM::BoundsCheck::Explicit);
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm("./grow-explicit.so"sv));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  auto execute = [&VM](std::string_view Func,
+                       std::vector<SSVM::ValVariant> Params) {
+    return VM.execute(Func, Params);
+  };
+
+  /// The memory without maximum is moved when growing beyond its
+  /// reservation, and the compiled code accesses it at the new address.
+  ASSERT_TRUE(execute("store", {UINT32_C(0), UINT32_C(7)}));
+  auto Res = execute("grow", {UINT32_C(63)});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(std::get<uint32_t>(Res->front()), 1U);
+  Res = execute("load", {UINT32_C(0)});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(std::get<uint32_t>(Res->front()), 7U);
+  const uint32_t Last = 64 * 65536 - 1;
+  ASSERT_TRUE(execute("store", {Last, UINT32_C(9)}));
+  Res = execute("load", {Last});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(std::get<uint32_t>(Res->front()), 9U);
+  Res = execute("load", {Last + 1});
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::MemoryOutOfBounds);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/aot/AOTcacheTest.cpp - Object cache tests ---------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the per-function object cache of the AOT
+/// compiler.
+///
+//===----------------------------------------------------------------------===//
+
+#include "aot/compiler.h"
+#include "common/ast/module.h"
+#include "loader/loader.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+/// (module
+///   (func (export "a") (result i32) (i32.const 1))
+///   (func (export "b") (result i32) (i32.const B))
+///   (func (export "c") (result i32) (i32.const 3)))
+std::vector<SSVM::Byte> makeWasm(SSVM::Byte B) {
+  return {
+      0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic.
+      0x01U, 0x05U, 0x01U, 0x60U, 0x00U, 0x01U, 0x7FU, /// Type: [] -> [i32].
+      0x03U, 0x04U, 0x03U, 0x00U, 0x00U, 0x00U,        /// Function section.
+      0x07U, 0x0DU, 0x03U, 0x01U, 0x61U, 0x00U, 0x00U, 0x01U, 0x62U, 0x00U,
+      0x01U, 0x01U, 0x63U, 0x00U, 0x02U, /// Export section: "a", "b", "c".
+      0x0AU, 0x10U, 0x03U,               /// Code section.
+      0x04U, 0x00U, 0x41U, 0x01U, 0x0BU, /// i32.const 1
+      0x04U, 0x00U, 0x41U, B, 0x0BU,     /// i32.const B
+      0x04U, 0x00U, 0x41U, 0x03U, 0x0BU  /// i32.const 3
+  };
+}
+
+void compileWasm(const std::vector<SSVM::Byte> &Wasm,
+                 const std::filesystem::path &CacheDir,
+                 std::string_view Path) {
+  SSVM::Loader::Loader Loader;
+  auto Module = Loader.parseModule(Wasm);
+  ASSERT_TRUE(Module);
+  SSVM::AOT::Compiler Compiler;
+  Compiler.setCacheDir(CacheDir.u8string());
+  ASSERT_TRUE(Compiler.compile(Wasm, **Module, Path));
+}
+
+size_t countObjects(const std::filesystem::path &CacheDir) {
+  return std::distance(std::filesystem::directory_iterator(CacheDir),
+                       std::filesystem::directory_iterator());
+}
+
+TEST(AOTCacheTest, EditedFunctionOnly) {
+  const std::filesystem::path CacheDir("./cache-edit");
+  std::filesystem::remove_all(CacheDir);
+
+  /// 1. Every function is compiled into the cache.
+  compileWasm(makeWasm(0x02U), CacheDir, "./cache-edit-1.so"sv);
+  EXPECT_EQ(countObjects(CacheDir), 3U);
+  /// 2. The unchanged module hits all entries.
+  compileWasm(makeWasm(0x02U), CacheDir, "./cache-edit-1.so"sv);
+  EXPECT_EQ(countObjects(CacheDir), 3U);
+  /// 3. Editing one function only adds its entry, and the others still hit.
+  compileWasm(makeWasm(0x05U), CacheDir, "./cache-edit-2.so"sv);
+  EXPECT_EQ(countObjects(CacheDir), 4U);
+
+  SSVM::VM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm("./cache-edit-2.so"sv));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  for (const auto &[Name, Expected] :
+       {std::pair("a"sv, 1U), std::pair("b"sv, 5U), std::pair("c"sv, 3U)}) {
+    auto Res = VM.execute(Name);
+    ASSERT_TRUE(Res);
+    EXPECT_EQ(std::get<uint32_t>(Res->front()), Expected);
+  }
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
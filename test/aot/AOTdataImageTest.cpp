@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/aot/AOTdataImageTest.cpp - Data segment image tests -----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the page aligned images of the data
+/// segments in the compiled binaries.
+///
+//===----------------------------------------------------------------------===//
+
+#include "aot/compiler.h"
+#include "common/ast/module.h"
+#include "loader/loader.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <memory>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+/// Size of the data segment at offset 0, which has whole image pages.
+static inline constexpr uint32_t kFillSize = 8192;
+
+/// Offset of the data segment at `global.get`, which is exported by "env".
+static inline constexpr uint32_t kBase = 16384;
+
+/// Append the unsigned LEB128 encoding of the value.
+void appendU32(std::vector<SSVM::Byte> &Out, uint32_t Value) {
+  do {
+    SSVM::Byte Byte = Value & 0x7FU;
+    Value >>= 7;
+    if (Value != 0) {
+      Byte |= 0x80U;
+    }
+    Out.push_back(Byte);
+  } while (Value != 0);
+}
+
+/// Append the section with the size of the content.
+void appendSection(std::vector<SSVM::Byte> &Out, SSVM::Byte Id,
+                   const std::vector<SSVM::Byte> &Content) {
+  Out.push_back(Id);
+  appendU32(Out, Content.size());
+  Out.insert(Out.end(), Content.begin(), Content.end());
+}
+
+/// (module
+///   (global (export "base") i32 (i32.const 16384)))
+std::vector<SSVM::Byte> EnvWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic, version.
+    0x06U, 0x08U, 0x01U, 0x7FU, 0x00U,                      /// Global section.
+    0x41U, 0x80U, 0x80U, 0x01U, 0x0BU, /// i32.const 16384, end.
+    0x07U, 0x08U, 0x01U, 0x04U, 0x62U, 0x61U, 0x73U, 0x65U,
+    0x03U, 0x00U /// Export section: "base".
+};
+
+/// (module
+///   (import "env" "base" (global i32))  ;; Only if WithBase.
+///   (memory 2)
+///   (func (export "load") (param i32) (result i32)
+///     (i32.load8_u (local.get 0)))
+///   (data (i32.const 0) "<Fill x 8192>")
+///   (data (global.get 0) "PIC!"))       ;; Only if WithBase.
+std::vector<SSVM::Byte> makeDataWasm(char Fill, bool WithBase) {
+  std::vector<SSVM::Byte> Wasm = {0x00U, 0x61U, 0x73U, 0x6DU,
+                                  0x01U, 0x00U, 0x00U, 0x00U};
+  /// Type section: [i32] -> [i32].
+  appendSection(Wasm, 0x01U, {0x01U, 0x60U, 0x01U, 0x7FU, 0x01U, 0x7FU});
+  if (WithBase) {
+    /// Import section: immutable i32 global "env" "base".
+    appendSection(Wasm, 0x02U,
+                  {0x01U, 0x03U, 0x65U, 0x6EU, 0x76U, 0x04U, 0x62U, 0x61U,
+                   0x73U, 0x65U, 0x03U, 0x7FU, 0x00U});
+  }
+  /// Function section.
+  appendSection(Wasm, 0x03U, {0x01U, 0x00U});
+  /// Memory section: 2 pages.
+  appendSection(Wasm, 0x05U, {0x01U, 0x00U, 0x02U});
+  /// Export section: "load".
+  appendSection(Wasm, 0x07U,
+                {0x01U, 0x04U, 0x6CU, 0x6FU, 0x61U, 0x64U, 0x00U, 0x00U});
+  /// Code section: local.get 0, i32.load8_u 0 0, end.
+  appendSection(Wasm, 0x0AU,
+                {0x01U, 0x07U, 0x00U, 0x20U, 0x00U, 0x2DU, 0x00U, 0x00U,
+                 0x0BU});
+  /// Data section.
+  std::vector<SSVM::Byte> Data = {WithBase ? 0x02U : 0x01U};
+  Data.insert(Data.end(), {0x00U, 0x41U, 0x00U, 0x0BU});
+  appendU32(Data, kFillSize);
+  Data.insert(Data.end(), kFillSize, static_cast<SSVM::Byte>(Fill));
+  if (WithBase) {
+    /// Active segment at global.get 0 with the bytes "PIC!".
+    Data.insert(Data.end(), {0x00U, 0x23U, 0x00U, 0x0BU, 0x04U, 0x50U, 0x49U,
+                             0x43U, 0x21U});
+  }
+  appendSection(Wasm, 0x0BU, Data);
+  return Wasm;
+}
+
+void compileWasm(const std::vector<SSVM::Byte> &Wasm, std::string_view Path) {
+  SSVM::Loader::Loader Loader;
+  auto Module = Loader.parseModule(Wasm);
+  ASSERT_TRUE(Module);
+  SSVM::AOT::Compiler Compiler;
+  ASSERT_TRUE(Compiler.compile(Wasm, **Module, Path));
+}
+
+/// Read the first byte of the data image.
+int readImage(const SSVM::AST::DataSegment &Seg) {
+  char Byte = 0;
+  if (pread(Seg.getImageFD(), &Byte, 1, Seg.getImageOffset()) != 1) {
+    return -1;
+  }
+  return Byte;
+}
+
+TEST(AOTDataImageTest, GlobalOffsetSegment) {
+  compileWasm(makeDataWasm('A', true), "./data-pic.so"sv);
+
+  SSVM::VM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.registerModule("env"sv, EnvWasm));
+  ASSERT_TRUE(VM.loadWasm("./data-pic.so"sv));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  const std::pair<uint32_t, uint32_t> Expects[] = {
+      {0, 'A'}, {kFillSize - 1, 'A'}, {kFillSize, 0}, {kBase, 'P'},
+      {kBase + 3, '!'}};
+  for (const auto &[Addr, Expected] : Expects) {
+    const std::vector<SSVM::ValVariant> Params = {Addr};
+    auto Res = VM.execute("load", Params);
+    ASSERT_TRUE(Res);
+    EXPECT_EQ(std::get<uint32_t>(Res->front()), Expected) << Addr;
+  }
+}
+
+TEST(AOTDataImageTest, ImageOutlivesNextLoad) {
+  compileWasm(makeDataWasm('A', false), "./data-a.so"sv);
+  compileWasm(makeDataWasm('B', false), "./data-b.so"sv);
+
+  std::unique_ptr<SSVM::AST::Module> ModA, ModB;
+  {
+    SSVM::Loader::Loader Loader;
+    auto ResA = Loader.parseModule("./data-a.so"sv);
+    ASSERT_TRUE(ResA);
+    ModA = std::move(*ResA);
+    auto ResB = Loader.parseModule("./data-b.so"sv);
+    ASSERT_TRUE(ResB);
+    ModB = std::move(*ResB);
+  }
+  /// The images are still valid after loading the next binary and after
+  /// destroying the loader.
+  const auto &SegA = *ModA->getDataSection()->getContent().front();
+  const auto &SegB = *ModB->getDataSection()->getContent().front();
+  ASSERT_GE(SegA.getImageFD(), 0);
+  ASSERT_GE(SegB.getImageFD(), 0);
+  EXPECT_NE(SegA.getImageFD(), SegB.getImageFD());
+  EXPECT_EQ(readImage(SegA), 'A');
+  EXPECT_EQ(readImage(SegB), 'B');
+
+  /// Destroying a module only closes its own image.
+  ModA.reset();
+  EXPECT_EQ(readImage(SegB), 'B');
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,140 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/aot/AOThostFuncTest.cpp - Compiled host call tests ------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of calling the imported host functions from
+/// the compiled code through the host function bindings.
+///
+//===----------------------------------------------------------------------===//
+
+#include "aot/compiler.h"
+#include "common/ast/module.h"
+#include "loader/loader.h"
+#include "runtime/hostfunc.h"
+#include "runtime/importobj.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+class HostAdd : public SSVM::Runtime::HostFunction<HostAdd> {
+public:
+  SSVM::Expect<uint32_t> body(SSVM::Runtime::Instance::MemoryInstance *,
+                              uint32_t A, uint32_t B) {
+    return A + B;
+  }
+};
+
+class HostGrow : public SSVM::Runtime::HostFunction<HostGrow> {
+public:
+  SSVM::Expect<uint32_t> body(SSVM::Runtime::Instance::MemoryInstance *MemInst,
+                              uint32_t Count) {
+    if (MemInst == nullptr) {
+      return SSVM::Unexpect(SSVM::ErrCode::ExecutionFailed);
+    }
+    const uint32_t Old = MemInst->getDataPageSize();
+    if (!MemInst->growPage(Count)) {
+      return UINT32_MAX;
+    }
+    return Old;
+  }
+};
+
+class HostModule : public SSVM::Runtime::ImportObject {
+public:
+  HostModule() : ImportObject("env") {
+    addHostFunc("add", std::make_unique<HostAdd>());
+    addHostFunc("grow", std::make_unique<HostGrow>());
+  }
+};
+
+/// (module
+///   (import "env" "add" (func $add (param i32 i32) (result i32)))
+///   (import "env" "grow" (func $grow (param i32) (result i32)))
+///   (memory 1)
+///   (func (export "sum") (param i32 i32) (result i32)
+///     (call $add (local.get 0) (local.get 1)))
+///   (func (export "grow") (param i32) (result i32)
+///     (drop (call $grow (i32.const 63)))
+///     (i32.store8 (local.get 0) (i32.const 7))
+///     (i32.load8_u (local.get 0))))
+std::vector<SSVM::Byte> HostWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic, version.
+    0x01U, 0x0CU, 0x02U, 0x60U, 0x02U, 0x7FU, 0x7FU, 0x01U, 0x7FU, 0x60U,
+    0x01U, 0x7FU, 0x01U, 0x7FU, /// Type section: [i32 i32] -> [i32],
+                                /// [i32] -> [i32].
+    0x02U, 0x16U, 0x02U, 0x03U, 0x65U, 0x6EU, 0x76U, 0x03U, 0x61U, 0x64U,
+    0x64U, 0x00U, 0x00U, 0x03U, 0x65U, 0x6EU, 0x76U, 0x04U, 0x67U, 0x72U,
+    0x6FU, 0x77U, 0x00U, 0x01U,        /// Import section: "add", "grow".
+    0x03U, 0x03U, 0x02U, 0x00U, 0x01U, /// Function section.
+    0x05U, 0x03U, 0x01U, 0x00U, 0x01U, /// Memory section: 1 page.
+    0x07U, 0x0EU, 0x02U, 0x03U, 0x73U, 0x75U, 0x6DU, 0x00U, 0x02U, 0x04U,
+    0x67U, 0x72U, 0x6FU, 0x77U, 0x00U, 0x03U, /// Export section.
+    0x0AU, 0x1EU, 0x02U,                      /// Code section.
+    0x08U, 0x00U, 0x20U, 0x00U, 0x20U, 0x01U, 0x10U, 0x00U, 0x0BU, /// call 0
+    0x13U, 0x00U, 0x41U, 0x3FU, 0x10U, 0x01U, 0x1AU, /// drop (call 1)
+    0x20U, 0x00U, 0x41U, 0x07U, 0x3AU, 0x00U, 0x00U, /// i32.store8
+    0x20U, 0x00U, 0x2DU, 0x00U, 0x00U, 0x0BU         /// i32.load8_u
+};
+
+void compileWasm(SSVM::BoundsCheck Bounds, std::string_view Path) {
+  SSVM::Loader::Loader Loader;
+  auto Module = Loader.parseModule(HostWasm);
+  ASSERT_TRUE(Module);
+  SSVM::AOT::Compiler Compiler;
+  Compiler.setBoundsCheck(Bounds);
+  ASSERT_TRUE(Compiler.compile(HostWasm, **Module, Path));
+}
+
+TEST(AOTHostFuncTest, CallBoundHostFunction) {
+  compileWasm(SSVM::BoundsCheck::GuardPage, "./host-call.so"sv);
+
+  SSVM::VM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  HostModule Env;
+  ASSERT_TRUE(VM.registerModule(Env));
+  ASSERT_TRUE(VM.loadWasm("./host-call.so"sv));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  std::vector<SSVM::ValVariant> Params = {UINT32_C(40), UINT32_C(2)};
+  auto Res = VM.execute("sum", Params);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(std::get<uint32_t>(Res->front()), 42U);
+}
+
+TEST(AOTHostFuncTest, ExplicitCodeFollowsMemoryGrownByHost) {
+  compileWasm(SSVM::BoundsCheck::Explicit, "./host-grow.so"sv);
+
+  SSVM::VM::Configure Conf;
+  Conf.setBoundsCheck(SSVM::BoundsCheck::Explicit);
+  SSVM::VM::VM VM(Conf);
+  HostModule Env;
+  ASSERT_TRUE(VM.registerModule(Env));
+  ASSERT_TRUE(VM.loadWasm("./host-grow.so"sv));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  /// The host function moves the memory without maximum, and the calling
+  /// compiled code accesses the grown pages at the new address.
+  std::vector<SSVM::ValVariant> Params = {UINT32_C(63 * 65536)};
+  auto Res = VM.execute("grow", Params);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(std::get<uint32_t>(Res->front()), 7U);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
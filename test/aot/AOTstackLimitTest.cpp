@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/aot/AOTstackLimitTest.cpp - Compiled stack limit tests --===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the call depth limit of compiled code,
+/// where direct calls between compiled functions bypass the interpreter.
+///
+//===----------------------------------------------------------------------===//
+
+#include "aot/compiler.h"
+#include "common/ast/module.h"
+#include "loader/loader.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+/// (module (func $f (export "recurse") (call $f)))
+std::vector<SSVM::Byte> RecurseWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic, version.
+    0x01U, 0x04U, 0x01U, 0x60U, 0x00U, 0x00U, /// Type section: [] -> [].
+    0x03U, 0x02U, 0x01U, 0x00U,               /// Function section.
+    0x07U, 0x0BU, 0x01U, 0x07U, 0x72U, 0x65U, 0x63U, 0x75U,
+    0x72U, 0x73U, 0x65U, 0x00U, 0x00U, /// Export section: "recurse".
+    0x0AU, 0x06U, 0x01U, 0x04U, 0x00U, /// Code section, no locals.
+    0x10U, 0x00U,                      /// call 0
+    0x0BU                              /// end
+};
+
+TEST(AOTStackLimitTest, RecursionExhaustsCallDepth) {
+  SSVM::Loader::Loader Loader;
+  auto Module = Loader.parseModule(RecurseWasm);
+  ASSERT_TRUE(Module);
+  SSVM::AOT::Compiler Compiler;
+  ASSERT_TRUE(Compiler.compile(RecurseWasm, **Module, "./recurse.so"sv));
+
+  SSVM::VM::Configure Conf;
+  Conf.setMaxCallDepth(64);
+  SSVM::VM::VM VM(Conf);
+  auto Res = VM.runWasmFile("./recurse.so"sv, "recurse");
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::CallStackExhausted);
+
+  /// The executor is still usable after the trap.
+  Res = VM.runWasmFile("./recurse.so"sv, "recurse");
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::CallStackExhausted);
+}
+
+TEST(AOTStackLimitTest, DefaultLimitFitsNativeStack) {
+  SSVM::Loader::Loader Loader;
+  auto Module = Loader.parseModule(RecurseWasm);
+  ASSERT_TRUE(Module);
+  SSVM::AOT::Compiler Compiler;
+  ASSERT_TRUE(Compiler.compile(RecurseWasm, **Module, "./recurse.so"sv));
+
+  /// The default limit traps before the recursion overflows the native stack.
+  SSVM::VM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  auto Res = VM.runWasmFile("./recurse.so"sv, "recurse");
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::CallStackExhausted);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
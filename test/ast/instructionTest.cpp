@@ -281,8 +281,12 @@ TEST(InstructionTest, LoadMemoryInstruction) {
   ///   2.  Load invalid memory size or grow instruction.
   ///   3.  Load valid memory args.
   ///   4.  Load valid memory size instruction.
+  ///   5.  Load valid memory.copy and memory.init instructions.
+  ///   6.  Load invalid memory.copy instruction.
   SSVM::OpCode Op1 = SSVM::OpCode::I32__load;
   SSVM::OpCode Op2 = SSVM::OpCode::Memory__grow;
+  SSVM::OpCode Op3 = SSVM::OpCode::Memory__copy;
+  SSVM::OpCode Op4 = SSVM::OpCode::Memory__init;
 
   Mgr.clearBuffer();
   SSVM::AST::MemoryInstruction Ins1(Op1);
@@ -315,6 +319,32 @@ TEST(InstructionTest, LoadMemoryInstruction) {
   Mgr.setCode(Vec4);
   SSVM::AST::MemoryInstruction Ins5(Op2);
   EXPECT_TRUE(Ins5.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec5 = {
+      0x00U, 0x00U /// Destination and source memory indices.
+  };
+  Mgr.setCode(Vec5);
+  SSVM::AST::MemoryInstruction Ins6(Op3);
+  EXPECT_TRUE(Ins6.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec6 = {
+      0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Data index.
+      0x00U                              /// Memory index.
+  };
+  Mgr.setCode(Vec6);
+  SSVM::AST::MemoryInstruction Ins7(Op4);
+  EXPECT_TRUE(Ins7.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(Ins7.getDataIndex(), 0xFFFFFFFFU);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec7 = {
+      0x00U, 0x01U /// Invalid source memory index.
+  };
+  Mgr.setCode(Vec7);
+  SSVM::AST::MemoryInstruction Ins8(Op3);
+  EXPECT_FALSE(Ins8.loadBinary(Mgr));
 }
 
 TEST(InstructionTest, LoadConstInstruction) {
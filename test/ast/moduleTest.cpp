@@ -14,6 +14,9 @@
 #include "loader/filemgr.h"
 #include "gtest/gtest.h"
 
+#include <cstdio>
+#include <fstream>
+
 namespace {
 
 SSVM::FileMgrVector Mgr;
@@ -78,12 +81,60 @@ TEST(ModuleTest, LoadInvalidSecModule) {
       0x09U, 0x81U, 0x80U, 0x80U, 0x80U, 0x00U, 0x00U, /// Element section
       0x0AU, 0x81U, 0x80U, 0x80U, 0x80U, 0x00U, 0x00U, /// Code section
       0x0BU, 0x81U, 0x80U, 0x80U, 0x80U, 0x00U, 0x00U, /// Data section
-      0x0CU, 0x81U, 0x80U, 0x80U, 0x80U, 0x00U, 0x00U  /// Invalid section
+      0x0CU, 0x81U, 0x80U, 0x80U, 0x80U, 0x00U, 0x00U, /// Data count section
+      0x0DU, 0x81U, 0x80U, 0x80U, 0x80U, 0x00U, 0x00U  /// Invalid section
   };
   Mgr.setCode(Vec);
   EXPECT_FALSE(Mod.loadBinary(Mgr));
 }
 
+TEST(ModuleTest, LoadNameSection) {
+  /// 5. Test load module with name section
+  ///
+  ///   1.  Load name section from vector.
+  ///   2.  Load name section from file stream.
+  ///   3.  Load module with malformed name section.
+  std::vector<unsigned char> Vec = {
+      0x00U, 0x61U, 0x73U, 0x6DU,                     /// Magic
+      0x01U, 0x00U, 0x00U, 0x00U,                     /// Version
+      0x00U, 0x0BU,                                   /// Custom section
+      0x04U, 0x6EU, 0x61U, 0x6DU, 0x65U,              /// Name: "name"
+      0x01U, 0x04U, 0x01U, 0x00U, 0x01U, 0x66U,       /// Function names: 0 "f"
+      0x01U, 0x81U, 0x80U, 0x80U, 0x80U, 0x00U, 0x00U /// Type section
+  };
+  Mgr.clearBuffer();
+  Mgr.setCode(Vec);
+  SSVM::AST::Module Mod1;
+  EXPECT_TRUE(Mod1.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  ASSERT_NE(Mod1.getNameSection(), nullptr);
+  EXPECT_EQ(Mod1.getNameSection()->getFunctionName(0), "f");
+
+  {
+    std::ofstream Fout("moduleTestName.wasm", std::ios::binary);
+    Fout.write(reinterpret_cast<const char *>(Vec.data()), Vec.size());
+  }
+  SSVM::FileMgrFStream FSMgr;
+  ASSERT_TRUE(FSMgr.setPath("moduleTestName.wasm"));
+  SSVM::AST::Module Mod2;
+  EXPECT_TRUE(Mod2.loadBinary(FSMgr));
+  ASSERT_NE(Mod2.getNameSection(), nullptr);
+  EXPECT_EQ(Mod2.getNameSection()->getFunctionName(0), "f");
+  std::remove("moduleTestName.wasm");
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec3 = {
+      0x00U, 0x61U, 0x73U, 0x6DU,        /// Magic
+      0x01U, 0x00U, 0x00U, 0x00U,        /// Version
+      0x00U, 0x08U,                      /// Custom section
+      0x04U, 0x6EU, 0x61U, 0x6DU, 0x65U, /// Name: "name"
+      0x01U, 0x05U, 0x03U                /// Truncated function names
+  };
+  Mgr.setCode(Vec3);
+  SSVM::AST::Module Mod3;
+  EXPECT_TRUE(Mod3.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(Mod3.getNameSection(), nullptr);
+}
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
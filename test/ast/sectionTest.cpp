@@ -24,6 +24,8 @@ TEST(SectionTest, LoadCustomSection) {
   ///   1.  Load invalid empty section.
   ///   2.  Load custom section without contents.
   ///   3.  Load custom section with contents.
+  ///   4.  Load custom section with content length out of range.
+  ///   5.  Load custom section with name length out of content size.
   Mgr.clearBuffer();
   SSVM::AST::CustomSection Sec1;
   EXPECT_FALSE(Sec1.loadBinary(Mgr));
@@ -44,6 +46,29 @@ TEST(SectionTest, LoadCustomSection) {
   Mgr.setCode(Vec3);
   SSVM::AST::CustomSection Sec3;
   EXPECT_TRUE(Sec3.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(Sec3.getContentOffset(), 6U);
+  EXPECT_EQ(Sec3.getContentLength(), 6U);
+  auto Content3 = Sec3.getContent(Vec3);
+  EXPECT_TRUE(Content3 && Content3->size() == 6 && (*Content3)[0] == 0xFFU);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec4 = {
+      0x87U, 0x80U, 0x80U, 0x80U, 0x00U, /// Content size = 7
+      0x04U, 0x6EU, 0x61U, 0x6DU, 0x65U, /// Name: "name"
+      0x00U                              /// Content
+  };
+  Mgr.setCode(Vec4);
+  SSVM::AST::CustomSection Sec4;
+  EXPECT_FALSE(Sec4.loadBinary(Mgr));
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec5 = {
+      0x83U, 0x80U, 0x80U, 0x80U, 0x00U, /// Content size = 3
+      0x04U, 0x6EU, 0x61U, 0x6DU, 0x65U  /// Name: "name"
+  };
+  Mgr.setCode(Vec5);
+  SSVM::AST::CustomSection Sec5;
+  EXPECT_FALSE(Sec5.loadBinary(Mgr));
 }
 
 TEST(SectionTest, LoadTypeSection) {
@@ -506,17 +531,20 @@ TEST(SectionTest, LoadDataSection) {
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec4 = {
-      0xABU, 0x80U, 0x80U, 0x80U, 0x00U, /// Content size = 43
+      0xAEU, 0x80U, 0x80U, 0x80U, 0x00U, /// Content size = 46
       0x03U,                             /// Vector length = 3
       /// vec[0]
+      0x02U,                             /// Active segment with memory index
       0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Memory index
       0x45U, 0x46U, 0x47U, 0x0BU,        /// Expression
       0x04U, 0x74U, 0x65U, 0x73U, 0x74U, /// Vector length = 4, "test"
       /// vec[1]
+      0x02U,                             /// Active segment with memory index
       0xF9U, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Memory index
       0x45U, 0x46U, 0x47U, 0x0BU,        /// Expression
       0x04U, 0x74U, 0x65U, 0x73U, 0x74U, /// Vector length = 4, "test"
       /// vec[2]
+      0x02U,                             /// Active segment with memory index
       0xF0U, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Memory index
       0x45U, 0x46U, 0x47U, 0x0BU,        /// Expression
       0x04U, 0x74U, 0x65U, 0x73U, 0x74U  /// Vector length = 4, "test"
@@ -526,4 +554,50 @@ TEST(SectionTest, LoadDataSection) {
   EXPECT_TRUE(Sec4.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
 }
 
+TEST(SectionTest, LoadNameSection) {
+  /// 13. Test load name section content.
+  ///
+  ///   1.  Load empty content.
+  ///   2.  Load module name and function names subsections.
+  ///   3.  Load unknown subsection which will be skipped.
+  ///   4.  Load subsection with mismatched size.
+  Mgr.clearBuffer();
+  SSVM::AST::NameSection Sec1;
+  EXPECT_TRUE(Sec1.loadBinary(Mgr));
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec2 = {
+      0x00U, 0x02U, 0x01U, 0x6DU,               /// Module name: "m"
+      0x01U, 0x08U, 0x02U,                      /// Function names, vec(2)
+      0x00U, 0x01U, 0x61U,                      /// 0: "a"
+      0x03U, 0x02U, 0x62U, 0x63U                /// 3: "bc"
+  };
+  Mgr.setCode(Vec2);
+  SSVM::AST::NameSection Sec2;
+  EXPECT_TRUE(Sec2.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(Sec2.getModuleName(), "m");
+  EXPECT_EQ(Sec2.getFunctionName(0), "a");
+  EXPECT_EQ(Sec2.getFunctionName(3), "bc");
+  EXPECT_TRUE(Sec2.getFunctionName(1).empty());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec3 = {
+      0x02U, 0x03U, 0x00U, 0x00U, 0x00U, /// Local names, skipped
+      0x01U, 0x04U, 0x01U,               /// Function names, vec(1)
+      0x05U, 0x01U, 0x66U                /// 5: "f"
+  };
+  Mgr.setCode(Vec3);
+  SSVM::AST::NameSection Sec3;
+  EXPECT_TRUE(Sec3.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(Sec3.getFunctionName(5), "f");
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec4 = {
+      0x00U, 0x03U, 0x01U, 0x6DU /// Module name with wrong size
+  };
+  Mgr.setCode(Vec4);
+  SSVM::AST::NameSection Sec4;
+  EXPECT_FALSE(Sec4.loadBinary(Mgr));
+}
+
 } // namespace
@@ -135,12 +135,15 @@ TEST(SegmentTest, LoadDataSegment) {
   ///   2.  Load data segment of expression with only End operation and empty
   ///       initialization data.
   ///   3.  Load data segment with expression and initialization data.
+  ///   4.  Load passive data segment with initialization data.
+  ///   5.  Load data segment with invalid flags.
   Mgr.clearBuffer();
   SSVM::AST::DataSegment Seg1;
   EXPECT_FALSE(Seg1.loadBinary(Mgr));
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec2 = {
+      0x02U,                             /// Active segment with memory index
       0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Memory index
       0x0BU,                             /// Expression
       0x00U                              /// Vector length = 0
@@ -151,6 +154,7 @@ TEST(SegmentTest, LoadDataSegment) {
 
   Mgr.clearBuffer();
   std::vector<unsigned char> Vec3 = {
+      0x02U,                             /// Active segment with memory index
       0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x0FU, /// Memory index
       0x45U, 0x46U, 0x47U, 0x0BU,        /// Expression
       0x04U, 0x74U, 0x65U, 0x73U, 0x74U  /// Vector length = 4, "test"
@@ -158,6 +162,26 @@ TEST(SegmentTest, LoadDataSegment) {
   Mgr.setCode(Vec3);
   SSVM::AST::DataSegment Seg3;
   EXPECT_TRUE(Seg3.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec4 = {
+      0x01U,                             /// Passive segment
+      0x04U, 0x74U, 0x65U, 0x73U, 0x74U  /// Vector length = 4, "test"
+  };
+  Mgr.setCode(Vec4);
+  SSVM::AST::DataSegment Seg4;
+  EXPECT_TRUE(Seg4.loadBinary(Mgr) && Mgr.getRemainSize() == 0);
+  EXPECT_TRUE(Seg4.isPassive());
+
+  Mgr.clearBuffer();
+  std::vector<unsigned char> Vec5 = {
+      0x03U,                            /// Invalid flags
+      0x0BU,                            /// Expression
+      0x00U                             /// Vector length = 0
+  };
+  Mgr.setCode(Vec5);
+  SSVM::AST::DataSegment Seg5;
+  EXPECT_FALSE(Seg5.loadBinary(Mgr));
 }
 
 } // namespace
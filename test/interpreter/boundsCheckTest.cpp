@@ -0,0 +1,166 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/boundsCheckTest.cpp - Bounds check tests ----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the address space reservation of memory
+/// instances for the bounds check strategies.
+///
+//===----------------------------------------------------------------------===//
+
+#include "runtime/instance/memory.h"
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace {
+
+using SSVM::Runtime::Instance::MemoryInstance;
+
+/// (module
+///   (memory 1 4)
+///   (func (export "grow") (param i32) (result i32)
+///     (memory.grow (local.get 0)))
+///   (func (export "store") (param i32 i32)
+///     (i32.store8 (local.get 0) (local.get 1)))
+///   (func (export "load") (param i32) (result i32)
+///     (i32.load8_u (local.get 0))))
+std::vector<SSVM::Byte> MemoryWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic, version.
+    0x01U, 0x0BU, 0x02U, 0x60U, 0x01U, 0x7FU, 0x01U, 0x7FU, 0x60U, 0x02U,
+    0x7FU, 0x7FU, 0x00U, /// Type section: [i32] -> [i32], [i32 i32] -> [].
+    0x03U, 0x04U, 0x03U, 0x00U, 0x01U, 0x00U, /// Function section.
+    0x05U, 0x04U, 0x01U, 0x01U, 0x01U, 0x04U, /// Memory section: 1 to 4.
+    0x07U, 0x17U, 0x03U, 0x04U, 0x67U, 0x72U, 0x6FU, 0x77U, 0x00U, 0x00U,
+    0x05U, 0x73U, 0x74U, 0x6FU, 0x72U, 0x65U, 0x00U, 0x01U, 0x04U, 0x6CU,
+    0x6FU, 0x61U, 0x64U, 0x00U, 0x02U, /// Export section.
+    0x0AU, 0x1AU, 0x03U,               /// Code section.
+    0x06U, 0x00U, 0x20U, 0x00U, 0x40U, 0x00U, 0x0BU, /// memory.grow
+    0x09U, 0x00U, 0x20U, 0x00U, 0x20U, 0x01U, 0x3AU, 0x00U, 0x00U,
+    0x0BU,                                                  /// i32.store8
+    0x07U, 0x00U, 0x20U, 0x00U, 0x2DU, 0x00U, 0x00U, 0x0BU /// i32.load8_u
+};
+
+/// Limit the address space of the process to the current size plus Extra
+/// bytes, and restore the limit when leaving the scope.
+class AddressSpaceLimit {
+public:
+  AddressSpaceLimit(uint64_t Extra) {
+    getrlimit(RLIMIT_AS, &Saved);
+    uint64_t Pages = 0;
+    std::ifstream("/proc/self/statm") >> Pages;
+    struct rlimit Limit = Saved;
+    Limit.rlim_cur = Pages * static_cast<uint64_t>(getpagesize()) + Extra;
+    setrlimit(RLIMIT_AS, &Limit);
+  }
+  ~AddressSpaceLimit() { setrlimit(RLIMIT_AS, &Saved); }
+
+private:
+  struct rlimit Saved;
+};
+
+/// One GiB, less than the reservation with guard pages.
+static inline constexpr uint64_t k1G = UINT64_C(0x40000000);
+
+TEST(BoundsCheckTest, ReserveFailure) {
+  AddressSpaceLimit Limit(k1G);
+  MemoryInstance GuardMem(SSVM::AST::Limit(1, 4), true);
+  EXPECT_EQ(GuardMem.getDataPtr(), nullptr);
+  MemoryInstance NoGuardMem(SSVM::AST::Limit(1, 4), false);
+  EXPECT_NE(NoGuardMem.getDataPtr(), nullptr);
+}
+
+TEST(BoundsCheckTest, GrowWithoutMaxWithoutGuardPages) {
+  /// Memories without maximum only reserve the minimum size.
+  AddressSpaceLimit Limit(k1G);
+  MemoryInstance Mem(SSVM::AST::Limit(1), false);
+  ASSERT_NE(Mem.getDataPtr(), nullptr);
+  EXPECT_FALSE(Mem.hasGuardPages());
+  ASSERT_TRUE(Mem.fillBytes(0, 0xAAU, MemoryInstance::kPageSize));
+  /// Growing beyond the reservation moves the memory with its data.
+  ASSERT_TRUE(Mem.growPage(15));
+  EXPECT_EQ(Mem.getDataPageSize(), 16U);
+  auto Bytes = Mem.getBytes(0, MemoryInstance::kPageSize);
+  ASSERT_TRUE(Bytes);
+  EXPECT_TRUE(std::all_of(Bytes->begin(), Bytes->end(),
+                          [](SSVM::Byte B) { return B == 0xAAU; }));
+  EXPECT_TRUE(Mem.fillBytes(MemoryInstance::kPageSize, 0x55U,
+                            15 * MemoryInstance::kPageSize));
+  ASSERT_TRUE(Mem.growPage(0));
+  EXPECT_EQ(Mem.getDataPageSize(), 16U);
+}
+
+TEST(BoundsCheckTest, InstantiateReserveFailure) {
+  SSVM::VM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(MemoryWasm));
+  ASSERT_TRUE(VM.validate());
+  AddressSpaceLimit Limit(k1G);
+  auto Res = VM.instantiate();
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::MemoryReserveFailed);
+}
+
+TEST(BoundsCheckTest, InstantiateWithoutGuardPages) {
+  SSVM::VM::Configure Conf;
+  Conf.setBoundsCheck(SSVM::BoundsCheck::Explicit);
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(MemoryWasm));
+  ASSERT_TRUE(VM.validate());
+  AddressSpaceLimit Limit(k1G);
+  ASSERT_TRUE(VM.instantiate());
+}
+
+TEST(BoundsCheckTest, GrowToCapedMaxWithoutGuardPages) {
+  MemoryInstance Mem(SSVM::AST::Limit(1, 4), false);
+  ASSERT_NE(Mem.getDataPtr(), nullptr);
+  EXPECT_FALSE(Mem.hasGuardPages());
+  EXPECT_TRUE(Mem.growPage(3));
+  EXPECT_EQ(Mem.getDataPageSize(), 4U);
+  EXPECT_FALSE(Mem.growPage(1));
+  EXPECT_EQ(Mem.getDataPageSize(), 4U);
+  /// The whole grown memory is accessible.
+  EXPECT_TRUE(Mem.fillBytes(0, 0xAAU, 4 * MemoryInstance::kPageSize));
+  /// Memories without maximum are caped at 4 GiB.
+  MemoryInstance NoMaxMem(SSVM::AST::Limit(0), false);
+  ASSERT_NE(NoMaxMem.getDataPtr(), nullptr);
+  EXPECT_FALSE(NoMaxMem.growPage(65537));
+  EXPECT_EQ(NoMaxMem.getDataPageSize(), 0U);
+
+  SSVM::VM::Configure Conf;
+  Conf.setBoundsCheck(SSVM::BoundsCheck::Explicit);
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(MemoryWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  auto execute = [&VM](std::string_view Func,
+                       std::vector<SSVM::ValVariant> Params) {
+    return VM.execute(Func, Params);
+  };
+  auto Res = execute("grow", {UINT32_C(3)});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(std::get<uint32_t>(Res->front()), 1U);
+  Res = execute("grow", {UINT32_C(1)});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(std::get<uint32_t>(Res->front()), UINT32_MAX);
+  const uint32_t Last = 4 * MemoryInstance::kPageSize - 1;
+  ASSERT_TRUE(execute("store", {Last, UINT32_C(7)}));
+  Res = execute("load", {Last});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(std::get<uint32_t>(Res->front()), 7U);
+  Res = execute("load", {Last + 1});
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::MemoryOutOfBounds);
+}
+
+} // namespace
@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/bulkMemoryTest.cpp - Bulk memory tests ------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of executing the bulk memory instructions.
+///
+//===----------------------------------------------------------------------===//
+
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+/// (module
+///   (memory 1)
+///   (func (export "copy") (param i32 i32 i32)
+///     (memory.copy (local.get 0) (local.get 1) (local.get 2)))
+///   (func (export "fill") (param i32 i32 i32)
+///     (memory.fill (local.get 0) (local.get 1) (local.get 2)))
+///   (func (export "init") (param i32 i32 i32)
+///     (memory.init 0 (local.get 0) (local.get 1) (local.get 2)))
+///   (func (export "drop") (data.drop 0))
+///   (func (export "load") (param i32) (result i32)
+///     (i32.load8_u (local.get 0)))
+///   (data "\01\02\03\04\05\06\07\08"))
+std::vector<SSVM::Byte> BulkWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic, version.
+    0x01U, 0x0FU, 0x03U, 0x60U, 0x03U, 0x7FU, 0x7FU, 0x7FU, 0x00U, 0x60U,
+    0x00U, 0x00U, 0x60U, 0x01U, 0x7FU, 0x01U, 0x7FU, /// Type section.
+    0x03U, 0x06U, 0x05U, 0x00U, 0x00U, 0x00U, 0x01U, 0x02U, /// Function section.
+    0x05U, 0x03U, 0x01U, 0x00U, 0x01U, /// Memory section: 1 page.
+    0x07U, 0x24U, 0x05U, 0x04U, 0x63U, 0x6FU, 0x70U, 0x79U, 0x00U, 0x00U,
+    0x04U, 0x66U, 0x69U, 0x6CU, 0x6CU, 0x00U, 0x01U, 0x04U, 0x69U, 0x6EU,
+    0x69U, 0x74U, 0x00U, 0x02U, 0x04U, 0x64U, 0x72U, 0x6FU, 0x70U, 0x00U,
+    0x03U, 0x04U, 0x6CU, 0x6FU, 0x61U, 0x64U, 0x00U, 0x04U, /// Export section.
+    0x0CU, 0x01U, 0x01U,                                     /// Data count.
+    0x0AU, 0x35U, 0x05U,                                     /// Code section.
+    0x0CU, 0x00U, 0x20U, 0x00U, 0x20U, 0x01U, 0x20U, 0x02U, 0xFCU, 0x0AU,
+    0x00U, 0x00U, 0x0BU, /// memory.copy
+    0x0AU, 0x00U, 0x20U, 0x00U, 0x20U, 0x01U, 0x20U, 0x02U, 0xFCU, 0x0BU,
+    0x00U, 0x0BU, /// memory.fill
+    0x0CU, 0x00U, 0x20U, 0x00U, 0x20U, 0x01U, 0x20U, 0x02U, 0xFCU, 0x08U,
+    0x00U, 0x00U, 0x0BU,                      /// memory.init
+    0x05U, 0x00U, 0xFCU, 0x09U, 0x00U, 0x0BU, /// data.drop
+    0x07U, 0x00U, 0x20U, 0x00U, 0x2DU, 0x00U, 0x00U, 0x0BU, /// i32.load8_u
+    0x0BU, 0x0BU, 0x01U, 0x01U, 0x08U, 0x01U, 0x02U, 0x03U, 0x04U, 0x05U,
+    0x06U, 0x07U, 0x08U /// Data section: passive.
+};
+
+/// Size of the memory in bytes.
+static inline constexpr uint32_t kMemSize = 65536;
+
+class BulkMemoryTest : public testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_TRUE(VM.loadWasm(BulkWasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+  }
+
+  SSVM::Expect<std::vector<SSVM::ValVariant>>
+  execute(std::string_view Func, std::vector<SSVM::ValVariant> Params = {}) {
+    return VM.execute(Func, Params);
+  }
+
+  /// Get the bytes of memory from Offset.
+  std::vector<uint32_t> load(uint32_t Offset, uint32_t Length) {
+    std::vector<uint32_t> Bytes;
+    for (uint32_t I = 0; I < Length; ++I) {
+      auto Res = execute("load", {Offset + I});
+      Bytes.push_back(Res ? std::get<uint32_t>(Res->front()) : UINT32_MAX);
+    }
+    return Bytes;
+  }
+
+  /// Expect the instruction traps with MemoryOutOfBounds.
+  void expectOutOfBounds(std::string_view Func,
+                         std::vector<SSVM::ValVariant> Params) {
+    auto Res = execute(Func, std::move(Params));
+    ASSERT_FALSE(Res) << Func;
+    EXPECT_EQ(Res.error(), SSVM::ErrCode::MemoryOutOfBounds) << Func;
+  }
+
+  SSVM::VM::Configure Conf;
+  SSVM::VM::VM VM{Conf};
+};
+
+TEST_F(BulkMemoryTest, CopyOverlap) {
+  /// Copy to higher addresses.
+  ASSERT_TRUE(execute("init", {UINT32_C(0), UINT32_C(0), UINT32_C(8)}));
+  ASSERT_TRUE(execute("copy", {UINT32_C(2), UINT32_C(0), UINT32_C(6)}));
+  EXPECT_EQ(load(0, 8), (std::vector<uint32_t>{1, 2, 1, 2, 3, 4, 5, 6}));
+
+  /// Copy to lower addresses.
+  ASSERT_TRUE(execute("init", {UINT32_C(0), UINT32_C(0), UINT32_C(8)}));
+  ASSERT_TRUE(execute("copy", {UINT32_C(0), UINT32_C(2), UINT32_C(6)}));
+  EXPECT_EQ(load(0, 8), (std::vector<uint32_t>{3, 4, 5, 6, 7, 8, 7, 8}));
+}
+
+TEST_F(BulkMemoryTest, OutOfBoundsBeforeWrite) {
+  const std::vector<uint32_t> Zeros(6, 0);
+  ASSERT_TRUE(execute("init", {UINT32_C(0), UINT32_C(0), UINT32_C(8)}));
+  const auto Data = load(0, 8);
+
+  expectOutOfBounds("fill", {kMemSize - 6, UINT32_C(0xFF), UINT32_C(7)});
+  EXPECT_EQ(load(kMemSize - 6, 6), Zeros);
+  expectOutOfBounds("copy", {kMemSize - 6, UINT32_C(0), UINT32_C(7)});
+  EXPECT_EQ(load(kMemSize - 6, 6), Zeros);
+  expectOutOfBounds("copy", {UINT32_C(0), kMemSize - 6, UINT32_C(7)});
+  EXPECT_EQ(load(0, 8), Data);
+  expectOutOfBounds("init", {kMemSize - 6, UINT32_C(0), UINT32_C(7)});
+  EXPECT_EQ(load(kMemSize - 6, 6), Zeros);
+  /// Source out of the data segment.
+  expectOutOfBounds("init", {kMemSize - 6, UINT32_C(4), UINT32_C(5)});
+  EXPECT_EQ(load(kMemSize - 6, 6), Zeros);
+}
+
+TEST_F(BulkMemoryTest, InitAfterDrop) {
+  ASSERT_TRUE(execute("drop"));
+  expectOutOfBounds("init", {UINT32_C(0), UINT32_C(0), UINT32_C(1)});
+  EXPECT_EQ(load(0, 1), std::vector<uint32_t>{0});
+  /// Zero-length initialization and dropping again are allowed.
+  EXPECT_TRUE(execute("init", {UINT32_C(0), UINT32_C(0), UINT32_C(0)}));
+  EXPECT_TRUE(execute("drop"));
+}
+
+TEST_F(BulkMemoryTest, ZeroLengthAtEnd) {
+  EXPECT_TRUE(execute("fill", {kMemSize, UINT32_C(1), UINT32_C(0)}));
+  EXPECT_TRUE(execute("copy", {kMemSize, kMemSize, UINT32_C(0)}));
+  EXPECT_TRUE(execute("init", {kMemSize, UINT32_C(8), UINT32_C(0)}));
+
+  /// Zero-length accesses beyond the end are still out of bounds.
+  expectOutOfBounds("fill", {kMemSize + 1, UINT32_C(1), UINT32_C(0)});
+  expectOutOfBounds("copy", {kMemSize + 1, UINT32_C(0), UINT32_C(0)});
+  expectOutOfBounds("copy", {UINT32_C(0), kMemSize + 1, UINT32_C(0)});
+  expectOutOfBounds("init", {kMemSize + 1, UINT32_C(0), UINT32_C(0)});
+  expectOutOfBounds("init", {UINT32_C(0), UINT32_C(9), UINT32_C(0)});
+}
+
+} // namespace
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/interruptTest.cpp - Interruption tests ------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of interrupting the interpreter by the epoch
+/// deadline.
+///
+//===----------------------------------------------------------------------===//
+
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// (module (func (export "loop") (loop (br 0))))
+std::vector<SSVM::Byte> LoopWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic, version.
+    0x01U, 0x04U, 0x01U, 0x60U, 0x00U, 0x00U, /// Type section: [] -> [].
+    0x03U, 0x02U, 0x01U, 0x00U,               /// Function section.
+    0x07U, 0x08U, 0x01U, 0x04U, 0x6CU, 0x6FU, 0x6FU, 0x70U,
+    0x00U, 0x00U,                      /// Export section: "loop".
+    0x0AU, 0x09U, 0x01U, 0x07U, 0x00U, /// Code section, no locals.
+    0x03U, 0x40U,                      /// loop
+    0x0CU, 0x00U,                      /// br 0
+    0x0BU,                             /// end
+    0x0BU                              /// end
+};
+
+/// (module (func $f (export "recurse") (call $f)))
+std::vector<SSVM::Byte> RecurseWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic, version.
+    0x01U, 0x04U, 0x01U, 0x60U, 0x00U, 0x00U, /// Type section: [] -> [].
+    0x03U, 0x02U, 0x01U, 0x00U,               /// Function section.
+    0x07U, 0x0BU, 0x01U, 0x07U, 0x72U, 0x65U, 0x63U, 0x75U,
+    0x72U, 0x73U, 0x65U, 0x00U, 0x00U, /// Export section: "recurse".
+    0x0AU, 0x06U, 0x01U, 0x04U, 0x00U, /// Code section, no locals.
+    0x10U, 0x00U,                      /// call 0
+    0x0BU                              /// end
+};
+
+TEST(InterruptTest, LoopInterruptedByEpoch) {
+  SSVM::VM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(LoopWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  VM.setEpochDeadline(1);
+  std::thread Ticker([&VM]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    VM.incrementEpoch();
+  });
+  auto Res = VM.execute("loop");
+  Ticker.join();
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::Interrupted);
+}
+
+TEST(InterruptTest, RecursionInterruptedOnEntry) {
+  SSVM::VM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(RecurseWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  VM.setEpochDeadline(0);
+  auto Res = VM.execute("recurse");
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::Interrupted);
+}
+
+} // namespace
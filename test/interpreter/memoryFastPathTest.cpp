@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/memoryFastPathTest.cpp - Fast path tests ----===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the memory accesses without bounds checks
+/// in the interpreter, which rely on the guard pages.
+///
+//===----------------------------------------------------------------------===//
+
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+/// (module
+///   (memory 1)
+///   (func (export "store") (param i32 i32)
+///     (i32.store (local.get 0) (local.get 1)))
+///   (func (export "load") (param i32) (result i32)
+///     (i32.load (local.get 0))))
+std::vector<SSVM::Byte> MemoryWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic, version.
+    0x01U, 0x0BU, 0x02U, 0x60U, 0x01U, 0x7FU, 0x01U, 0x7FU, 0x60U, 0x02U,
+    0x7FU, 0x7FU, 0x00U, /// Type section: [i32] -> [i32], [i32 i32] -> [].
+    0x03U, 0x03U, 0x02U, 0x01U, 0x00U, /// Function section.
+    0x05U, 0x03U, 0x01U, 0x00U, 0x01U, /// Memory section: 1 page.
+    0x07U, 0x10U, 0x02U, 0x05U, 0x73U, 0x74U, 0x6FU, 0x72U, 0x65U, 0x00U,
+    0x00U, 0x04U, 0x6CU, 0x6FU, 0x61U, 0x64U, 0x00U, 0x01U, /// Export section.
+    0x0AU, 0x13U, 0x02U,                                     /// Code section.
+    0x09U, 0x00U, 0x20U, 0x00U, 0x20U, 0x01U, 0x36U, 0x02U, 0x00U,
+    0x0BU,                                                  /// i32.store
+    0x07U, 0x00U, 0x20U, 0x00U, 0x28U, 0x02U, 0x00U, 0x0BU /// i32.load
+};
+
+class MemoryFastPathTest : public testing::Test {
+protected:
+  static SSVM::VM::Configure makeConfigure() {
+    SSVM::VM::Configure Conf;
+    Conf.setMemoryFastPath(true);
+    return Conf;
+  }
+
+  void SetUp() override {
+    ASSERT_TRUE(VM.loadWasm(MemoryWasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+  }
+
+  SSVM::Expect<std::vector<SSVM::ValVariant>>
+  execute(std::string_view Func, std::vector<SSVM::ValVariant> Params) {
+    return VM.execute(Func, Params);
+  }
+
+  SSVM::VM::Configure Conf = makeConfigure();
+  SSVM::VM::VM VM{Conf};
+};
+
+TEST_F(MemoryFastPathTest, OutOfBoundsTraps) {
+  for (const uint32_t Addr :
+       {UINT32_C(65536), UINT32_C(65533), UINT32_C(0xFFFFFFFF)}) {
+    auto Res = execute("load", {Addr});
+    ASSERT_FALSE(Res) << Addr;
+    EXPECT_EQ(Res.error(), SSVM::ErrCode::MemoryOutOfBounds) << Addr;
+    auto StoreRes = execute("store", {Addr, UINT32_C(1)});
+    ASSERT_FALSE(StoreRes) << Addr;
+    EXPECT_EQ(StoreRes.error(), SSVM::ErrCode::MemoryOutOfBounds) << Addr;
+  }
+}
+
+TEST_F(MemoryFastPathTest, UsableAfterTrap) {
+  ASSERT_FALSE(execute("store", {UINT32_C(65536), UINT32_C(1)}));
+  ASSERT_TRUE(execute("store", {UINT32_C(65532), UINT32_C(0x12345678)}));
+  auto Res = execute("load", {UINT32_C(65532)});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(std::get<uint32_t>(Res->front()), UINT32_C(0x12345678));
+
+  /// The failed store did not write the accessible part.
+  ASSERT_FALSE(execute("store", {UINT32_C(65534), UINT32_C(0)}));
+  Res = execute("load", {UINT32_C(65532)});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(std::get<uint32_t>(Res->front()), UINT32_C(0x12345678));
+
+  /// Trap again after recovering.
+  Res = execute("load", {UINT32_C(65536)});
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::MemoryOutOfBounds);
+}
+
+} // namespace
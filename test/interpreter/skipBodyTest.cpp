@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/skipBodyTest.cpp - Skipped body tests -------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of instantiating the functions whose bodies
+/// are skipped in loading.
+///
+//===----------------------------------------------------------------------===//
+
+#include "common/ast/module.h"
+#include "interpreter/interpreter.h"
+#include "loader/filemgr.h"
+#include "runtime/storemgr.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace {
+
+/// (module (func (export "nop")))
+std::vector<SSVM::Byte> NopWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic, version.
+    0x01U, 0x04U, 0x01U, 0x60U, 0x00U, 0x00U, /// Type section: [] -> [].
+    0x03U, 0x02U, 0x01U, 0x00U,               /// Function section.
+    0x07U, 0x07U, 0x01U, 0x03U, 0x6EU, 0x6FU, 0x70U, 0x00U,
+    0x00U,                                   /// Export section: "nop".
+    0x0AU, 0x04U, 0x01U, 0x02U, 0x00U, 0x0BU /// Code section.
+};
+
+SSVM::Expect<void> instantiate(bool SkipBody) {
+  SSVM::FileMgrVector Mgr;
+  Mgr.setCode(NopWasm);
+  SSVM::AST::Module Mod;
+  Mod.setSkipFunctionBody(SkipBody);
+  if (auto Res = Mod.loadBinary(Mgr); !Res) {
+    return SSVM::Unexpect(Res);
+  }
+  SSVM::Runtime::StoreManager StoreMgr;
+  SSVM::Interpreter::Interpreter Interp;
+  return Interp.instantiateModule(StoreMgr, Mod);
+}
+
+TEST(SkipBodyTest, DecodedBody) { EXPECT_TRUE(instantiate(false)); }
+
+TEST(SkipBodyTest, SkippedBodyWithoutWrapper) {
+  /// Without the compiled wrapper, the function has nothing to run.
+  auto Res = instantiate(true);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::MissingCompiledFunc);
+}
+
+} // namespace
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/interpreter/stackLimitTest.cpp - Stack limit tests ------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the call depth and value stack limits of
+/// the interpreter.
+///
+//===----------------------------------------------------------------------===//
+
+#include "vm/configure.h"
+#include "vm/vm.h"
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace {
+
+/// (module (func $f (export "recurse") (call $f)))
+std::vector<SSVM::Byte> RecurseWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic, version.
+    0x01U, 0x04U, 0x01U, 0x60U, 0x00U, 0x00U, /// Type section: [] -> [].
+    0x03U, 0x02U, 0x01U, 0x00U,               /// Function section.
+    0x07U, 0x0BU, 0x01U, 0x07U, 0x72U, 0x65U, 0x63U, 0x75U,
+    0x72U, 0x73U, 0x65U, 0x00U, 0x00U, /// Export section: "recurse".
+    0x0AU, 0x06U, 0x01U, 0x04U, 0x00U, /// Code section, no locals.
+    0x10U, 0x00U,                      /// call 0
+    0x0BU                              /// end
+};
+
+/// (module (func (export "locals") (local i64 ... 1000 times)))
+std::vector<SSVM::Byte> LocalsWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic, version.
+    0x01U, 0x04U, 0x01U, 0x60U, 0x00U, 0x00U, /// Type section: [] -> [].
+    0x03U, 0x02U, 0x01U, 0x00U,               /// Function section.
+    0x07U, 0x0AU, 0x01U, 0x06U, 0x6CU, 0x6FU, 0x63U, 0x61U,
+    0x6CU, 0x73U, 0x00U, 0x00U,        /// Export section: "locals".
+    0x0AU, 0x07U, 0x01U, 0x05U,        /// Code section.
+    0x01U, 0xE8U, 0x07U, 0x7EU,        /// 1000 locals of i64.
+    0x0BU                              /// end
+};
+
+TEST(StackLimitTest, RecursionExhaustsCallDepth) {
+  SSVM::VM::Configure Conf;
+  Conf.setMaxCallDepth(64);
+  SSVM::VM::VM VM(Conf);
+  auto Res = VM.runWasmFile(RecurseWasm, "recurse");
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::CallStackExhausted);
+}
+
+TEST(StackLimitTest, LargeFrameExhaustsValueStack) {
+  SSVM::VM::Configure Conf;
+  Conf.setMaxStackValues(512);
+  SSVM::VM::VM VM(Conf);
+  auto Res = VM.runWasmFile(LocalsWasm, "locals");
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::CallStackExhausted);
+}
+
+TEST(StackLimitTest, FrameWithinLimits) {
+  SSVM::VM::Configure Conf;
+  Conf.setMaxStackValues(2048);
+  Conf.setMaxCallDepth(64);
+  SSVM::VM::VM VM(Conf);
+  EXPECT_TRUE(VM.runWasmFile(LocalsWasm, "locals"));
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "loader/filemgr.h"
+#include "loader/ldmgr.h"
 #include "common/errcode.h"
 #include "gtest/gtest.h"
 
@@ -265,6 +266,18 @@ TEST(FileManagerTest, ReadName) {
   EXPECT_EQ("Loader", ReadStr.value());
 }
 
+TEST(LDMgrTest, TargetFeatures) {
+  /// 1. Test the target settings without features.
+  EXPECT_TRUE(SSVM::LDMgr::isTargetSupported("generic;O2;"));
+  EXPECT_FALSE(SSVM::LDMgr::isTargetSupported("generic"));
+#if defined(__x86_64__)
+  /// 2. Test the baseline features of x86-64.
+  EXPECT_TRUE(SSVM::LDMgr::isTargetSupported("x86-64;O2;+sse2,+cmov,-avx"));
+  /// 3. Test refusing the features which cannot be checked.
+  EXPECT_FALSE(SSVM::LDMgr::isTargetSupported("x86-64;O2;+sse2,+unknown"));
+#endif
+}
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/support/profileTest.cpp - Profile unit tests ------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of reading and writing the execution profile
+/// files.
+///
+//===----------------------------------------------------------------------===//
+
+#include "support/profile.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <string_view>
+
+namespace {
+
+using SSVM::Support::Profile;
+
+/// Write the content into the file at path.
+void writeFile(const char *Path, std::string_view Content) {
+  std::ofstream Fout(Path, std::ios::out | std::ios::trunc);
+  Fout << Content;
+}
+
+TEST(ProfileTest, SaveLoadRoundTrip) {
+  const char *Path = "profileTestRoundTrip.profdata";
+  Profile Saved;
+  Saved.addEntry(12);
+  Saved.addEntry(12);
+  Saved.addEntry(40);
+  Saved.addBranch(20, true);
+  Saved.addBranch(20, true);
+  Saved.addBranch(20, false);
+  Saved.addBranch(28, false);
+  Saved.addIndirectCall(32, 12);
+  Saved.addIndirectCall(32, 40);
+  Saved.addIndirectCall(32, 40);
+  ASSERT_TRUE(Saved.save(Path));
+
+  Profile Loaded;
+  ASSERT_TRUE(Loaded.load(Path));
+  EXPECT_EQ(Loaded.getEntryCount(12), 2U);
+  EXPECT_EQ(Loaded.getEntryCount(40), 1U);
+  EXPECT_EQ(Loaded.getEntryCount(44), 0U);
+  const auto *Branch = Loaded.getBranchCount(20);
+  ASSERT_NE(Branch, nullptr);
+  EXPECT_EQ(Branch->Taken, 2U);
+  EXPECT_EQ(Branch->NotTaken, 1U);
+  Branch = Loaded.getBranchCount(28);
+  ASSERT_NE(Branch, nullptr);
+  EXPECT_EQ(Branch->Taken, 0U);
+  EXPECT_EQ(Branch->NotTaken, 1U);
+  EXPECT_EQ(Loaded.getBranchCount(24), nullptr);
+  const auto *Calls = Loaded.getIndirectCalls(32);
+  ASSERT_NE(Calls, nullptr);
+  EXPECT_EQ(Calls->size(), 2U);
+  EXPECT_EQ(Calls->at(12), 1U);
+  EXPECT_EQ(Calls->at(40), 2U);
+
+  /// Loading again adds the counts.
+  ASSERT_TRUE(Loaded.load(Path));
+  EXPECT_EQ(Loaded.getEntryCount(12), 4U);
+  EXPECT_EQ(Loaded.getIndirectCalls(32)->at(40), 4U);
+  std::remove(Path);
+}
+
+TEST(ProfileTest, EmptyRoundTrip) {
+  const char *Path = "profileTestEmpty.profdata";
+  ASSERT_TRUE(Profile().save(Path));
+  Profile Loaded;
+  ASSERT_TRUE(Loaded.load(Path));
+  EXPECT_TRUE(Loaded.empty());
+  std::remove(Path);
+}
+
+TEST(ProfileTest, MissingFile) {
+  Profile Loaded;
+  auto Res = Loaded.load("profileTestMissing.profdata");
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::InvalidPath);
+}
+
+TEST(ProfileTest, MalformedLines) {
+  const char *Path = "profileTestMalformed.profdata";
+  const std::string_view Contents[] = {
+      /// Missing or wrong header.
+      "",
+      "entry 12 1\n",
+      "ssvm-profile 2\nentry 12 1\n",
+      /// Unknown kind.
+      "ssvm-profile 1\ncall 12 1\n",
+      /// Missing counts.
+      "ssvm-profile 1\nentry 12\n",
+      "ssvm-profile 1\nbranch 20 1\n",
+      "ssvm-profile 1\nindirect 32 12\n",
+      /// Not numbers.
+      "ssvm-profile 1\nentry x 1\n",
+      /// Trailing tokens.
+      "ssvm-profile 1\nentry 12 1 1\n",
+      "ssvm-profile 1\nbranch 20 1 1 x\n",
+  };
+  for (const auto Content : Contents) {
+    writeFile(Path, Content);
+    Profile Loaded;
+    auto Res = Loaded.load(Path);
+    ASSERT_FALSE(Res) << Content;
+    EXPECT_EQ(Res.error(), SSVM::ErrCode::InvalidGrammar) << Content;
+  }
+  std::remove(Path);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/support/sha256Test.cpp - SHA-256 unit tests -------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the SHA-256 implementation with the
+/// known answers in FIPS 180-2.
+///
+//===----------------------------------------------------------------------===//
+
+#include "support/sha256.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using SSVM::Support::SHA256;
+
+std::string hashHex(std::string_view Str) {
+  return SHA256::toHexStr(SHA256::hash(
+      {reinterpret_cast<const uint8_t *>(Str.data()), Str.size()}));
+}
+
+/// Hash the message by updating with chunks of the given size.
+std::string hashHexInChunks(std::string_view Str, size_t ChunkSize) {
+  SHA256 Hasher;
+  for (size_t Off = 0; Off < Str.size(); Off += ChunkSize) {
+    const size_t Len = std::min(ChunkSize, Str.size() - Off);
+    Hasher.update({reinterpret_cast<const uint8_t *>(Str.data()) + Off, Len});
+  }
+  return SHA256::toHexStr(Hasher.finalize());
+}
+
+const std::string_view TwoBlockMsg =
+    "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+const std::string_view TwoBlockDigest =
+    "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1";
+const std::string_view MillionADigest =
+    "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0";
+
+TEST(SHA256Test, KnownAnswers) {
+  /// 1. Test the FIPS 180-2 vectors and the empty message.
+  ///
+  ///   1.  Empty message.
+  ///   2.  One-block message "abc".
+  ///   3.  448-bit message, whose padding crosses into the second block.
+  ///   4.  One million of 'a'.
+  EXPECT_EQ(hashHex(""),
+            "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  EXPECT_EQ(hashHex("abc"),
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  EXPECT_EQ(hashHex(TwoBlockMsg), TwoBlockDigest);
+  EXPECT_EQ(hashHex(std::string(1000000, 'a')), MillionADigest);
+}
+
+TEST(SHA256Test, BlockBoundaries) {
+  /// 2. Test messages around the 64-byte block boundary.
+  ///
+  ///   1.  55, 56, 63, 64, and 65 bytes, which need one or two padding blocks.
+  ///   2.  Updating in chunks gives the same digests as the whole message.
+  EXPECT_EQ(
+      hashHex(std::string(55, 'a')),
+      "9f4390f8d30c2dd92ec9f095b65e2b9ae9b0a925a5258e241c9f1e910f734318");
+  EXPECT_EQ(
+      hashHex(std::string(56, 'a')),
+      "b35439a4ac6f0948b6d6f9e3c6af0f5f590ce20f1bde7090ef7970686ec6738a");
+  EXPECT_EQ(
+      hashHex(std::string(63, 'a')),
+      "7d3e74a05d7db15bce4ad9ec0658ea98e3f06eeecf16b4c6fff2da457ddc2f34");
+  EXPECT_EQ(
+      hashHex(std::string(64, 'a')),
+      "ffe054fe7ae0cb6dc65c3af9b61d5209f439851db43d0ba5997337df154668eb");
+  EXPECT_EQ(
+      hashHex(std::string(65, 'a')),
+      "635361c48bb9eab14198e76ea8ab7f1a41685d6ad62aa9146d301d4f17eb0ae0");
+
+  const std::string MillionA(1000000, 'a');
+  for (size_t ChunkSize : {1, 3, 63, 64, 65, 1000}) {
+    EXPECT_EQ(hashHexInChunks(TwoBlockMsg, ChunkSize), TwoBlockDigest);
+    EXPECT_EQ(hashHexInChunks(MillionA, ChunkSize), MillionADigest);
+  }
+}
+
+TEST(SHA256Test, ResetAfterFinalize) {
+  /// 3. Test the state is reset after finalizing.
+  SHA256 Hasher;
+  Hasher.update({reinterpret_cast<const uint8_t *>("abc"), 3});
+  Hasher.finalize();
+  Hasher.update({reinterpret_cast<const uint8_t *>("abc"), 3});
+  EXPECT_EQ(SHA256::toHexStr(Hasher.finalize()),
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+} // namespace
@@ -0,0 +1,122 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/validator/bulkMemoryTest.cpp - Bulk memory unit tests ---===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of validating the data segment indices of
+/// the bulk memory instructions.
+///
+//===----------------------------------------------------------------------===//
+
+#include "loader/loader.h"
+#include "validator/validator.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace {
+
+/// Append the unsigned LEB128 encoding of the value.
+void appendU32(std::vector<SSVM::Byte> &Out, uint32_t Value) {
+  do {
+    SSVM::Byte Byte = Value & 0x7FU;
+    Value >>= 7;
+    if (Value != 0) {
+      Byte |= 0x80U;
+    }
+    Out.push_back(Byte);
+  } while (Value != 0);
+}
+
+/// Append the section with the size of the content.
+void appendSection(std::vector<SSVM::Byte> &Out, SSVM::Byte Id,
+                   const std::vector<SSVM::Byte> &Content) {
+  Out.push_back(Id);
+  appendU32(Out, Content.size());
+  Out.insert(Out.end(), Content.begin(), Content.end());
+}
+
+/// (module
+///   (memory 1)
+///   (func <Instrs>)
+///   (data "ab"))
+///
+/// with the data count section if DataCount has value.
+std::vector<SSVM::Byte> makeWasm(std::optional<uint32_t> DataCount,
+                                 const std::vector<SSVM::Byte> &Instrs) {
+  std::vector<SSVM::Byte> Wasm = {0x00U, 0x61U, 0x73U, 0x6DU,
+                                  0x01U, 0x00U, 0x00U, 0x00U};
+  /// Type section: [] -> [].
+  appendSection(Wasm, 0x01U, {0x01U, 0x60U, 0x00U, 0x00U});
+  /// Function section.
+  appendSection(Wasm, 0x03U, {0x01U, 0x00U});
+  /// Memory section: 1 page.
+  appendSection(Wasm, 0x05U, {0x01U, 0x00U, 0x01U});
+  if (DataCount) {
+    /// Data count section.
+    std::vector<SSVM::Byte> Count;
+    appendU32(Count, *DataCount);
+    appendSection(Wasm, 0x0CU, Count);
+  }
+  /// Code section, no locals.
+  std::vector<SSVM::Byte> Body = {0x00U};
+  Body.insert(Body.end(), Instrs.begin(), Instrs.end());
+  Body.push_back(0x0BU);
+  std::vector<SSVM::Byte> Code = {0x01U};
+  appendU32(Code, Body.size());
+  Code.insert(Code.end(), Body.begin(), Body.end());
+  appendSection(Wasm, 0x0AU, Code);
+  /// Data section: passive "ab".
+  appendSection(Wasm, 0x0BU, {0x01U, 0x01U, 0x02U, 0x61U, 0x62U});
+  return Wasm;
+}
+
+/// (memory.init Idx (i32.const 0) (i32.const 0) (i32.const 0))
+std::vector<SSVM::Byte> memoryInit(SSVM::Byte Idx) {
+  return {0x41U, 0x00U, 0x41U, 0x00U, 0x41U, 0x00U, 0xFCU, 0x08U, Idx, 0x00U};
+}
+
+/// (data.drop Idx)
+std::vector<SSVM::Byte> dataDrop(SSVM::Byte Idx) {
+  return {0xFCU, 0x09U, Idx};
+}
+
+SSVM::Expect<void> validate(const std::vector<SSVM::Byte> &Wasm) {
+  SSVM::Loader::Loader Loader;
+  auto Module = Loader.parseModule(Wasm);
+  if (!Module) {
+    return SSVM::Unexpect(Module);
+  }
+  SSVM::Validator::Validator Validator;
+  return Validator.validate(**Module);
+}
+
+TEST(BulkMemoryTest, DataIndexWithDataCount) {
+  EXPECT_TRUE(validate(makeWasm(1, memoryInit(0))));
+  EXPECT_TRUE(validate(makeWasm(1, dataDrop(0))));
+}
+
+TEST(BulkMemoryTest, MissingDataCount) {
+  auto Res = validate(makeWasm(std::nullopt, memoryInit(0)));
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::InvalidDataIdx);
+  Res = validate(makeWasm(std::nullopt, dataDrop(0)));
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::InvalidDataIdx);
+}
+
+TEST(BulkMemoryTest, DataIndexOutOfRange) {
+  auto Res = validate(makeWasm(1, memoryInit(1)));
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::InvalidDataIdx);
+  Res = validate(makeWasm(1, dataDrop(1)));
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::InvalidDataIdx);
+}
+
+} // namespace
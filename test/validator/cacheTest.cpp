@@ -0,0 +1,149 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/test/validator/cacheTest.cpp - Validation cache unit tests ---===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contents unit tests of the process-wide validation cache.
+///
+//===----------------------------------------------------------------------===//
+
+#include "validator/cache.h"
+#include "loader/loader.h"
+#include "validator/validator.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using SSVM::Validator::ValidationCache;
+
+/// (module (func (result i32) (block (result i32) (i32.const 1))))
+std::vector<SSVM::Byte> BlockWasm = {
+    0x00U, 0x61U, 0x73U, 0x6DU, 0x01U, 0x00U, 0x00U, 0x00U, /// Magic, version.
+    0x01U, 0x05U, 0x01U, 0x60U, 0x00U, 0x01U, 0x7FU, /// Type: [] -> [i32].
+    0x03U, 0x02U, 0x01U, 0x00U,                      /// Function section.
+    0x0AU, 0x09U, 0x01U, 0x07U, 0x00U,               /// Code section.
+    0x02U, 0x7FU,                                    /// block (result i32)
+    0x41U, 0x01U,                                    /// i32.const 1
+    0x0BU,                                           /// end
+    0x0BU                                            /// end
+};
+
+ValidationCache::Digest makeDigest(uint8_t Id) {
+  ValidationCache::Digest D{};
+  D[0] = Id;
+  return D;
+}
+
+TEST(ValidationCacheTest, HitMissEvict) {
+  /// 1. Test the cache entries.
+  ///
+  ///   1.  Find the inserted digests.
+  ///   2.  Miss the unknown digest.
+  ///   3.  Evict the oldest entry when the cache is full.
+  auto &Cache = ValidationCache::getInstance();
+  Cache.clear();
+  Cache.setCapacity(2);
+
+  ValidationCache::Entry E1;
+  E1.MaxStackHeights = {1, 2};
+  E1.BlockArities = {{0, 1}};
+  Cache.insert(makeDigest(1), E1);
+  Cache.insert(makeDigest(2), ValidationCache::Entry{});
+
+  auto Found = Cache.find(makeDigest(1));
+  ASSERT_TRUE(Found);
+  EXPECT_EQ(Found->MaxStackHeights, E1.MaxStackHeights);
+  EXPECT_EQ(Found->BlockArities, E1.BlockArities);
+  EXPECT_FALSE(Cache.find(makeDigest(3)));
+
+  Cache.insert(makeDigest(3), ValidationCache::Entry{});
+  EXPECT_FALSE(Cache.find(makeDigest(1)));
+  EXPECT_TRUE(Cache.find(makeDigest(2)));
+  EXPECT_TRUE(Cache.find(makeDigest(3)));
+
+  Cache.clear();
+  EXPECT_FALSE(Cache.find(makeDigest(2)));
+  Cache.setCapacity(ValidationCache::kDefaultCapacity);
+}
+
+TEST(ValidationCacheTest, RestoreBlockArity) {
+  /// 2. Test the validation results restored on cache hit.
+  auto &Cache = ValidationCache::getInstance();
+  Cache.clear();
+  SSVM::Loader::Loader Loader;
+  Loader.setModuleHashing(true);
+  SSVM::Validator::Validator Validator;
+  Validator.setCaching(true);
+
+  auto Mod1 = Loader.parseModule(BlockWasm);
+  ASSERT_TRUE(Mod1);
+  ASSERT_TRUE((*Mod1)->getContentHash());
+  EXPECT_FALSE(Cache.find(*(*Mod1)->getContentHash()));
+  ASSERT_TRUE(Validator.validate(**Mod1));
+  EXPECT_TRUE(Cache.find(*(*Mod1)->getContentHash()));
+
+  auto Mod2 = Loader.parseModule(BlockWasm);
+  ASSERT_TRUE(Mod2);
+  ASSERT_TRUE(Validator.validate(**Mod2));
+  const auto &Code = *(*Mod2)->getCodeSection()->getContent()[0];
+  EXPECT_EQ(Code.getMaxStackHeight(), 1U);
+  const auto &Block = *static_cast<const SSVM::AST::BlockControlInstruction *>(
+      Code.getInstrs()[0].get());
+  EXPECT_TRUE(Block.isArityResolved());
+  EXPECT_EQ(Block.getBlockParamNum(), 0U);
+  EXPECT_EQ(Block.getBlockResultNum(), 1U);
+  Cache.clear();
+}
+
+TEST(ValidationCacheTest, EnabledByDefault) {
+  /// 3. Test the cache is used by default and can be disabled.
+  auto &Cache = ValidationCache::getInstance();
+  Cache.clear();
+  SSVM::Loader::Loader Loader;
+  Loader.setModuleHashing(true);
+  SSVM::Validator::Validator Validator;
+  EXPECT_TRUE(Validator.isCaching());
+
+  auto Mod1 = Loader.parseModule(BlockWasm);
+  ASSERT_TRUE(Mod1);
+  ASSERT_TRUE(Validator.validate(**Mod1));
+  EXPECT_TRUE(Cache.find(*(*Mod1)->getContentHash()));
+
+  Cache.clear();
+  Validator.setCaching(false);
+  auto Mod2 = Loader.parseModule(BlockWasm);
+  ASSERT_TRUE(Mod2);
+  ASSERT_TRUE(Validator.validate(**Mod2));
+  EXPECT_FALSE(Cache.find(*(*Mod2)->getContentHash()));
+}
+
+TEST(ValidationCacheTest, HashFromFile) {
+  /// 4. Test the module loaded from file carries the digest of the binary.
+  {
+    std::ofstream Fout("cacheTestBlock.wasm", std::ios::binary);
+    Fout.write(reinterpret_cast<const char *>(BlockWasm.data()),
+               BlockWasm.size());
+  }
+  SSVM::Loader::Loader Loader;
+  Loader.setModuleHashing(true);
+  auto Mod = Loader.parseModule(std::string_view("cacheTestBlock.wasm"));
+  ASSERT_TRUE(Mod);
+  ASSERT_TRUE((*Mod)->getContentHash());
+  EXPECT_EQ(*(*Mod)->getContentHash(), SSVM::Support::SHA256::hash(BlockWasm));
+  std::remove("cacheTestBlock.wasm");
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
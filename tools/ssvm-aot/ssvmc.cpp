@@ -4,6 +4,11 @@
 #include "po/argument_parser.h"
 #include "support/filesystem.h"
 #include "validator/validator.h"
+#include "vm/costtable.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
 
 int main(int Argc, const char *Argv[]) {
@@ -21,17 +26,140 @@ int main(int Argc, const char *Argv[]) {
   PO::Option<PO::Toggle> DumpIR(
       PO::Description("Dump LLVM IR to `wasm.ll` and `wasm-opt.ll`."));
 
+  PO::Option<int> Jobs(
+      PO::Description("Number of threads for optimization and code generation. "
+                      "Functions are split into at most N partitions."s),
+      PO::MetaVar("N"s), PO::DefaultValue<int>(1));
+
+  PO::Option<std::string> OptLevel(
+      PO::Description("Optimization level, one of 0, 1, 2, 3, s and z."s),
+      PO::MetaVar("LEVEL"s), PO::DefaultValue<std::string>("3"));
+
+  PO::Option<std::string> TargetCPU(
+      PO::Description("Target CPU name. \"native\" for the host CPU and its "
+                      "features."s),
+      PO::MetaVar("CPU"s), PO::DefaultValue<std::string>("native"));
+
+  PO::Option<std::string> TargetFeatures(
+      PO::Description("Additional target features, such as \"+avx2,-bmi2\"."s),
+      PO::MetaVar("FEATURES"s), PO::DefaultValue<std::string>(""));
+
+  PO::List<std::string> TargetVariants(
+      PO::Description(
+          "Code variants in one output. Each variant can specified as "
+          "--target-variant `CPU[:FEATURES]`, and the supported one enabling "
+          "the most features on the running CPU is loaded. "
+          "Overrides --target-cpu and --target-features."s),
+      PO::MetaVar("VARIANTS"s));
+
+  PO::Option<std::string> CacheDir(
+      PO::Description("Directory to cache the compiled functions. Unchanged "
+                      "functions are reused from the cache in later builds."s),
+      PO::MetaVar("DIR"s), PO::DefaultValue<std::string>(""));
+
+  PO::Option<PO::Toggle> GasMetering(PO::Description(
+      "Enable gas metering with the default cost table. The compiled code "
+      "traps when the cost limit of the runtime is exceeded."));
+
+  PO::Option<PO::Toggle> Interruptible(PO::Description(
+      "Check the epoch deadline of the runtime at loop headers, so that "
+      "long-running executions can be interrupted."));
+
+  PO::Option<std::string> ProfileIn(
+      PO::Description("Execution profile recorded by `ssvm --profile-out`, "
+                      "for profile guided optimizations."s),
+      PO::MetaVar("PROFILE"s), PO::DefaultValue<std::string>(""));
+
+  PO::Option<std::string> StaticName(
+      PO::Description("Emit a static archive for linking into the host binary "
+                      "instead of a shared library, with the registration "
+                      "table `ssvm_module_NAME`."s),
+      PO::MetaVar("NAME"s), PO::DefaultValue<std::string>(""));
+
+  PO::Option<PO::Toggle> TimeReport(PO::Description(
+      "Print the time of loading, validation, IR generation, optimization "
+      "passes, code generation and linking to stderr."));
+
+  PO::Option<PO::Toggle> Stats(
+      PO::Description("Print the IR instruction counts before and after "
+                      "optimization and the code size of each function to "
+                      "stderr."));
+
+  PO::Option<std::string> BoundsCheck(
+      PO::Description("Bounds check strategy of memory accesses, one of "
+                      "guard, explicit and mask. \"guard\" relies on 8 GiB "
+                      "of reserved address space per memory. \"mask\" wraps "
+                      "the addresses of fixed power of two sized memories "
+                      "instead of trapping, and is only for trusted modules."s),
+      PO::MetaVar("STRATEGY"s), PO::DefaultValue<std::string>("guard"));
+
   if (!PO::ArgumentParser()
            .add_option(WasmName)
            .add_option(SoName)
            .add_option("dump", DumpIR)
+           .add_option("jobs", Jobs)
+           .add_option("optimize", OptLevel)
+           .add_option("target-cpu", TargetCPU)
+           .add_option("target-features", TargetFeatures)
+           .add_option("target-variant", TargetVariants)
+           .add_option("cache-dir", CacheDir)
+           .add_option("gas", GasMetering)
+           .add_option("interruptible", Interruptible)
+           .add_option("profile", ProfileIn)
+           .add_option("static-name", StaticName)
+           .add_option("time-report", TimeReport)
+           .add_option("stats", Stats)
+           .add_option("bounds-check", BoundsCheck)
            .parse(Argc, Argv)) {
     return 0;
   }
 
+  using OptimizationLevel = SSVM::AOT::Compiler::OptimizationLevel;
+  OptimizationLevel Level;
+  if (OptLevel.value() == "0") {
+    Level = OptimizationLevel::O0;
+  } else if (OptLevel.value() == "1") {
+    Level = OptimizationLevel::O1;
+  } else if (OptLevel.value() == "2") {
+    Level = OptimizationLevel::O2;
+  } else if (OptLevel.value() == "3") {
+    Level = OptimizationLevel::O3;
+  } else if (OptLevel.value() == "s") {
+    Level = OptimizationLevel::Os;
+  } else if (OptLevel.value() == "z") {
+    Level = OptimizationLevel::Oz;
+  } else {
+    std::cout << "Invalid optimization level: " << OptLevel.value()
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  SSVM::BoundsCheck Bounds;
+  if (BoundsCheck.value() == "guard") {
+    Bounds = SSVM::BoundsCheck::GuardPage;
+  } else if (BoundsCheck.value() == "explicit") {
+    Bounds = SSVM::BoundsCheck::Explicit;
+  } else if (BoundsCheck.value() == "mask") {
+    Bounds = SSVM::BoundsCheck::Mask;
+  } else {
+    std::cout << "Invalid bounds check strategy: " << BoundsCheck.value()
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  if (!std::all_of(
+          StaticName.value().begin(), StaticName.value().end(),
+          [](unsigned char C) { return std::isalnum(C) || C == '_'; })) {
+    std::cout << "Invalid static module name: " << StaticName.value()
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
   std::string InputPath = std::filesystem::absolute(WasmName.value()).string();
   std::string OutputPath = std::filesystem::absolute(SoName.value()).string();
   SSVM::Loader::Loader Loader;
+  using Clock = std::chrono::steady_clock;
+  const auto LoadStart = Clock::now();
 
   std::vector<SSVM::Byte> Data;
   if (auto Res = Loader.loadFile(InputPath)) {
@@ -51,6 +179,7 @@ int main(int Argc, const char *Argv[]) {
     return EXIT_FAILURE;
   }
 
+  const auto ValidateStart = Clock::now();
   {
     SSVM::Validator::Validator ValidatorEngine;
     if (auto Res = ValidatorEngine.validate(*Module); !Res) {
@@ -59,12 +188,70 @@ int main(int Argc, const char *Argv[]) {
       return EXIT_FAILURE;
     }
   }
+  if (TimeReport.value()) {
+    const auto ToMs = [](Clock::duration Duration) {
+      return std::chrono::duration<double, std::milli>(Duration).count();
+    };
+    std::fprintf(stderr, "===-- Load time report --===\n");
+    std::fprintf(stderr, "   Time (ms)  Phase\n");
+    std::fprintf(stderr, "%12.3f  loading\n", ToMs(ValidateStart - LoadStart));
+    std::fprintf(stderr, "%12.3f  validation\n",
+                 ToMs(Clock::now() - ValidateStart));
+  }
+
+  SSVM::Support::Profile Profile;
+  if (!ProfileIn.value().empty()) {
+    if (auto Res = Profile.load(ProfileIn.value()); !Res) {
+      const auto Err = static_cast<uint32_t>(Res.error());
+      std::cout << "Load profile failed. Error code:" << Err << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
 
   {
     SSVM::AOT::Compiler Compiler;
     if (DumpIR.value()) {
       Compiler.setDumpIR();
     }
+    Compiler.setOptimizationLevel(Level);
+    if (TargetCPU.value() != "native") {
+      Compiler.setTargetCPU(TargetCPU.value());
+    }
+    Compiler.setTargetFeatures(TargetFeatures.value());
+    for (const auto &Variant : TargetVariants.value()) {
+      const auto Pos = Variant.find(':');
+      const std::string CPU = Variant.substr(0, Pos);
+      const std::string Features =
+          Pos == std::string::npos ? ""s : Variant.substr(Pos + 1);
+      Compiler.addTargetVariant(CPU == "native" ? ""s : CPU, Features);
+    }
+    if (!CacheDir.value().empty()) {
+      Compiler.setCacheDir(CacheDir.value());
+    }
+    if (Jobs.value() > 1) {
+      Compiler.setJobs(Jobs.value());
+    }
+    if (GasMetering.value()) {
+      SSVM::VM::CostTable CostTab;
+      Compiler.setCostTable(
+          CostTab.getCostTable(SSVM::VM::Configure::VMType::Wasm));
+    }
+    if (Interruptible.value()) {
+      Compiler.setInterruptible();
+    }
+    if (!ProfileIn.value().empty()) {
+      Compiler.setProfile(&Profile);
+    }
+    if (!StaticName.value().empty()) {
+      Compiler.setStaticName(StaticName.value());
+    }
+    if (TimeReport.value()) {
+      Compiler.setTimeReport();
+    }
+    if (Stats.value()) {
+      Compiler.setStats();
+    }
+    Compiler.setBoundsCheck(Bounds);
     if (auto Res = Compiler.compile(Data, *Module, OutputPath); !Res) {
       const auto Err = static_cast<uint32_t>(Res.error());
       std::cout << "Compile failed. Error code:" << Err << std::endl;
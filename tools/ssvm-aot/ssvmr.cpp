@@ -36,10 +36,15 @@ int main(int Argc, const char *Argv[]) {
           "Environ variables. Each variables can specified as --env `NAME=VALUE`."s),
       PO::MetaVar("ENVS"s));
 
+  PO::Option<PO::Toggle> NoGuardPages(PO::Description(
+      "Check memory bounds explicitly instead of reserving 8 GiB of address "
+      "space per memory, for hosts with limited address space."s));
+
   if (!PO::ArgumentParser()
            .add_option(SoName)
            .add_option(Args)
            .add_option("reactor", Reactor)
+           .add_option("no-guard-pages", NoGuardPages)
            .add_option("dir", Dir)
            .add_option("env", Env)
            .parse(Argc, Argv)) {
@@ -50,6 +55,9 @@ int main(int Argc, const char *Argv[]) {
   SSVM::VM::Configure Conf;
   Conf.addVMType(SSVM::VM::Configure::VMType::Wasi);
   Conf.addVMType(SSVM::VM::Configure::VMType::SSVM_Process);
+  if (NoGuardPages.value()) {
+    Conf.setBoundsCheck(SSVM::BoundsCheck::Explicit);
+  }
   SSVM::VM::VM VM(Conf);
 
   SSVM::Host::WasiModule *WasiMod = dynamic_cast<SSVM::Host::WasiModule *>(
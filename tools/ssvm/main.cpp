@@ -3,6 +3,7 @@
 #include "host/wasi/wasimodule.h"
 #include "po/argument_parser.h"
 #include "support/filesystem.h"
+#include "support/profile.h"
 #include "vm/configure.h"
 #include "vm/vm.h"
 
@@ -37,12 +38,28 @@ int main(int Argc, const char *Argv[]) {
           "Environ variables. Each variables can specified as --env `NAME=VALUE`."s),
       PO::MetaVar("ENVS"s));
 
+  PO::Option<std::string> ProfileOut(
+      PO::Description("Record function entries, branches and indirect call "
+                      "targets into the file, for `ssvmc --profile`."s),
+      PO::MetaVar("PROFILE"s), PO::DefaultValue<std::string>(""));
+
+  PO::Option<PO::Toggle> NoGuardPages(PO::Description(
+      "Check memory bounds explicitly instead of reserving 8 GiB of address "
+      "space per memory, for hosts with limited address space."s));
+
+  PO::Option<PO::Toggle> MemoryFastPath(PO::Description(
+      "Access memories with guard pages without bounds checks, and trap on "
+      "the faults of guard pages."s));
+
   if (!PO::ArgumentParser()
            .add_option(WasmName)
            .add_option(Args)
            .add_option("reactor", Reactor)
            .add_option("dir", Dir)
            .add_option("env", Env)
+           .add_option("profile-out", ProfileOut)
+           .add_option("no-guard-pages", NoGuardPages)
+           .add_option("memory-fast-path", MemoryFastPath)
            .parse(Argc, Argv)) {
     return 0;
   }
@@ -51,8 +68,28 @@ int main(int Argc, const char *Argv[]) {
   SSVM::VM::Configure Conf;
   Conf.addVMType(SSVM::VM::Configure::VMType::Wasi);
   Conf.addVMType(SSVM::VM::Configure::VMType::SSVM_Process);
+  if (NoGuardPages.value()) {
+    Conf.setBoundsCheck(SSVM::BoundsCheck::Explicit);
+  }
+  Conf.setMemoryFastPath(MemoryFastPath.value());
   SSVM::VM::VM VM(Conf);
 
+  SSVM::Support::Profile Profile;
+  if (!ProfileOut.value().empty()) {
+    VM.setProfile(&Profile);
+  }
+  /// Write the profile after the execution, whatever the execution result is.
+  auto Finish = [&](int ExitCode) {
+    if (!ProfileOut.value().empty()) {
+      if (auto Res = Profile.save(ProfileOut.value()); !Res) {
+        std::cerr << "Failed to write the profile into " << ProfileOut.value()
+                  << ".\n";
+        return EXIT_FAILURE;
+      }
+    }
+    return ExitCode;
+  };
+
   SSVM::Host::WasiModule *WasiMod = dynamic_cast<SSVM::Host::WasiModule *>(
       VM.getImportModule(SSVM::VM::Configure::VMType::Wasi));
 
@@ -62,9 +99,9 @@ int main(int Argc, const char *Argv[]) {
   if (!Reactor.value()) {
     // command mode
     if (auto Result = VM.runWasmFile(InputPath, "_start")) {
-      return WasiMod->getEnv().getExitCode();
+      return Finish(WasiMod->getEnv().getExitCode());
     } else {
-      return EXIT_FAILURE;
+      return Finish(EXIT_FAILURE);
     }
   } else {
     // reactor mode
@@ -100,7 +137,7 @@ int main(int Argc, const char *Argv[]) {
 
     if (HasInit) {
       if (auto Result = VM.execute(InitFunc); !Result) {
-        return EXIT_FAILURE;
+        return Finish(EXIT_FAILURE);
       }
     }
 
@@ -160,9 +197,9 @@ int main(int Argc, const char *Argv[]) {
           break;
         }
       }
-      return EXIT_SUCCESS;
+      return Finish(EXIT_SUCCESS);
     } else {
-      return EXIT_FAILURE;
+      return Finish(EXIT_FAILURE);
     }
   }
 }